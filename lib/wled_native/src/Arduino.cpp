@@ -0,0 +1,140 @@
+/*
+ * Global objects and non-inline functions of the host (native) Arduino shims.
+ */
+#include <Arduino.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include <WiFi.h>
+#include <ETH.h>
+#include <ESPmDNS.h>
+#include <LittleFS.h>
+#include <Wire.h>
+#include <SPI.h>
+
+EspClass       ESP;
+HardwareSerial Serial;
+HardwareSerial Serial1;
+HardwareSerial Serial2;
+WiFiClass      WiFi;
+ETHClass       ETH;
+MDNSResponder  MDNS;
+fs::FS         LittleFS;
+TwoWire        Wire;
+SPIClass       SPI;
+const IPAddress INADDR_NONE(0u);
+
+static const auto bootTime = std::chrono::steady_clock::now();
+static std::atomic<unsigned long> clockOffset(0); // ms added by nativeAdvanceClock()
+static std::atomic<long>          simulatedMs(-1); // millis() once nativeAdvanceClock() was used (clock only moves when advanced)
+
+unsigned long millis() {
+  long sim = simulatedMs;
+  if (sim >= 0) return sim;
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - bootTime).count() + clockOffset;
+}
+
+unsigned long micros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime).count() + clockOffset * 1000UL;
+}
+
+uint64_t micros64() {
+  long sim = simulatedMs;
+  if (sim >= 0) return uint64_t(sim) * 1000;
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime).count() + clockOffset * 1000ULL;
+}
+
+// switches millis() to a simulated clock so that rendering is reproducible (micros() keeps running for time measurements)
+void nativeAdvanceClock(unsigned long ms) {
+  if (simulatedMs < 0) simulatedMs = millis();
+  simulatedMs += ms;
+  clockOffset += ms;
+}
+
+void nativeSetClock(unsigned long ms) {
+  simulatedMs = ms;
+}
+
+void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+static std::atomic<uint32_t> heapAllocs(0), heapFrees(0);
+static std::atomic<uint64_t> heapAllocated(0);
+static std::atomic<int64_t>  heapInUse(0);
+
+NativeHeapStats nativeHeapStats() {
+  NativeHeapStats s;
+  int64_t inUse = heapInUse;
+  s.allocs    = heapAllocs;
+  s.frees     = heapFrees;
+  s.allocated = heapAllocated;
+  s.inUse     = inUse > 0 ? inUse : 0;
+  return s;
+}
+
+#ifdef __GLIBC__
+// glibc allows the allocator entry points to be replaced by the executable, count calls and forward to the real ones
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t align, size_t size);
+void  __libc_free(void *ptr);
+
+static inline void *countAlloc(void *ptr) {
+  if (ptr) {
+    size_t len = malloc_usable_size(ptr);
+    heapAllocs++;
+    heapAllocated += len;
+    heapInUse += len;
+  }
+  return ptr;
+}
+
+void *malloc(size_t size)              { return countAlloc(__libc_malloc(size)); }
+void *calloc(size_t n, size_t size)    { return countAlloc(__libc_calloc(n, size)); }
+void *memalign(size_t a, size_t size)  { return countAlloc(__libc_memalign(a, size)); }
+void *aligned_alloc(size_t a, size_t size) { return countAlloc(__libc_memalign(a, size)); }
+int posix_memalign(void **ptr, size_t a, size_t size) {
+  *ptr = countAlloc(__libc_memalign(a, size));
+  return *ptr ? 0 : ENOMEM;
+}
+void *realloc(void *ptr, size_t size) {
+  size_t old = ptr ? malloc_usable_size(ptr) : 0;
+  void *p = __libc_realloc(ptr, size);
+  if (p || size == 0) heapInUse -= old; // on failure the old block stays allocated
+  return countAlloc(p);
+}
+void free(void *ptr) {
+  if (!ptr) return;
+  heapFrees++;
+  heapInUse -= malloc_usable_size(ptr);
+  __libc_free(ptr);
+}
+}
+#endif
+
+#ifdef WLED_NATIVE_STRLCPY
+size_t strlcpy(char *dst, const char *src, size_t size) {
+  size_t len = strlen(src);
+  if (size) {
+    size_t n = len < size ? len : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = 0;
+  }
+  return len;
+}
+
+size_t strlcat(char *dst, const char *src, size_t size) {
+  size_t dlen = strnlen(dst, size);
+  return dlen == size ? size + strlen(src) : dlen + strlcpy(dst + dlen, src, size - dlen);
+}
+#endif
@@ -0,0 +1,226 @@
+#pragma once
+/*
+ * Minimal Arduino core for building WLED on a host (Linux/macOS) with the "native" PlatformIO environment.
+ * The build pretends to be an ESP32 (ARDUINO_ARCH_ESP32) so only one set of platform APIs needs shimming.
+ * Time is real (steady clock), GPIO/LEDC/FreeRTOS calls are no-ops, heap is the host heap.
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+#include <type_traits>
+#include <string>
+#include <strings.h>
+#include <arpa/inet.h>  // htonl() & co.
+
+// GNU dialects predefine these, WLED uses them as identifiers
+#undef unix
+#undef linux
+// INADDR_NONE is an IPAddress in Arduino
+#undef INADDR_NONE
+
+typedef uint8_t  byte;
+typedef bool     boolean;
+typedef uint16_t word;
+
+using std::abs;
+// mixed argument types are accepted like on the Arduino cores
+template<class T, class U> constexpr typename std::common_type<T,U>::type min(const T &a, const U &b) { return b < a ? b : a; }
+template<class T, class U> constexpr typename std::common_type<T,U>::type max(const T &a, const U &b) { return a < b ? b : a; }
+
+// flash/IRAM attributes have no meaning on a host
+#define PROGMEM
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+#define PGM_P                 const char *
+#define PSTR(x)               (x)
+class __FlashStringHelper;
+#define F(x)                  (reinterpret_cast<const __FlashStringHelper*>(x))
+#define FPSTR(x)              (reinterpret_cast<const __FlashStringHelper*>(x))
+#define pgm_read_byte(a)      (*(const uint8_t*)(a))
+#define pgm_read_byte_near(a) (*(const uint8_t*)(a))
+#define pgm_read_word(a)      (*(const uint16_t*)(a))
+#define pgm_read_dword(a)     (*(const uint32_t*)(a))
+#define pgm_read_float(a)     (*(const float*)(a))
+#define pgm_read_ptr(a)       (*(void* const*)(a))
+#define memcpy_P    memcpy
+#define memcmp_P    memcmp
+#define strcpy_P    strcpy
+#define strncpy_P   strncpy
+#define strcat_P    strcat
+#define strlen_P    strlen
+#define strcmp_P    strcmp
+#define strncmp_P   strncmp
+#define strcasecmp_P strcasecmp
+#define strstr_P    strstr
+#define sprintf_P   sprintf
+#define snprintf_P  snprintf
+#define vsnprintf_P vsnprintf
+
+#define HIGH 1
+#define LOW  0
+#define INPUT          0x01
+#define OUTPUT         0x03
+#define INPUT_PULLUP   0x05
+#define INPUT_PULLDOWN 0x09
+
+#define PI         3.1415926535897932384626433832795
+#define HALF_PI    1.5707963267948966192313216916398
+#define TWO_PI     6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+#define sq(x)                   ((x)*(x))
+#define radians(deg)            ((deg)*DEG_TO_RAD)
+#define degrees(rad)            ((rad)*RAD_TO_DEG)
+#define lowByte(w)              ((uint8_t) ((w) & 0xff))
+#define highByte(w)             ((uint8_t) ((w) >> 8))
+#define bitRead(value, bit)     (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit)      ((value) |= (1UL << (bit)))
+#define bitClear(value, bit)    ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  if (in_max == in_min) return out_min;
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+inline uint16_t makeWord(uint16_t w)          { return w; }
+inline uint16_t makeWord(uint8_t h, uint8_t l) { return (h << 8) | l; }
+#define word(...) makeWord(__VA_ARGS__)
+
+// time (monotonic, starts at 0 when the program starts)
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+inline void yield() {}
+inline int64_t esp_timer_get_time() { return micros(); }
+// simulator only: move millis()/micros() forward without waiting, millis() stays simulated from then on (deterministic frame timing)
+void nativeAdvanceClock(unsigned long ms);
+void nativeSetClock(unsigned long ms); // simulator only: set simulated millis() (replay from the same point in time)
+uint64_t micros64(); // 64 bit µs clock (as on ESP8266), follows the simulated clock while millis() is simulated
+
+// simulator only: heap accounting of malloc()/realloc()/free() (glibc hosts, zero elsewhere)
+struct NativeHeapStats {
+  uint32_t allocs;    // number of malloc/calloc/realloc calls that returned memory
+  uint32_t frees;     // number of free() calls with a non null pointer
+  uint64_t allocated; // total bytes handed out
+  size_t   inUse;     // bytes currently allocated
+};
+NativeHeapStats nativeHeapStats();
+
+// default ESP32 (devkit) bus pins, used for the usermod pin defaults
+#define SDA  21
+#define SCL  22
+#define SCK  18
+#define MISO 19
+#define MOSI 23
+#define SS    5
+
+// GPIO, ADC & LEDC do nothing
+inline void pinMode(uint8_t, uint8_t)         {}
+inline void digitalWrite(uint8_t, uint8_t)    {}
+inline int  digitalRead(uint8_t)              { return LOW; }
+inline int  analogRead(uint8_t)               { return 0; }
+inline void analogWrite(uint8_t, int)         {}
+inline int  digitalPinToAnalogChannel(uint8_t) { return -1; }
+inline uint16_t touchRead(uint8_t)            { return 0; }
+inline bool digitalPinIsValid(uint8_t pin)     { return pin < 40; }
+inline bool digitalPinCanOutput(uint8_t pin)   { return pin < 34; }
+inline double ledcSetup(uint8_t, double freq, uint8_t) { return freq; }
+inline void ledcAttachPin(uint8_t, uint8_t)   {}
+inline void ledcDetachPin(uint8_t)            {}
+inline void ledcWrite(uint8_t, uint32_t)      {}
+
+// random numbers
+inline void     randomSeed(unsigned long seed) { srand(seed); }
+inline long     random(long howbig)            { return howbig > 0 ? rand() % howbig : 0; }
+inline long     random(long howsmall, long howbig) { return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall); }
+inline uint32_t esp_random()                   { return ((uint32_t)rand() << 16) ^ (uint32_t)rand(); }
+
+// stdlib_noniso
+inline char *itoa(int v, char *buf, int base)  { if (base == 10) sprintf(buf, "%d", v); else if (base == 16) sprintf(buf, "%x", v); else sprintf(buf, "%o", v); return buf; }
+inline char *utoa(unsigned v, char *buf, int base) { if (base == 10) sprintf(buf, "%u", v); else if (base == 16) sprintf(buf, "%x", v); else sprintf(buf, "%o", v); return buf; }
+inline char *ltoa(long v, char *buf, int base) { if (base == 10) sprintf(buf, "%ld", v); else sprintf(buf, "%lx", v); return buf; }
+inline char *dtostrf(double v, signed char width, unsigned char prec, char *buf) { sprintf(buf, "%*.*f", width, prec, v); return buf; }
+
+#define ESP_OK   0
+#define ESP_FAIL -1
+typedef int esp_err_t;
+
+#include "WString.h"
+#include "Print.h"
+#include "IPAddress.h"
+#include "HardwareSerial.h"
+
+// ESP class: host heap is reported as "plenty"
+struct EspClass {
+  uint32_t getFreeHeap()          { return 256*1024; }
+  uint32_t getMinFreeHeap()       { return 256*1024; }
+  uint32_t getMaxAllocHeap()      { return 128*1024; }
+  uint32_t getHeapSize()          { return 320*1024; }
+  uint32_t getFreePsram()         { return 0; }
+  uint32_t getPsramSize()         { return 0; }
+  uint32_t getFlashChipSize()     { return 4*1024*1024; }
+  uint32_t getFlashChipSpeed()    { return 80000000; }
+  uint32_t getSketchSize()        { return 0; }
+  uint32_t getFreeSketchSpace()   { return 0; }
+  uint32_t getCpuFreqMHz()        { return 240; }
+  uint32_t getCycleCount()        { return micros() * 240; }
+  uint8_t  getChipRevision()      { return 0; }
+  uint8_t  getChipCores()         { return 1; }
+  const char *getChipModel()      { return "native"; }
+  const char *getSdkVersion()     { return "native"; }
+  uint64_t getEfuseMac()          { return 0x0000DEADBEEFULL; }
+  void     restart()              { exit(0); }
+};
+extern EspClass ESP;
+
+// FreeRTOS: single threaded host, everything succeeds immediately
+typedef void*    TaskHandle_t;
+typedef void*    SemaphoreHandle_t;
+typedef void*    QueueHandle_t;
+typedef int      BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void*);
+#define pdTRUE             1
+#define pdFALSE            0
+#define pdPASS             1
+#define portMAX_DELAY      0xFFFFFFFF
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(x)   (x)
+#define tskNO_AFFINITY     0x7FFFFFFF
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char*, uint32_t, void*, UBaseType_t, TaskHandle_t*, BaseType_t) { return pdFALSE; }
+inline void       vTaskDelete(TaskHandle_t)        {}
+inline void       vTaskDelay(TickType_t t)         { delay(t); }
+inline BaseType_t xPortGetCoreID()                 { return 0; }
+inline TickType_t xTaskGetTickCount()              { return millis(); }
+inline SemaphoreHandle_t xSemaphoreCreateMutex()   { return (SemaphoreHandle_t)1; }
+inline SemaphoreHandle_t xSemaphoreCreateBinary()  { return (SemaphoreHandle_t)1; }
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t) { return pdTRUE; }
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t) { return pdTRUE; }
+inline void       vSemaphoreDelete(SemaphoreHandle_t) {}
+
+// memory
+#define MALLOC_CAP_8BIT     (1<<2)
+#define MALLOC_CAP_SPIRAM   (1<<10)
+#define MALLOC_CAP_INTERNAL (1<<11)
+inline void  *heap_caps_malloc(size_t size, uint32_t) { return malloc(size); }
+inline size_t heap_caps_get_free_size(uint32_t)       { return 256*1024; }
+inline bool   psramFound()                            { return false; }
+inline void  *ps_malloc(size_t size)                  { return malloc(size); }
+
+// BSD string functions (only missing from older glibc)
+#if !defined(__APPLE__) && defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38))
+size_t strlcpy(char *dst, const char *src, size_t size);
+size_t strlcat(char *dst, const char *src, size_t size);
+#define WLED_NATIVE_STRLCPY
+#endif
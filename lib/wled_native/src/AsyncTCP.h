@@ -0,0 +1,9 @@
+#pragma once
+#include <Arduino.h>
+
+class AsyncClient {
+ public:
+  IPAddress remoteIP() const { return IPAddress(); }
+  bool      connected() const { return false; }
+  void      close(bool = false) {}
+};
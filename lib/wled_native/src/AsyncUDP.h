@@ -0,0 +1,32 @@
+#pragma once
+// AsyncUDP shim: listening succeeds but no packets are ever delivered, sending is dropped
+#include <Arduino.h>
+#include <functional>
+
+class AsyncUDPPacket : public Stream {
+ public:
+  uint8_t  *data()        { return nullptr; }
+  size_t    length()      { return 0; }
+  IPAddress remoteIP()    { return IPAddress(); }
+  uint16_t  remotePort()  { return 0; }
+  uint16_t  localPort()   { return 0; }
+  IPAddress localIP()     { return IPAddress(); }
+  bool      isMulticast() { return false; }
+  bool      isBroadcast() { return false; }
+  using Print::write;
+  size_t write(uint8_t) override { return 0; }
+};
+typedef std::function<void(AsyncUDPPacket& packet)> AuPacketHandlerFunction;
+
+class AsyncUDP : public Print {
+  AuPacketHandlerFunction _handler;
+ public:
+  bool   listen(uint16_t)                                   { return true; }
+  bool   listenMulticast(const IPAddress&, uint16_t, uint8_t = 1) { return true; }
+  void   onPacket(AuPacketHandlerFunction cb)               { _handler = cb; }
+  void   close()                                            {}
+  size_t writeTo(const uint8_t*, size_t len, const IPAddress&, uint16_t) { return len; }
+  size_t broadcastTo(uint8_t*, size_t len, uint16_t)        { return len; }
+  using Print::write;
+  size_t write(uint8_t) override                            { return 0; }
+};
@@ -0,0 +1,182 @@
+#pragma once
+/*
+ * No-op ESPAsyncWebServer for the host build.
+ * Handlers can be registered but requests never arrive; the JSON API is driven in-process
+ * (deserializeState()/serializeState()) instead of over HTTP.
+ */
+#include <Arduino.h>
+#include <AsyncTCP.h>
+#include <LittleFS.h>
+#include <functional>
+
+typedef enum {
+  HTTP_GET = 0b1, HTTP_POST = 0b10, HTTP_DELETE = 0b100, HTTP_PUT = 0b1000,
+  HTTP_PATCH = 0b10000, HTTP_HEAD = 0b100000, HTTP_OPTIONS = 0b1000000, HTTP_ANY = 0b1111111
+} WebRequestMethod;
+typedef uint8_t WebRequestMethodComposite;
+
+namespace wled_native { inline const String &emptyString() { static const String s; return s; } }
+
+class AsyncWebParameter {
+ public:
+  const String &name() const  { return wled_native::emptyString(); }
+  const String &value() const { return wled_native::emptyString(); }
+  bool   isPost() const       { return false; }
+  bool   isFile() const       { return false; }
+  size_t size() const         { return 0; }
+};
+
+class AsyncWebHeader {
+ public:
+  const String &name() const  { return wled_native::emptyString(); }
+  const String &value() const { return wled_native::emptyString(); }
+};
+
+class AsyncWebServerResponse {
+ protected:
+  int    _code = 0;
+  String _contentType;
+  size_t _contentLength = 0;
+  size_t _sentLength = 0;
+ public:
+  virtual ~AsyncWebServerResponse() {}
+  void addHeader(const String&, const String&) {}
+  void setCode(int code)                      { _code = code; }
+  void setContentLength(size_t len)           { _contentLength = len; }
+  void setContentType(const String &type)     { _contentType = type; }
+  virtual size_t _fillBuffer(uint8_t*, size_t) { return 0; }
+  virtual bool   _sourceValid() const         { return false; }
+};
+class AsyncAbstractResponse : public AsyncWebServerResponse {};
+class AsyncResponseStream : public AsyncWebServerResponse, public Print {
+ public:
+  using Print::write;
+  size_t write(uint8_t) override { return 1; }
+};
+
+class AsyncWebServerRequest {
+ public:
+  void *_tempObject = nullptr;
+  File  _tempFile;
+  WebRequestMethodComposite method() const { return HTTP_GET; }
+  const String &url() const                { return wled_native::emptyString(); }
+  const String &contentType() const        { return wled_native::emptyString(); }
+  const String &host() const               { return wled_native::emptyString(); }
+  IPAddress client_ip()                    { return IPAddress(127,0,0,1); }
+  AsyncClient *client()                    { return nullptr; }
+  void addInterestingHeader(const String&) {}
+  void onDisconnect(std::function<void()>) {}
+  bool isExpectedRequestedConnType(int, int = 0, int = 0) { return true; }
+
+  void send(int, const String& = String(), const String& = String()) {}
+  void send(AsyncWebServerResponse *r)     { delete r; }
+  template<class FS> void send(FS&, const String&, const String& = String(), bool = false) {}
+  template<typename... A> void send_P(int, const String&, A...) {}
+  void redirect(const String&)             {}
+  AsyncWebServerResponse *beginResponse(int code, const String& = String(), const String& = String()) {
+    auto r = new AsyncWebServerResponse(); r->setCode(code); return r;
+  }
+  template<typename... A> AsyncWebServerResponse *beginResponse_P(int code, const String&, A...) {
+    auto r = new AsyncWebServerResponse(); r->setCode(code); return r;
+  }
+  AsyncResponseStream *beginResponseStream(const String&, size_t = 1460) { return new AsyncResponseStream(); }
+
+  bool   hasArg(const char*) const          { return false; }
+  bool   hasArg(const String&) const        { return false; }
+  const String &arg(const String&) const    { return wled_native::emptyString(); }
+  const String &arg(size_t) const           { return wled_native::emptyString(); }
+  const String &argName(size_t) const       { return wled_native::emptyString(); }
+  size_t args() const                       { return 0; }
+  bool   hasParam(const String&, bool = false, bool = false) const { return false; }
+  AsyncWebParameter *getParam(const String&, bool = false, bool = false) const { return nullptr; }
+  AsyncWebParameter *getParam(size_t) const { return nullptr; }
+  size_t params() const                     { return 0; }
+  bool   hasHeader(const String&) const     { return false; }
+  AsyncWebHeader *getHeader(const String&) const { return nullptr; }
+  const String &urlDecode(const String &s) const { return s; }
+};
+
+class AsyncWebHandler {
+ public:
+  virtual ~AsyncWebHandler() {}
+  virtual bool canHandle(AsyncWebServerRequest*) { return false; }
+  virtual void handleRequest(AsyncWebServerRequest*) {}
+  virtual void handleUpload(AsyncWebServerRequest*, const String&, size_t, uint8_t*, size_t, bool) {}
+  virtual void handleBody(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t) {}
+  virtual bool isRequestHandlerTrivial() { return true; }
+};
+
+typedef std::function<void(AsyncWebServerRequest *request)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest *request, const String& filename, size_t index, uint8_t *data, size_t len, bool final)> ArUploadHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)> ArBodyHandlerFunction;
+
+class AsyncWebServer {
+  AsyncWebHandler _handler;
+ public:
+  AsyncWebServer(uint16_t) {}
+  void begin() {}
+  void reset() {}
+  AsyncWebHandler &addHandler(AsyncWebHandler *h) { return *h; }
+  bool removeHandler(AsyncWebHandler*)      { return true; }
+  template<typename... A> AsyncWebHandler &on(const char*, A...) { return _handler; }
+  void onNotFound(ArRequestHandlerFunction) {}
+};
+
+#define ON_STA_FILTER(request) true
+#define ON_AP_FILTER(request)  false
+
+class DefaultHeaders {
+ public:
+  static DefaultHeaders &Instance() { static DefaultHeaders h; return h; }
+  void addHeader(const String&, const String&) {}
+};
+
+// websockets: no clients ever connect
+typedef enum { WS_EVT_CONNECT, WS_EVT_DISCONNECT, WS_EVT_PONG, WS_EVT_ERROR, WS_EVT_DATA } AwsEventType;
+typedef struct { uint8_t message_opcode; uint32_t num; uint8_t final; uint8_t masked; uint8_t opcode; uint64_t len; uint8_t mask[4]; uint64_t index; } AwsFrameInfo;
+#define WS_TEXT   1
+#define WS_BINARY 2
+#define WS_CONNECTED 1
+
+class AsyncWebSocketMessageBuffer {
+  uint8_t *_data; size_t _len;
+ public:
+  AsyncWebSocketMessageBuffer(size_t len) : _data((uint8_t*)calloc(len + 1, 1)), _len(len) {}
+  ~AsyncWebSocketMessageBuffer() { free(_data); }
+  void     lock()   {}
+  void     unlock() {}
+  uint8_t *get()    { return _data; }
+  size_t   length() { return _len; }
+};
+
+class AsyncWebSocketClient {
+ public:
+  uint32_t  id()                { return 0; }
+  IPAddress remoteIP()          { return IPAddress(); }
+  int       status()            { return 0; }
+  bool      queueIsFull()       { return false; }
+  size_t    queueLength()       { return 0; }
+  void      setCloseClientOnQueueFull(bool) {}
+  void      close()             {}
+  template<typename... A> void text(A...)   {}
+  template<typename... A> void binary(A...) {}
+};
+
+class AsyncWebSocket;
+typedef std::function<void(AsyncWebSocket*, AsyncWebSocketClient*, AwsEventType, void*, uint8_t*, size_t)> AwsEventHandler;
+
+class AsyncWebSocket : public AsyncWebHandler {
+ public:
+  AsyncWebSocket(const String&) {}
+  void   onEvent(AwsEventHandler)   {}
+  void   cleanupClients(uint16_t = 8) {}
+  size_t count() const              { return 0; }
+  AsyncWebSocketClient *client(uint32_t) { return nullptr; }
+  bool   availableForWriteAll()     { return true; }
+  void   closeAll(uint16_t = 0)     {}
+  void   _cleanBuffers()            {}
+  AsyncWebSocketMessageBuffer *makeBuffer(size_t len) { return new AsyncWebSocketMessageBuffer(len); }
+  void   textAll(AsyncWebSocketMessageBuffer *b)   { delete b; }
+  void   textAll(const char*)                      {}
+  void   binaryAll(AsyncWebSocketMessageBuffer *b) { delete b; }
+};
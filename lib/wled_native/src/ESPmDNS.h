@@ -0,0 +1,14 @@
+#pragma once
+#include <Arduino.h>
+
+class MDNSResponder {
+ public:
+  bool      begin(const char*)   { return true; }
+  void      end()                {}
+  void      addService(const char*, const char*, uint16_t) {}
+  void      addServiceTxt(const char*, const char*, const char*, const char*) {}
+  int       queryService(const char*, const char*) { return 0; }
+  IPAddress IP(int)              { return IPAddress(); }
+  String    hostname(int)        { return String(); }
+};
+extern MDNSResponder MDNS;
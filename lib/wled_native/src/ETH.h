@@ -0,0 +1,24 @@
+#pragma once
+// no Ethernet on the host (network traffic goes through the host stack)
+#include <Arduino.h>
+
+typedef int eth_phy_type_t;
+typedef int eth_clock_mode_t;
+#define ETH_PHY_LAN8720      0
+#define ETH_PHY_TLK110       1
+#define ETH_PHY_IP101        2
+#define ETH_CLOCK_GPIO0_IN   0
+#define ETH_CLOCK_GPIO0_OUT  1
+#define ETH_CLOCK_GPIO16_OUT 2
+#define ETH_CLOCK_GPIO17_OUT 3
+
+class ETHClass {
+ public:
+  template<typename... A> bool begin(A...) { return false; }
+  bool      config(IPAddress, IPAddress, IPAddress, IPAddress = IPAddress()) { return false; }
+  IPAddress localIP()            { return IPAddress(); }
+  bool      linkUp()             { return false; }
+  String    macAddress()         { return String(); }
+  void      macAddress(uint8_t *m) { memset(m, 0, 6); }
+};
+extern ETHClass ETH;
@@ -0,0 +1,27 @@
+#pragma once
+// Serial writes to stdout, nothing is ever received
+#include <Arduino.h>
+
+class HardwareSerial : public Stream {
+  unsigned long _baud = 0;
+ public:
+  void begin(unsigned long baud, ...)   { _baud = baud; }
+  void end()                            {}
+  operator bool() const                 { return true; }
+  void updateBaudRate(unsigned long b)  { _baud = b; }
+  unsigned long baudRate()              { return _baud; }
+  size_t availableForWrite()            { return 256; }
+  void setRxBufferSize(size_t)          {}
+  using Print::write;
+  size_t write(int n)                   { return write((uint8_t)n); }
+  size_t write(unsigned n)              { return write((uint8_t)n); }
+  size_t write(long n)                  { return write((uint8_t)n); }
+  size_t write(unsigned long n)         { return write((uint8_t)n); }
+  size_t write(uint8_t c) override      { return fwrite(&c, 1, 1, stdout); }
+  size_t write(const uint8_t *buf, size_t len) override { return fwrite(buf, 1, len, stdout); }
+  void flush() override                 { fflush(stdout); }
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
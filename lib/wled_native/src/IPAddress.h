@@ -0,0 +1,30 @@
+#pragma once
+#include <Arduino.h>
+
+class IPAddress : public Printable {
+  union { uint8_t b[4]; uint32_t dw; } _a;
+ public:
+  IPAddress()                                          { _a.dw = 0; }
+  IPAddress(uint8_t o1, uint8_t o2, uint8_t o3, uint8_t o4) { _a.b[0] = o1; _a.b[1] = o2; _a.b[2] = o3; _a.b[3] = o4; }
+  IPAddress(uint32_t a)                                { _a.dw = a; }
+  operator uint32_t() const                            { return _a.dw; }
+  uint8_t  operator[](int i) const                     { return _a.b[i]; }
+  uint8_t &operator[](int i)                           { return _a.b[i]; }
+  bool operator==(const IPAddress &o) const            { return _a.dw == o._a.dw; }
+  bool operator!=(const IPAddress &o) const            { return _a.dw != o._a.dw; }
+  bool isSet() const                                   { return _a.dw != 0; }
+  bool fromString(const char *s) {
+    unsigned o[4];
+    if (sscanf(s, "%u.%u.%u.%u", &o[0], &o[1], &o[2], &o[3]) != 4) return false;
+    for (int i = 0; i < 4; i++) { if (o[i] > 255) return false; _a.b[i] = o[i]; }
+    return true;
+  }
+  String toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _a.b[0], _a.b[1], _a.b[2], _a.b[3]);
+    return String(buf);
+  }
+  size_t printTo(Print &p) const override { return p.print(toString()); }
+};
+
+extern const IPAddress INADDR_NONE;
@@ -0,0 +1,132 @@
+#pragma once
+/*
+ * LittleFS shim backed by a host directory.
+ * The root is taken from the WLED_FS_ROOT environment variable (default "./wled_fs"),
+ * so cfg.json, presets.json, ledmaps etc. can be prepared and inspected with normal tools.
+ */
+#include <Arduino.h>
+#include <memory>
+#include <sys/stat.h>
+#include <dirent.h>
+
+enum SeekMode { SeekSet = SEEK_SET, SeekCur = SEEK_CUR, SeekEnd = SEEK_END };
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+class File : public Stream {
+  struct Impl {
+    FILE *fp = nullptr;
+    DIR  *dir = nullptr;
+    std::string path, hostPath;
+    ~Impl() { if (fp) fclose(fp); if (dir) closedir(dir); }
+  };
+  std::shared_ptr<Impl> _p;
+  friend class FS;
+
+ public:
+  File() {}
+  operator bool() const        { return _p && (_p->fp || _p->dir); }
+  bool   isDirectory()         { return _p && _p->dir; }
+  const char *name() const     { if (!_p) return ""; size_t s = _p->path.rfind('/'); return _p->path.c_str() + (s == std::string::npos ? 0 : s + 1); }
+  const char *path() const     { return _p ? _p->path.c_str() : ""; }
+  void   close()               { _p.reset(); }
+
+  size_t size() const {
+    struct stat st;
+    if (!_p || !_p->fp) return 0;
+    fflush(_p->fp);
+    return fstat(fileno(_p->fp), &st) == 0 ? st.st_size : 0;
+  }
+  size_t position() const               { return _p && _p->fp ? ftell(_p->fp) : 0; }
+  bool   seek(uint32_t pos, SeekMode m = SeekSet) { return _p && _p->fp && fseek(_p->fp, pos, m) == 0; }
+  time_t getLastWrite() {
+    struct stat st;
+    return _p && stat(_p->hostPath.c_str(), &st) == 0 ? st.st_mtime : 0;
+  }
+
+  using Print::write;
+  size_t write(uint8_t c) override                     { return write(&c, 1); }
+  size_t write(const uint8_t *buf, size_t len) override { return _p && _p->fp ? fwrite(buf, 1, len, _p->fp) : 0; }
+  void   flush() override                              { if (_p && _p->fp) fflush(_p->fp); }
+  int    available() override                          { return _p && _p->fp ? (int)(size() - position()) : 0; }
+  int    read() override                               { return _p && _p->fp ? fgetc(_p->fp) : -1; }
+  int    peek() override {
+    if (!_p || !_p->fp) return -1;
+    int c = fgetc(_p->fp);
+    if (c >= 0) ungetc(c, _p->fp);
+    return c;
+  }
+  size_t read(uint8_t *buf, size_t len) { return _p && _p->fp ? fread(buf, 1, len, _p->fp) : 0; }
+
+  File openNextFile(const char *mode = "r");
+  void rewindDirectory() { if (_p && _p->dir) rewinddir(_p->dir); }
+};
+
+class FS {
+  std::string _root;
+  std::string hostPath(const char *path) const { return _root + (path[0] == '/' ? "" : "/") + path; }
+ public:
+  bool begin(bool = false) {
+    const char *r = getenv("WLED_FS_ROOT");
+    _root = r && *r ? r : "./wled_fs";
+    ::mkdir(_root.c_str(), 0755);
+    struct stat st;
+    return stat(_root.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+  }
+  void end() {}
+
+  File open(const char *path, const char *mode = "r", bool = false) {
+    File f;
+    if (_root.empty()) return f;
+    f._p = std::make_shared<File::Impl>();
+    f._p->path = path;
+    f._p->hostPath = hostPath(path);
+    struct stat st;
+    if (stat(f._p->hostPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) f._p->dir = opendir(f._p->hostPath.c_str());
+    else {
+      // Arduino "w" and "a" are always readable too
+      const char *m = mode[0] == 'w' ? "w+" : mode[0] == 'a' ? "a+" : mode;
+      f._p->fp = fopen(f._p->hostPath.c_str(), m);
+    }
+    if (!f) f._p.reset();
+    return f;
+  }
+  File open(const String &path, const char *mode = "r") { return open(path.c_str(), mode); }
+  bool exists(const char *path)   { struct stat st; return !_root.empty() && stat(hostPath(path).c_str(), &st) == 0; }
+  bool exists(const String &path) { return exists(path.c_str()); }
+  bool remove(const char *path)   { return ::remove(hostPath(path).c_str()) == 0; }
+  bool remove(const String &path) { return remove(path.c_str()); }
+  bool rename(const char *from, const char *to) { return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0; }
+  bool mkdir(const char *path)    { return ::mkdir(hostPath(path).c_str(), 0755) == 0; }
+  bool format()                   { return false; } // never wipe a host directory
+  size_t totalBytes()             { return 1024*1024; }
+  size_t usedBytes()              { return 0; }
+};
+
+inline File File::openNextFile(const char *mode) {
+  File f;
+  if (!_p || !_p->dir) return f;
+  while (dirent *e = readdir(_p->dir)) {
+    if (e->d_name[0] == '.') continue;
+    std::string p = _p->path + (_p->path.back() == '/' ? "" : "/") + e->d_name;
+    f._p = std::make_shared<Impl>();
+    f._p->path = p;
+    f._p->hostPath = _p->hostPath + "/" + e->d_name;
+    struct stat st;
+    if (stat(f._p->hostPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) f._p->dir = opendir(f._p->hostPath.c_str());
+    else f._p->fp = fopen(f._p->hostPath.c_str(), mode);
+    if (f) return f;
+  }
+  f._p.reset();
+  return f;
+}
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+extern fs::FS LittleFS;
@@ -0,0 +1,148 @@
+#pragma once
+/*
+ * In-memory NeoPixelBus for the host build.
+ * Every method/feature combination used by bus_wrapper.h maps onto the same template which just keeps
+ * the last written colors, so BusDigital behaves like on hardware minus the wire protocol.
+ */
+#include <Arduino.h>
+#include <vector>
+
+struct RgbwColor;
+struct Rgb48Color;
+struct Rgbw64Color;
+
+struct RgbColor {
+  uint8_t R = 0, G = 0, B = 0;
+  RgbColor() {}
+  RgbColor(uint8_t r, uint8_t g, uint8_t b) : R(r), G(g), B(b) {}
+  RgbColor(uint32_t c) : R(c >> 16), G(c >> 8), B(c) {}  // HtmlColor
+  inline RgbColor(const RgbwColor &c);
+  inline RgbColor(const Rgb48Color &c);
+};
+
+struct RgbwColor {
+  uint8_t R = 0, G = 0, B = 0, W = 0;
+  RgbwColor() {}
+  RgbwColor(uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) : R(r), G(g), B(b), W(w) {}
+  RgbwColor(uint32_t c) : R(c >> 16), G(c >> 8), B(c), W(c >> 24) {}
+  RgbwColor(const RgbColor &c) : R(c.R), G(c.G), B(c.B) {}
+  inline RgbwColor(const Rgb48Color &c);
+  inline RgbwColor(const Rgbw64Color &c);
+};
+
+struct Rgb48Color {
+  uint16_t R = 0, G = 0, B = 0;
+  Rgb48Color() {}
+  Rgb48Color(const RgbColor &c) : R(c.R * 257), G(c.G * 257), B(c.B * 257) {}
+};
+
+struct Rgbw64Color {
+  uint16_t R = 0, G = 0, B = 0, W = 0;
+  Rgbw64Color() {}
+  Rgbw64Color(const RgbwColor &c) : R(c.R * 257), G(c.G * 257), B(c.B * 257), W(c.W * 257) {}
+};
+
+inline RgbColor::RgbColor(const RgbwColor &c)    : R(c.R), G(c.G), B(c.B) {}
+inline RgbColor::RgbColor(const Rgb48Color &c)   : R(c.R >> 8), G(c.G >> 8), B(c.B >> 8) {}
+inline RgbwColor::RgbwColor(const Rgb48Color &c) : R(c.R >> 8), G(c.G >> 8), B(c.B >> 8) {}
+inline RgbwColor::RgbwColor(const Rgbw64Color &c): R(c.R >> 8), G(c.G >> 8), B(c.B >> 8), W(c.W >> 8) {}
+
+// color features only determine the color object stored per pixel
+struct NeoRgbFeatureBase  { typedef RgbColor    ColorObject; };
+struct NeoRgbwFeatureBase { typedef RgbwColor   ColorObject; };
+struct NeoGrbFeature          : NeoRgbFeatureBase {};
+struct NeoBrgFeature          : NeoRgbFeatureBase {};
+struct NeoRbgFeature          : NeoRgbFeatureBase {};
+struct DotStarBgrFeature      : NeoRgbFeatureBase {};
+struct Lpd6803GrbFeature      : NeoRgbFeatureBase {};
+struct Lpd8806GrbFeature      : NeoRgbFeatureBase {};
+struct P9813BgrFeature        : NeoRgbFeatureBase {};
+struct NeoGrbwFeature         : NeoRgbwFeatureBase {};
+struct NeoWrgbTm1814Feature   : NeoRgbwFeatureBase {};
+struct NeoRgbUcs8903Feature   { typedef Rgb48Color  ColorObject; };
+struct NeoRgbwUcs8904Feature  { typedef Rgbw64Color ColorObject; };
+
+struct NeoSpiSettings    { NeoSpiSettings(uint32_t) {} };
+struct NeoTm1814Settings { NeoTm1814Settings(uint16_t, uint16_t, uint16_t, uint16_t) {} };
+enum NeoBusChannel { NeoBusChannel_0, NeoBusChannel_1, NeoBusChannel_2, NeoBusChannel_3,
+                     NeoBusChannel_4, NeoBusChannel_5, NeoBusChannel_6, NeoBusChannel_7 };
+
+// methods (the wire protocol) are irrelevant on the host
+struct NeoGammaNullMethod {};
+struct NeoGammaWLEDMethod {};
+struct SpiSpeedHz {};
+template<class S> struct TwoWireHspiImple {};
+template<class T> struct Ws2801MethodBase {};
+struct DotStarEsp32DmaHspi5MhzMethod {};
+struct DotStarEsp32HspiHzMethod {};
+struct DotStarMethod {};
+struct DotStarSpiHzMethod {};
+struct Lpd6803Method {};
+struct Lpd6803SpiHzMethod {};
+struct Lpd8806Method {};
+struct Lpd8806SpiHzMethod {};
+struct P9813Method {};
+struct P9813SpiHzMethod {};
+struct Ws2801Method {};
+struct Ws2801SpiHzMethod {};
+struct NeoEsp32BitBang400KbpsMethod {};
+struct NeoEsp32BitBang800KbpsMethod {};
+struct NeoEsp32I2s0400KbpsMethod {};
+struct NeoEsp32I2s0800KbpsMethod {};
+struct NeoEsp32I2s0Tm1814Method {};
+struct NeoEsp32I2s0Tm1829Method {};
+struct NeoEsp32I2s1400KbpsMethod {};
+struct NeoEsp32I2s1800KbpsMethod {};
+struct NeoEsp32I2s1Tm1814Method {};
+struct NeoEsp32I2s1Tm1829Method {};
+struct NeoEsp32RmtN400KbpsMethod {};
+struct NeoEsp32RmtNTm1814Method {};
+struct NeoEsp32RmtNTm1829Method {};
+struct NeoEsp32RmtNWs2812xMethod {};
+struct NeoEsp8266BitBang400KbpsMethod {};
+struct NeoEsp8266BitBang800KbpsMethod {};
+struct NeoEsp8266BitBangTm1814Method {};
+struct NeoEsp8266BitBangTm1829Method {};
+struct NeoEsp8266Dma400KbpsMethod {};
+struct NeoEsp8266Dma800KbpsMethod {};
+struct NeoEsp8266DmaTm1814Method {};
+struct NeoEsp8266DmaTm1829Method {};
+struct NeoEsp8266Uart0400KbpsMethod {};
+struct NeoEsp8266Uart0Tm1814Method {};
+struct NeoEsp8266Uart0Tm1829Method {};
+struct NeoEsp8266Uart0Ws2813Method {};
+struct NeoEsp8266Uart1400KbpsMethod {};
+struct NeoEsp8266Uart1Tm1814Method {};
+struct NeoEsp8266Uart1Tm1829Method {};
+struct NeoEsp8266Uart1Ws2813Method {};
+
+template<class T_COLOR_FEATURE, class T_METHOD, class T_GAMMA = NeoGammaNullMethod>
+class NeoPixelBusLg {
+ public:
+  typedef typename T_COLOR_FEATURE::ColorObject ColorObject;
+
+  NeoPixelBusLg(uint16_t count)                          : _pixels(count) {}
+  NeoPixelBusLg(uint16_t count, uint8_t)                 : _pixels(count) {}
+  NeoPixelBusLg(uint16_t count, uint8_t, uint8_t)        : _pixels(count) {}
+  NeoPixelBusLg(uint16_t count, uint8_t, NeoBusChannel)  : _pixels(count) {}
+
+  void Begin()                              {}
+  void Begin(int8_t, int8_t, int8_t, int8_t) {}
+  bool CanShow() const                      { return true; }
+  void Show(bool = true)                    { _shows++; }
+  uint16_t PixelCount() const               { return _pixels.size(); }
+  void SetLuminance(uint8_t l)              { _luminance = l; }
+  uint8_t GetLuminance() const              { return _luminance; }
+  template<class S> void SetMethodSettings(const S&) {}
+  template<class S> void SetPixelSettings(const S&)  {}
+
+  void SetPixelColor(uint16_t i, ColorObject c) { if (i < _pixels.size()) _pixels[i] = c; }
+  ColorObject GetPixelColor(uint16_t i) const   { return i < _pixels.size() ? _pixels[i] : ColorObject(); }
+
+  uint32_t ShowCount() const                    { return _shows; }
+
+ private:
+  std::vector<ColorObject> _pixels;
+  uint8_t  _luminance = 255;
+  uint32_t _shows = 0;
+};
@@ -0,0 +1,68 @@
+#pragma once
+// Print/Stream base classes; printf-style output is formatted with vsnprintf (host build only)
+#include <Arduino.h>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class Print;
+class Printable {
+ public:
+  virtual ~Printable() {}
+  virtual size_t printTo(Print &p) const = 0;
+};
+
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t) = 0;
+  virtual size_t write(const uint8_t *buf, size_t len) { size_t n = 0; while (len--) n += write(*buf++); return n; }
+  size_t write(const char *str)                        { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+  size_t write(const char *buf, size_t len)            { return write((const uint8_t*)buf, len); }
+  virtual void flush() {}
+
+  size_t print(const char *s)                 { return write(s); }
+  size_t print(const __FlashStringHelper *s)  { return write(reinterpret_cast<const char*>(s)); }
+  size_t print(const String &s)               { return write(s.c_str()); }
+  size_t print(char c)                        { return write((uint8_t)c); }
+  size_t print(unsigned char v, int base=DEC) { return print(String((unsigned)v, base)); }
+  size_t print(int v, int base=DEC)           { return print(String(v, base)); }
+  size_t print(unsigned v, int base=DEC)      { return print(String(v, base)); }
+  size_t print(long v, int base=DEC)          { return print(String(v, base)); }
+  size_t print(unsigned long v, int base=DEC) { return print(String(v, base)); }
+  size_t print(double v, int d=2)             { return print(String(v, d)); }
+  size_t print(const Printable &p)            { return p.printTo(*this); }
+  size_t println()                            { return write("\r\n"); }
+  template<typename T> size_t println(T v)              { size_t n = print(v); return n + println(); }
+  template<typename T> size_t println(T v, int f)       { size_t n = print(v, f); return n + println(); }
+  size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+    char buf[512];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    return len > 0 ? write((const uint8_t*)buf, std::min<size_t>(len, sizeof(buf)-1)) : 0;
+  }
+};
+#define printf_P printf
+
+class Stream : public Print {
+ public:
+  virtual int available() { return 0; }
+  virtual int read()      { return -1; }
+  virtual int peek()      { return -1; }
+  void setTimeout(unsigned long) {}
+  size_t readBytes(char *buf, size_t len) {
+    size_t n = 0;
+    for (int c; n < len && (c = read()) >= 0; n++) buf[n] = c;
+    return n;
+  }
+  size_t readBytes(uint8_t *buf, size_t len) { return readBytes((char*)buf, len); }
+  String readStringUntil(char term) {
+    String r;
+    for (int c; (c = read()) >= 0 && c != term; ) r += (char)c;
+    return r;
+  }
+};
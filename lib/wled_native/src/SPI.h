@@ -0,0 +1,11 @@
+#pragma once
+// SPI is not available on the host
+#include <Arduino.h>
+
+class SPIClass {
+ public:
+  template<typename... A> void begin(A...) {}
+  void    end()               {}
+  uint8_t transfer(uint8_t)   { return 0; }
+};
+extern SPIClass SPI;
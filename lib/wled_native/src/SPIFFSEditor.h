@@ -0,0 +1,9 @@
+#pragma once
+#include <ESPAsyncWebServer.h>
+
+#define SPIFFS_EDITOR_AIRCOOOKIE  // nothing is served on the host, so the fork's protection is implied
+
+class SPIFFSEditor : public AsyncWebHandler {
+ public:
+  template<typename... A> SPIFFSEditor(A&&...) {}
+};
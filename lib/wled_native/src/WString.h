@@ -0,0 +1,112 @@
+#pragma once
+// Arduino String on top of std::string (host build only)
+#include <Arduino.h>
+
+class __FlashStringHelper;
+
+class String {
+  std::string s;
+ public:
+  String(const char *c = "")                 : s(c ? c : "") {}
+  String(const __FlashStringHelper *c)       : s(c ? reinterpret_cast<const char*>(c) : "") {}
+  String(const std::string &c)               : s(c) {}
+  String(char c)                             : s(1, c) {}
+  String(int v, unsigned char base = 10)           { fromLong(v, base); }
+  String(unsigned v, unsigned char base = 10)      { fromULong(v, base); }
+  String(long v, unsigned char base = 10)          { fromLong(v, base); }
+  String(unsigned long v, unsigned char base = 10) { fromULong(v, base); }
+  String(float v, unsigned char d = 2)             { fromDouble(v, d); }
+  String(double v, unsigned char d = 2)            { fromDouble(v, d); }
+
+  const char *c_str() const    { return s.c_str(); }
+  unsigned length() const      { return s.length(); }
+  bool isEmpty() const         { return s.empty(); }
+  void reserve(unsigned n)     { s.reserve(n); }
+  explicit operator bool() const { return true; }
+
+  String &operator+=(const String &o)  { s += o.s; return *this; }
+  String &operator+=(const char *o)    { if (o) s += o; return *this; }
+  String &operator+=(const __FlashStringHelper *o) { return *this += reinterpret_cast<const char*>(o); }
+  String &operator+=(char c)           { s += c; return *this; }
+  String &operator+=(int v)            { return *this += String(v); }
+  String &operator+=(unsigned v)       { return *this += String(v); }
+  String &operator+=(long v)           { return *this += String(v); }
+  String &operator+=(unsigned long v)  { return *this += String(v); }
+  bool concat(const char *o)           { *this += o; return true; }
+  bool concat(char c)                  { s += c; return true; }
+  bool concat(const String &o)         { s += o.s; return true; }
+
+  bool operator==(const String &o) const { return s == o.s; }
+  bool operator!=(const String &o) const { return s != o.s; }
+  bool operator==(const char *o) const   { return s == (o ? o : ""); }
+  bool operator!=(const char *o) const   { return !(*this == o); }
+  bool operator<(const String &o) const  { return s < o.s; }
+  bool equals(const char *o) const       { return *this == o; }
+  bool equals(const String &o) const     { return s == o.s; }
+  bool equalsIgnoreCase(const String &o) const { return strcasecmp(s.c_str(), o.s.c_str()) == 0; }
+  int  compareTo(const String &o) const  { return s.compare(o.s); }
+
+  char  operator[](unsigned i) const { return i < s.length() ? s[i] : 0; }
+  char &operator[](unsigned i)       { return s[i]; }
+  char  charAt(unsigned i) const     { return (*this)[i]; }
+
+  int indexOf(char c, unsigned from = 0) const        { return npos(s.find(c, from)); }
+  int indexOf(const char *c, unsigned from = 0) const { return npos(s.find(c, from)); }
+  int indexOf(const String &c, unsigned from = 0) const { return npos(s.find(c.s, from)); }
+  int lastIndexOf(char c) const                       { return npos(s.rfind(c)); }
+  bool startsWith(const char *c) const   { return s.compare(0, strlen(c), c) == 0; }
+  bool startsWith(const String &c) const { return startsWith(c.c_str()); }
+  bool endsWith(const char *c) const     { size_t n = strlen(c); return s.length() >= n && s.compare(s.length() - n, n, c) == 0; }
+  bool endsWith(const String &c) const   { return endsWith(c.c_str()); }
+
+  String substring(unsigned from) const { return from < s.length() ? String(s.substr(from)) : String(); }
+  String substring(unsigned from, unsigned to) const {
+    if (from > to) std::swap(from, to);
+    return from < s.length() ? String(s.substr(from, to - from)) : String();
+  }
+  long  toInt() const   { return atol(s.c_str()); }
+  float toFloat() const { return atof(s.c_str()); }
+  void  toCharArray(char *buf, unsigned len, unsigned i = 0) const { getBytes((unsigned char*)buf, len, i); }
+  void  getBytes(unsigned char *buf, unsigned len, unsigned i = 0) const {
+    if (!len || !buf) return;
+    size_t n = i < s.length() ? std::min<size_t>(len - 1, s.length() - i) : 0;
+    if (n) memcpy(buf, s.data() + i, n);
+    buf[n] = 0;
+  }
+
+  void trim() {
+    size_t b = s.find_first_not_of(" \t\r\n"), e = s.find_last_not_of(" \t\r\n");
+    s = b == std::string::npos ? std::string() : s.substr(b, e - b + 1);
+  }
+  void toLowerCase() { for (auto &c : s) c = tolower(c); }
+  void toUpperCase() { for (auto &c : s) c = toupper(c); }
+  void replace(const String &from, const String &to) {
+    if (from.s.empty()) return;
+    for (size_t p = 0; (p = s.find(from.s, p)) != std::string::npos; p += to.s.length()) s.replace(p, from.s.length(), to.s);
+  }
+  void remove(unsigned i)             { if (i < s.length()) s.erase(i); }
+  void remove(unsigned i, unsigned n) { if (i < s.length()) s.erase(i, n); }
+
+ private:
+  static int npos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+  void fromLong(long v, unsigned char base)  { if (base == 10) s = std::to_string(v); else fromULong(v, base); }
+  void fromULong(unsigned long v, unsigned char base) {
+    char buf[66]; char *p = buf + sizeof(buf) - 1; *p = 0;
+    do { unsigned d = v % base; *--p = d < 10 ? '0' + d : 'a' + d - 10; v /= base; } while (v);
+    s = p;
+  }
+  void fromDouble(double v, unsigned char d) { char buf[64]; snprintf(buf, sizeof(buf), "%.*f", d, v); s = buf; }
+};
+
+inline String operator+(const String &a, const String &b) { String r(a); r += b; return r; }
+inline String operator+(const String &a, const char *b)   { String r(a); r += b; return r; }
+inline String operator+(const char *a, const String &b)   { String r(a); r += b; return r; }
+inline String operator+(const String &a, char b)          { String r(a); r += b; return r; }
+inline String operator+(const String &a, int b)           { String r(a); r += b; return r; }
+inline String operator+(const String &a, unsigned b)      { String r(a); r += b; return r; }
+inline String operator+(const String &a, long b)          { String r(a); r += b; return r; }
+inline String operator+(const String &a, unsigned long b) { String r(a); r += b; return r; }
+class StringSumHelper : public String {
+ public:
+  StringSumHelper(const String &s) : String(s) {}
+};
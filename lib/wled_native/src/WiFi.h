@@ -0,0 +1,77 @@
+#pragma once
+// The host is always "connected"; WiFi/AP management calls are accepted and ignored
+#include <Arduino.h>
+#include <WiFiUdp.h>
+
+typedef int WiFiEvent_t;
+typedef int wifi_event_id_t;
+typedef int wl_status_t;
+typedef int wifi_mode_t;
+#define WL_IDLE_STATUS    0
+#define WL_NO_SSID_AVAIL  1
+#define WL_CONNECTED      3
+#define WL_CONNECT_FAILED 4
+#define WL_DISCONNECTED   6
+#define WIFI_OFF    0
+#define WIFI_STA    1
+#define WIFI_AP     2
+#define WIFI_AP_STA 3
+#define WIFI_SCAN_RUNNING -1
+#define WIFI_SCAN_FAILED  -2
+#define WIFI_POWER_8_5dBm 34
+#define WIFI_AUTH_OPEN    0
+
+class WiFiClass {
+  int     _mode = WIFI_STA;
+  uint8_t _mac[6] = {0x02, 0x00, 0xDE, 0xAD, 0xBE, 0xEF};
+ public:
+  wl_status_t status()            { return WL_CONNECTED; }
+  bool        isConnected()       { return true; }
+  IPAddress localIP()             { return IPAddress(127,0,0,1); }
+  IPAddress gatewayIP()           { return IPAddress(127,0,0,1); }
+  IPAddress subnetMask()          { return IPAddress(255,0,0,0); }
+  IPAddress softAPIP()            { return IPAddress(); }
+  String   SSID()                 { return String("native"); }
+  String   SSID(int)              { return String(); }
+  int32_t  RSSI()                 { return -50; }
+  int32_t  RSSI(int)              { return 0; }
+  uint8_t *BSSID()                { return _mac; }
+  String   BSSIDstr()             { return String(); }
+  String   BSSIDstr(int)          { return String(); }
+  int32_t  channel()              { return 1; }
+  int32_t  channel(int)           { return 0; }
+  int      encryptionType(int)    { return WIFI_AUTH_OPEN; }
+  String   macAddress()           { return String("02:00:DE:AD:BE:EF"); }
+  uint8_t *macAddress(uint8_t *m) { memcpy(m, _mac, 6); return m; }
+  void     mode(int m)            { _mode = m; }
+  int      getMode()              { return _mode; }
+  void     begin(const char*, const char*) {}
+  void     disconnect(bool = false, bool = false) {}
+  bool     config(IPAddress, IPAddress, IPAddress, IPAddress = IPAddress(), IPAddress = IPAddress()) { return true; }
+  bool     softAP(const char*, const char* = nullptr, int = 1, int = 0, int = 4) { return true; }
+  bool     softAPConfig(IPAddress, IPAddress, IPAddress) { return true; }
+  void     softAPdisconnect(bool = false) {}
+  int      softAPgetStationNum()  { return 0; }
+  void     setSleep(bool)         {}
+  void     setHostname(const char*) {}
+  void     setTxPower(int)        {}
+  int      getTxPower()           { return 0; }
+  void     persistent(bool)       {}
+  bool     setAutoReconnect(bool) { return true; }
+  void     onEvent(void(*)(WiFiEvent_t)) {}
+  int      scanNetworks(bool = false) { return 0; }
+  int      scanComplete()         { return 0; }
+  void     scanDelete()           {}
+  bool     hostByName(const char *host, IPAddress &ip) { return ip.fromString(host); }
+};
+extern WiFiClass WiFi;
+
+class WiFiClient : public Stream {
+ public:
+  bool connect(IPAddress, uint16_t) { return false; }
+  bool connect(const char*, uint16_t) { return false; }
+  bool connected()                  { return false; }
+  void stop()                       {}
+  using Print::write;
+  size_t write(uint8_t) override    { return 0; }
+};
@@ -0,0 +1,95 @@
+#pragma once
+// WiFiUDP on top of non-blocking BSD sockets, so realtime protocols and notifications work on the host
+#include <Arduino.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+class WiFiUDP : public Stream {
+  int      _fd = -1;
+  uint8_t  _rx[1500];             // one datagram (Ethernet MTU)
+  size_t   _rxLen = 0, _rxPos = 0;
+  uint8_t  _tx[1500];
+  size_t   _txLen = 0;
+  sockaddr_in _remote{}, _dest{};
+
+  static sockaddr_in addr(IPAddress ip, uint16_t port) {
+    sockaddr_in a{};
+    a.sin_family = AF_INET;
+    a.sin_port = htons(port);
+    a.sin_addr.s_addr = (uint32_t)ip;   // IPAddress keeps octets in network order
+    return a;
+  }
+  bool open() {
+    if (_fd >= 0) return true;
+    _fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (_fd < 0) return false;
+    int on = 1;
+    setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    setsockopt(_fd, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+    fcntl(_fd, F_SETFL, fcntl(_fd, F_GETFL) | O_NONBLOCK);
+    return true;
+  }
+
+ public:
+  ~WiFiUDP() { stop(); }
+
+  uint8_t begin(uint16_t port) {
+    if (!open()) return 0;
+    sockaddr_in a = addr(IPAddress(), port);
+    if (bind(_fd, (sockaddr*)&a, sizeof(a)) < 0) { stop(); return 0; }
+    return 1;
+  }
+  uint8_t beginMulticast(IPAddress group, uint16_t port) {
+    if (!begin(port)) return 0;
+    ip_mreq m{};
+    m.imr_multiaddr.s_addr = (uint32_t)group;
+    m.imr_interface.s_addr = htonl(INADDR_ANY);
+    setsockopt(_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &m, sizeof(m));
+    return 1;
+  }
+  void stop() { if (_fd >= 0) close(_fd); _fd = -1; _rxLen = _rxPos = 0; }
+
+  int beginPacket(IPAddress ip, uint16_t port) { _dest = addr(ip, port); _txLen = 0; return open(); }
+  int beginPacket(const char *host, uint16_t port) {
+    IPAddress ip;
+    return ip.fromString(host) ? beginPacket(ip, port) : 0;
+  }
+  int endPacket() {
+    if (_fd < 0) return 0;
+    ssize_t n = sendto(_fd, _tx, _txLen, 0, (sockaddr*)&_dest, sizeof(_dest));
+    _txLen = 0;
+    return n >= 0;
+  }
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buf, size_t len) override {
+    len = std::min(len, sizeof(_tx) - _txLen);
+    memcpy(_tx + _txLen, buf, len);
+    _txLen += len;
+    return len;
+  }
+
+  // returns size of the next datagram or 0 if none is waiting
+  int parsePacket() {
+    if (_fd < 0) return 0;
+    socklen_t sl = sizeof(_remote);
+    ssize_t n = recvfrom(_fd, _rx, sizeof(_rx), MSG_DONTWAIT, (sockaddr*)&_remote, &sl);
+    _rxPos = 0;
+    _rxLen = n > 0 ? n : 0;
+    return _rxLen;
+  }
+  int available() override { return _rxLen - _rxPos; }
+  int read() override      { return _rxPos < _rxLen ? _rx[_rxPos++] : -1; }
+  int peek() override      { return _rxPos < _rxLen ? _rx[_rxPos] : -1; }
+  int read(unsigned char *buf, size_t len) {
+    len = std::min(len, _rxLen - _rxPos);
+    memcpy(buf, _rx + _rxPos, len);
+    _rxPos += len;
+    return len;
+  }
+  int read(char *buf, size_t len) { return read((unsigned char*)buf, len); }
+  void flush() override           { _rxPos = _rxLen; }
+  IPAddress remoteIP()            { return IPAddress((uint32_t)_remote.sin_addr.s_addr); }
+  uint16_t  remotePort()          { return ntohs(_remote.sin_port); }
+};
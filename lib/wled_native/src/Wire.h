@@ -0,0 +1,18 @@
+#pragma once
+// I2C is not available on the host: no device ever acknowledges
+#include <Arduino.h>
+
+class TwoWire : public Stream {
+ public:
+  template<typename... A> bool begin(A...)  { return true; }
+  void    end()                             {}
+  bool    setPins(int, int)                 { return true; }
+  void    setClock(uint32_t)                {}
+  void    beginTransmission(uint8_t)        {}
+  uint8_t endTransmission(bool = true)      { return 2; } // NACK on address
+  uint8_t requestFrom(uint8_t, uint8_t, bool = true) { return 0; }
+  using Print::write;
+  size_t  write(uint8_t) override           { return 1; }
+  size_t  write(int n)                      { return write((uint8_t)n); }
+};
+extern TwoWire Wire;
@@ -0,0 +1,6 @@
+#pragma once
+#include <Arduino.h>
+
+typedef struct { uint8_t mac[6]; } wifi_sta_info_t;
+typedef struct { wifi_sta_info_t sta[10]; int num; } wifi_sta_list_t;
+inline int esp_wifi_ap_get_sta_list(wifi_sta_list_t *l) { l->num = 0; return ESP_OK; }
@@ -0,0 +1,6 @@
+#pragma once
+// multicast groups are joined by the host UDP stack
+#include <lwip/ip_addr.h>
+
+inline int igmp_joingroup(const ip4_addr_t*, const ip4_addr_t*)  { return 0; }
+inline int igmp_leavegroup(const ip4_addr_t*, const ip4_addr_t*) { return 0; }
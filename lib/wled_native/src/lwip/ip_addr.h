@@ -0,0 +1,5 @@
+#pragma once
+#include <stdint.h>
+
+typedef struct { uint32_t addr; } ip4_addr_t;
+typedef ip4_addr_t ip_addr_t;
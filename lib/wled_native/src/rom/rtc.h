@@ -0,0 +1,5 @@
+#pragma once
+#include <Arduino.h>
+
+#define POWERON_RESET 1
+inline int rtc_get_reset_reason(int) { return POWERON_RESET; }
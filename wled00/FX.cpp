@@ -4837,11 +4837,12 @@ uint16_t mode_2DDrift() {              // By: Stepko   https://editor.soulmateli
   const uint16_t maxDim = MAX(cols, rows)/2;
   unsigned long t = millis() / (32 - (SEGMENT.speed>>3));
   unsigned long t_20 = t/20; // softhack007: pre-calculating this gives about 10% speedup
-  for (float i = 1; i < maxDim; i += 0.25) {
-    float angle = radians(t * (maxDim - i));
-    uint16_t myX = (cols>>1) + (uint16_t)(sin_t(angle) * i) + (cols%2);
-    uint16_t myY = (rows>>1) + (uint16_t)(cos_t(angle) * i) + (rows%2);
-    SEGMENT.setPixelColorXY(myX, myY, ColorFromPalette(SEGPALETTE, (i * 20) + t_20, 255, LINEARBLEND));
+  const unsigned t_1440 = t % 1440;
+  for (int i4 = 4; i4 < 4*maxDim; i4++) { // radius in 1/4 pixels
+    uint16_t angle = (t_1440 * (4*maxDim - i4)) % 1440 * 65536 / 1440; // t * (maxDim - i) degrees, 16 bit
+    uint16_t myX = (cols>>1) + sin16_t(angle) * i4 / (4*32767) + (cols%2);
+    uint16_t myY = (rows>>1) + cos16_t(angle) * i4 / (4*32767) + (rows%2);
+    SEGMENT.setPixelColorXY(myX, myY, ColorFromPalette(SEGPALETTE, i4 * 5 + t_20, 255, LINEARBLEND));
   }
   SEGMENT.blur(SEGMENT.intensity>>3);
 
@@ -4867,15 +4868,15 @@ uint16_t mode_2Dfirenoise(void) {               // firenoise2d. By Andrew Tuline
   uint32_t yscale = SEGMENT.speed*8;
   uint8_t indexx = 0;
 
-  SEGPALETTE = CRGBPalette16( CRGB(0,0,0), CRGB(0,0,0), CRGB(0,0,0), CRGB(0,0,0),
-                              CRGB::Red, CRGB::Red, CRGB::Red, CRGB::DarkOrange,
-                              CRGB::DarkOrange,CRGB::DarkOrange, CRGB::Orange, CRGB::Orange,
-                              CRGB::Yellow, CRGB::Orange, CRGB::Yellow, CRGB::Yellow);
+  CRGBPalette16 pal = CRGBPalette16(CRGB(0,0,0), CRGB(0,0,0), CRGB(0,0,0), CRGB(0,0,0),
+                                     CRGB::Red, CRGB::Red, CRGB::Red, CRGB::DarkOrange,
+                                     CRGB::DarkOrange,CRGB::DarkOrange, CRGB::Orange, CRGB::Orange,
+                                     CRGB::Yellow, CRGB::Orange, CRGB::Yellow, CRGB::Yellow);
 
   for (int j=0; j < cols; j++) {
     for (int i=0; i < rows; i++) {
       indexx = inoise8(j*yscale*rows/255, i*xscale+millis()/4);                                           // We're moving along our Perlin map.
-      SEGMENT.setPixelColorXY(j, i, ColorFromPalette(SEGPALETTE, min(i*(indexx)>>4, 255), i*255/cols, LINEARBLEND)); // With that value, look up the 8 bit colour palette value and assign it to the current LED.
+      SEGMENT.setPixelColorXY(j, i, ColorFromPalette(pal, min(i*(indexx)>>4, 255), i*255/cols, LINEARBLEND)); // With that value, look up the 8 bit colour palette value and assign it to the current LED.
     } // for i
   } // for j
 
@@ -4974,7 +4975,7 @@ uint16_t mode_2Dgameoflife(void) { // Written by Ewoud Wijma, inspired by https:
         neighbors++;
         bool colorFound = false;
         int k;
-        for (k=0; k<9 && colorsCount[i].count != 0; k++)
+        for (k=0; k<9 && colorsCount[k].count != 0; k++)
           if (colorsCount[k].color == prevLeds[xy]) {
             colorsCount[k].count++;
             colorFound = true;
@@ -5092,14 +5093,7 @@ uint16_t mode_2DJulia(void) {                           // An animated Julia set
   ymin = constrain(ymin, -0.8f, 1.0f);
   ymax = constrain(ymax, -0.8f, 1.0f);
 
-  float dx;                       // Delta x is mapped to the matrix size.
-  float dy;                       // Delta y is mapped to the matrix size.
-
-  int maxIterations = 15;         // How many iterations per pixel before we give up. Make it 8 bits to match our range of colours.
-  float maxCalc = 16.0;           // How big is each calculation allowed to be before we give up.
-
-  maxIterations = SEGMENT.intensity/2;
-
+  int maxIterations = SEGMENT.intensity/2; // How many iterations per pixel before we give up.
 
   // Resize section on the fly for some animaton.
   reAl = -0.94299f;               // PixelBlaze example
@@ -5108,33 +5102,40 @@ uint16_t mode_2DJulia(void) {                           // An animated Julia set
   reAl += sin_t((float)millis()/305.f)/20.f;
   imAg += sin_t((float)millis()/405.f)/20.f;
 
-  dx = (xmax - xmin) / (cols);     // Scale the delta x and y values to our matrix size.
-  dy = (ymax - ymin) / (rows);
+  // The iteration runs in Q13 fixed point (resolution 1.2e-4, still below a pixel at the smallest area).
+  // Bailing out once |a| or |b| exceeds 4 (then |z|^2 > 16 anyway) keeps all products within 32 bit.
+  const int      q       = 13;
+  const int32_t  lim     = 4 << q;
+  const uint32_t maxCalc = 16UL << (2*q);     // How big |z|^2 is allowed to be before we give up.
+  const int32_t  cRe     = reAl * (1 << q);
+  const int32_t  cIm     = imAg * (1 << q);
+  const int32_t  dx      = (xmax - xmin) * (1 << (q+8)) / cols; // Scale the delta x and y values to our matrix size (Q21).
+  const int32_t  dy      = (ymax - ymin) * (1 << (q+8)) / rows;
 
   // Start y
-  float y = ymin;
+  int32_t y = ymin * (1 << (q+8));
   for (int j = 0; j < rows; j++) {
 
     // Start x
-    float x = xmin;
+    int32_t x = xmin * (1 << (q+8));
     for (int i = 0; i < cols; i++) {
 
       // Now we test, as we iterate z = z^2 + c does z tend towards infinity?
-      float a = x;
-      float b = y;
+      int32_t a = x >> 8;
+      int32_t b = y >> 8;
       int iter = 0;
 
       while (iter < maxIterations) {    // Here we determine whether or not we're out of bounds.
-        float aa = a * a;
-        float bb = b * b;
-        float len = aa + bb;
-        if (len > maxCalc) {            // |z| = sqrt(a^2+b^2) OR z^2 = a^2+b^2 to save on having to perform a square root.
+        if (abs(a) > lim || abs(b) > lim) break;
+        uint32_t aa = a * a;
+        uint32_t bb = b * b;
+        if (aa + bb > maxCalc) {        // |z| = sqrt(a^2+b^2) OR z^2 = a^2+b^2 to save on having to perform a square root.
           break;  // Bail
         }
 
        // This operation corresponds to z -> z^2+c where z=a+ib c=(x,y). Remember to use 'foil'.
-        b = 2*a*b + imAg;
-        a = aa - bb + reAl;
+        b = ((a * b) >> (q-1)) + cIm;
+        a = (int32_t(aa - bb) >> q) + cRe;
         iter++;
       } // while
 
@@ -5396,7 +5397,7 @@ uint16_t mode_2DPolarLights(void) {        // By: Kostyantyn Matviyevskyy  https
     SEGENV.step = 0;
   }
 
-  float adjustHeight = (float)map(rows, 8, 32, 28, 12); // maybe use mapf() ???
+  const int adjustHeight = map(rows, 8, 32, 28, 12);
   uint16_t adjScale = map(cols, 8, 64, 310, 63);
 /*
   if (SEGENV.aux1 != SEGMENT.custom1/12) {   // Hacky palette rotation. We need that black.
@@ -5422,7 +5423,7 @@ uint16_t mode_2DPolarLights(void) {        // By: Kostyantyn Matviyevskyy  https
       SEGMENT.setPixelColorXY(x, y, ColorFromPalette(auroraPalette,
                                       qsub8(
                                         inoise8((SEGENV.step%2) + x * _scale, y * 16 + SEGENV.step % 16, SEGENV.step / _speed),
-                                        fabsf((float)rows / 2.0f - (float)y) * adjustHeight)));
+                                        abs(rows - 2*y) * adjustHeight / 2)));   // |rows/2 - y| * adjustHeight
     }
   }
 
@@ -7615,8 +7616,9 @@ uint16_t mode_2Doctopus() {
     const int C_Y = (rows / 2) + ((SEGMENT.custom2 - 128)*rows)/255;
     for (int x = 0; x < cols; x++) {
       for (int y = 0; y < rows; y++) {
-        rMap[XY(x, y)].angle  = 40.7436f * atan2f((y - C_Y), (x - C_X));  // avoid 128*atan2()/PI
-        rMap[XY(x, y)].radius = hypotf((x - C_X), (y - C_Y)) * mapp;      //thanks Sutaburosu
+        const int dx = x - C_X, dy = y - C_Y;
+        rMap[XY(x, y)].angle  = atan2_16_t(dy, dx) / 256;                  // 128*atan2()/PI
+        rMap[XY(x, y)].radius = (sqrt32_t((dx*dx + dy*dy) << 12) * mapp) >> 6; // hypot() in Q6, thanks Sutaburosu
       }
     }
   }
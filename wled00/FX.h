@@ -30,11 +30,33 @@
 #include <vector>
 
 #include "const.h"
+#include "render_pool.h"
+#include "segment_arena.h"
 
 #define FASTLED_INTERNAL //remove annoying pragma messages
 #define USE_GET_MILLISECOND_TIMER
 #include "FastLED.h"
 
+// FastLED keeps the state of random8()/random16() in a single global, effects of segments rendered in parallel
+// (see render_pool.h) must not share it: each render task has its own state (same generator) and each segment its
+// own seed that is swapped in while its effect runs (see WS2812FX::renderSegment()), frames do not depend on which
+// task renders a segment or in which order
+extern WLED_RENDER_TLS uint16_t fxRand16Seed;
+inline uint16_t fx_random16()                               { return fxRand16Seed = fxRand16Seed * 2053 + 13849; }
+inline uint16_t fx_random16(uint16_t lim)                   { return ((uint32_t)fx_random16() * lim) >> 16; }
+inline uint16_t fx_random16(uint16_t min, uint16_t lim)     { return fx_random16(lim - min) + min; }
+inline uint8_t  fx_random8()                                { uint16_t r = fx_random16(); return uint8_t(r & 0xFF) + uint8_t(r >> 8); }
+inline uint8_t  fx_random8(uint8_t lim)                     { return (fx_random8() * lim) >> 8; }
+inline uint8_t  fx_random8(uint8_t min, uint8_t lim)        { return fx_random8(lim - min) + min; }
+inline void     fx_random16_set_seed(uint16_t seed)         { fxRand16Seed = seed; }
+inline uint16_t fx_random16_get_seed()                      { return fxRand16Seed; }
+inline void     fx_random16_add_entropy(uint16_t entropy)   { fxRand16Seed += entropy; }
+#define random16              fx_random16
+#define random8               fx_random8
+#define random16_set_seed     fx_random16_set_seed
+#define random16_get_seed     fx_random16_get_seed
+#define random16_add_entropy  fx_random16_add_entropy
+
 #define DEFAULT_BRIGHTNESS (uint8_t)127
 #define DEFAULT_MODE       (uint8_t)0
 #define DEFAULT_SPEED      (uint8_t)128
@@ -83,7 +105,12 @@
   assuming each segment uses the same amount of data. 256 for ESP8266, 640 for ESP32. */
 #define FAIR_DATA_PER_SEG (MAX_SEGMENT_DATA / strip.getMaxSegments())
 
+/* statistics of all segments (see Segment::perf()), includes temporary copies of segments */
+#define SEGMENT_PERF_SLOTS (MAX_NUM_SEGMENTS + 4)
+
 #define MIN_SHOW_DELAY   (_frametime < 16 ? 8 : 15)
+#define RENDER_BUDGET_UNLIMITED 0xFFFFFFFFUL // see WS2812FX::setRenderBudget()
+#define FRAME_JITTER_SAMPLES 64 // frame intervals kept for the jitter percentiles (see WS2812FX::getFrameJitter())
 
 #define NUM_COLORS       3 /* number of colors per segment */
 #define SEGMENT          strip._segments[strip.getCurrSegmentId()]
@@ -91,8 +118,8 @@
 //#define SEGCOLOR(x)      strip._segments[strip.getCurrSegmentId()].currentColor(x, strip._segments[strip.getCurrSegmentId()].colors[x])
 //#define SEGLEN           strip._segments[strip.getCurrSegmentId()].virtualLength()
 #define SEGCOLOR(x)      strip.segColor(x) /* saves us a few kbytes of code */
-#define SEGPALETTE       strip._currentPalette
-#define SEGLEN           strip._virtualSegmentLength /* saves us a few kbytes of code */
+#define SEGPALETTE       WS2812FX::_ctx->palette
+#define SEGLEN           WS2812FX::_ctx->virtualLength /* saves us a few kbytes of code */
 #define SPEED_FORMULA_L  (5U + (50U*(255U - SEGMENT.speed))/SEGLEN)
 
 // some common colors
@@ -324,16 +351,48 @@ typedef enum mapping1D2D {
   M12_pCorner = 3
 } mapping1D2D_t;
 
-// segment, 80 bytes
+// performance counters (always on), values in µs
+#define PERF_HIST_SIZE 8  // histogram buckets: <64us, <256us, <1ms, <4ms, <16ms, <65ms, <262ms, longer
+
+typedef struct PerfStat {
+  uint32_t min;
+  uint32_t max;
+  uint32_t sum;                  // history is halved before count or sum overflow (sliding window)
+  uint16_t count;
+  uint16_t hist[PERF_HIST_SIZE];
+  void add(uint32_t us);
+  inline uint32_t avg(void) const { return count ? sum / count : 0; }
+} perf_stat_t;
+
+typedef struct SegmentPerf {
+  perf_stat_t fx;         // effect function(s), including the previous effect while blending
+  perf_stat_t composite;  // compositing the segment onto the strip in WS2812FX::show()
+  perf_stat_t interval;   // time between rendered frames
+  uint32_t    rendered;   // frames rendered
+  uint32_t    skipped;    // frames missed because the segment was serviced too late
+  uint32_t    missed;     // frames rendered a whole frame period (or more) after their deadline
+  uint32_t    deferred;   // times the segment was due but postponed to the next frame (render budget exhausted)
+  uint32_t    lastFrame;  // micros() of the last rendered frame
+} segment_perf_t;
+
+/*
+ * segment
+ * Members are ordered by access: everything WS2812FX::service() and show() check for every segment in every frame
+ * (geometry, options, schedule, pixel buffer, index tables and transition pointer) comes first and fits into the
+ * first 64 bytes, then effect parameters and runtime state that only the effect function of a due segment uses.
+ * Segments still live in one vector, only the statistics are kept outside (perf(), see _perfPool).
+ */
 typedef struct Segment {
+  private:
+    struct Transition;
+
   public:
+    // hot: geometry, schedule and buffers
     uint16_t start; // start index / start X coordinate 2D (left)
     uint16_t stop;  // stop index / stop X coordinate 2D (right); segment is invalid if stop == 0
-    uint16_t offset;
-    uint8_t  speed;
-    uint8_t  intensity;
-    uint8_t  palette;
-    uint8_t  mode;
+    uint8_t startY;  // start Y coodrinate 2D (top); there should be no more than 255 rows
+    uint8_t stopY;   // stop Y coordinate 2D (bottom); there should be no more than 255 rows
+    uint8_t  grouping, spacing;
     union {
       uint16_t options; //bit pattern: msb first: [transposed mirrorY reverseY] transitional (tbd) paused needspixelstate mirrored on reverse selected
       struct {
@@ -351,9 +410,28 @@ typedef struct Segment {
         uint8_t set         : 2;  // 14-15 : 0-3 UI segment sets/groups
       };
     };
-    uint8_t  grouping, spacing;
     uint8_t  opacity;
-    uint32_t colors[NUM_COLORS];
+    uint8_t  fps;                 // target frame rate of the effect, 0 = strip frame rate (see WS2812FX::service())
+    uint8_t  mode;
+  private:
+    uint8_t         _perfSlot;    // statistics of the segment in _perfPool
+    uint16_t        _pixelsLen;   // number of logical pixels allocated in pixels[]
+    uint16_t        _mapOpt;      // mapping options the index table was built with
+    uint8_t         _mapGen;      // mapping generation the index table was built with
+  public:
+    unsigned long next_time;  // millis() of next update
+    uint32_t *pixels; // logical (virtual) pixel buffer, effects render into it; composited onto the strip in WS2812FX::show()
+  private:
+    uint16_t       *_map;         // logical to physical index table (see buildMapping())
+    uint32_t       *_m12;         // 1D to 2D expansion table of map1D2D (see build1D2DMap())
+    Transition     *_t;           // transition data, valid only if isInTransition()
+
+  public:
+    // effect parameters
+    uint16_t offset;
+    uint8_t  speed;
+    uint8_t  intensity;
+    uint8_t  palette;
     uint8_t  cct;                 //0==1900K, 255==10091K
     uint8_t  custom1, custom2;    // custom FX parameters/sliders
     struct {
@@ -362,17 +440,31 @@ typedef struct Segment {
       bool    check2  : 1;        // checkmark 2
       bool    check3  : 1;        // checkmark 3
     };
-    uint8_t startY;  // start Y coodrinate 2D (top); there should be no more than 255 rows
-    uint8_t stopY;   // stop Y coordinate 2D (bottom); there should be no more than 255 rows
-    char    *name;
+    uint32_t colors[NUM_COLORS];
 
     // runtime data
-    unsigned long next_time;  // millis() of next update
     uint32_t step;  // custom "step" var
     uint32_t call;  // call counter
     uint16_t aux0;  // custom var
     uint16_t aux1;  // custom var
+    uint16_t randSeed; // random8()/random16() state of the effect, swapped in while it runs (see WS2812FX::renderSegment())
     byte     *data; // effect data pointer
+  private:
+    uint16_t        _dataLen;
+    union {
+      uint8_t  _capabilities;
+      struct {
+        bool    _isRGB    : 1;
+        bool    _hasW     : 1;
+        bool    _isCCT    : 1;
+        bool    _manualW  : 1;
+        uint8_t _reserved : 4;
+      };
+    };
+
+  public:
+    // cold
+    char    *name;
     static uint16_t maxWidth, maxHeight;  // these define matrix width & height (max. segment dimensions)
 
     typedef struct TemporarySegmentData {
@@ -393,32 +485,33 @@ typedef struct Segment {
       uint32_t _callT;
       uint8_t *_dataT;
       uint16_t _dataLenT;
+      uint32_t *_pixelsT;             // effect's own pixel buffer (same size as pixels[])
       TemporarySegmentData()
         : _dataT(nullptr) // just in case...
         , _dataLenT(0)
+        , _pixelsT(nullptr)
       {}
     } tmpsegd_t;
 
   private:
-    union {
-      uint8_t  _capabilities;
-      struct {
-        bool    _isRGB    : 1;
-        bool    _hasW     : 1;
-        bool    _isCCT    : 1;
-        bool    _manualW  : 1;
-        uint8_t _reserved : 4;
-      };
-    };
-    uint16_t        _dataLen;
-    static uint16_t _usedSegmentData;
+    static SegmentArena _arena;     // runtime data of all segments and their transition copies
+    static segment_perf_t _perfPool[SEGMENT_PERF_SLOTS+1]; // statistics (cold), last entry is shared by segments without a slot
+    static bool     _perfUsed[SEGMENT_PERF_SLOTS];
+    static uint8_t  acquirePerfSlot(void);
+    static void     releasePerfSlot(uint8_t slot);
+    static uint8_t  _mapGeneration; // incremented whenever segment bounds, matrix or ledmap change
 
     // perhaps this should be per segment, not static
     static CRGBPalette16 _randomPalette;      // actual random palette
     static CRGBPalette16 _newRandomPalette;   // target random palette
     static unsigned long _lastPaletteChange;  // last random palette change time in millis()
     #ifndef WLED_DISABLE_MODE_BLEND
-    static bool          _modeBlend;          // mode/effect blending semaphore
+    static WLED_RENDER_TLS bool _modeBlend;   // mode/effect blending semaphore (per render task)
+    #endif
+    unsigned mapPixel(unsigned v, uint16_t *tgt) const; // expand logical pixel to physical pixel indices
+    #ifndef WLED_DISABLE_2D
+    unsigned mapPixelXY(int x, int y, uint16_t *tgt) const;
+    const uint32_t *m12Runs(unsigned i, unsigned vW, unsigned vH, const uint32_t *&end) const; // runs of 1D pixel i, nullptr if table is stale
     #endif
 
     // transition data, valid only if transitional==true, holds values during transition (72 bytes)
@@ -441,23 +534,34 @@ typedef struct Segment {
         , _start(millis())
         , _dur(dur)
       {}
-    } *_t;
+    };
 
   public:
 
     Segment(uint16_t sStart=0, uint16_t sStop=30) :
       start(sStart),
       stop(sStop),
+      startY(0),
+      stopY(1),
+      grouping(1),
+      spacing(0),
+      options(SELECTED | SEGMENT_ON),
+      opacity(255),
+      fps(0),
+      mode(DEFAULT_MODE),
+      _perfSlot(acquirePerfSlot()),
+      _pixelsLen(0),
+      _mapOpt(0),
+      _mapGen(0),
+      next_time(0),
+      pixels(nullptr),
+      _map(nullptr),
+      _m12(nullptr),
+      _t(nullptr),
       offset(0),
       speed(DEFAULT_SPEED),
       intensity(DEFAULT_INTENSITY),
       palette(0),
-      mode(DEFAULT_MODE),
-      options(SELECTED | SEGMENT_ON),
-      grouping(1),
-      spacing(0),
-      opacity(255),
-      colors{DEFAULT_COLOR,BLACK,BLACK},
       cct(127),
       custom1(DEFAULT_C1),
       custom2(DEFAULT_C2),
@@ -465,18 +569,16 @@ typedef struct Segment {
       check1(false),
       check2(false),
       check3(false),
-      startY(0),
-      stopY(1),
-      name(nullptr),
-      next_time(0),
+      colors{DEFAULT_COLOR,BLACK,BLACK},
       step(0),
       call(0),
       aux0(0),
       aux1(0),
+      randSeed(random16()),
       data(nullptr),
-      _capabilities(0),
       _dataLen(0),
-      _t(nullptr)
+      _capabilities(0),
+      name(nullptr)
     {
       #ifdef WLED_DEBUG
       //Serial.printf("-- Creating segment: %p\n", this);
@@ -489,6 +591,7 @@ typedef struct Segment {
     }
 
     Segment(const Segment &orig); // copy constructor
+    Segment(const Segment &orig, bool settingsOnly); // settingsOnly: lightweight copy for differs()
     Segment(Segment &&orig) noexcept; // move constructor
 
     ~Segment() {
@@ -501,13 +604,17 @@ typedef struct Segment {
       if (name) { delete[] name; name = nullptr; }
       stopTransition();
       deallocateData();
+      deallocatePixelBuffer();
+      deallocateMapping();
+      if (_m12) free(_m12);
+      releasePerfSlot(_perfSlot);
     }
 
     Segment& operator= (const Segment &orig); // copy assignment
     Segment& operator= (Segment &&orig) noexcept; // move assignment
 
 #ifdef WLED_DEBUG
-    size_t getSize() const { return sizeof(Segment) + (data?_dataLen:0) + (name?strlen(name):0) + (_t?sizeof(Transition):0); }
+    size_t getSize() const { return sizeof(Segment) + sizeof(segment_perf_t) + (data?_dataLen:0) + (name?strlen(name):0) + (_t?sizeof(Transition):0) + (pixels?_pixelsLen*sizeof(uint32_t):0) + (_map?(_pixelsLen+1+_map[_pixelsLen])*sizeof(uint16_t):0) + (_m12?(4+_m12[2]+_m12[3+_m12[2]])*sizeof(uint32_t):0); }
 #endif
 
     inline bool     getOption(uint8_t n) const { return ((options >> n) & 0x01); }
@@ -523,13 +630,18 @@ typedef struct Segment {
     inline uint16_t length(void)         const { return width() * height(); }               // segment length (count) in physical pixels
     inline uint16_t groupLength(void)    const { return grouping + spacing; }
     inline uint8_t  getLightCapabilities(void) const { return _capabilities; }
+    inline segment_perf_t       &perf(void)       { return _perfPool[_perfSlot]; } // timing counters, reset with the effect (see WS2812FX::service() and show())
+    inline const segment_perf_t &perf(void) const { return _perfPool[_perfSlot]; }
 
-    static uint16_t getUsedSegmentData(void)    { return _usedSegmentData; }
-    static void     addUsedSegmentData(int len) { _usedSegmentData += len; }
+    static uint16_t getUsedSegmentData(void)    { return _arena.getUsed(); }
+    static const SegmentArena &getDataArena(void) { return _arena; }
+    static void     invalidateMappings(void)    { _mapGeneration++; } // forces rebuild of index tables (safe to call from network requests)
     #ifndef WLED_DISABLE_MODE_BLEND
     static void     modeBlend(bool blend)       { _modeBlend = blend; }
+    inline bool     isModeBlending() const      { return isInTransition() && _t->_segT._pixelsT && _t->_modeT != mode; } // previous effect renders into its own buffer
     #endif
     static void     handleRandomPalette();
+    static bool     compactData(Segment *segs, size_t count); // closes holes in the data arena, only while no effect runs
 
     void    setUp(uint16_t i1, uint16_t i2, uint8_t grp=1, uint8_t spc=0, uint16_t ofs=UINT16_MAX, uint16_t i1Y=0, uint16_t i2Y=1, uint8_t segId = 255);
     bool    setColor(uint8_t slot, uint32_t c); //returns true if changed
@@ -554,6 +666,14 @@ typedef struct Segment {
       */
     inline void markForReset(void) { reset = true; }  // setOption(SEG_OPTION_RESET, true)
 
+    // pixel buffer functions
+    bool allocatePixelBuffer(void);   // (re)allocates pixels[] to match virtual dimensions (content is lost on resize)
+    void deallocatePixelBuffer(void);
+    bool buildMapping(void);          // (re)builds logical to physical index table if geometry changed
+    void deallocateMapping(void);
+    bool build1D2DMap(void);          // (re)builds expansion table of 1D effects on 2D segments if geometry or map1D2D changed
+    void composite(void);             // copies pixels[] onto the strip (opacity, grouping, spacing, offset, mirror, reverse)
+
     // transition functions
     void     startTransition(uint16_t dur); // transition has to start before actual segment values change
     void     stopTransition(void);
@@ -678,6 +798,21 @@ class WS2812FX {  // 96 bytes
   static WS2812FX* instance;
 
   public:
+    // state of the segment an effect function is running for, one per render task (see RenderPool)
+    // effect functions reach it through SEGMENT, SEGENV, SEGCOLOR(), SEGPALETTE and SEGLEN
+    typedef struct RenderContext {
+      CRGBPalette16 palette;         // palette used for current effect (includes transition)
+      CRGB          paletteLUT[256]; // palette expanded to 256 entries (built on first use in a frame, see Segment::color_from_palette())
+      uint32_t      colors[3];       // colors used for effect (includes transition)
+      uint16_t      virtualLength;
+      uint8_t       segIndex;
+      bool          paletteLUTValid; // paletteLUT matches palette
+      bool          rendering;       // effect function of segIndex is running
+      Segment      *paletteSegment;  // segment palette was resolved for (only while rendering)
+      uint32_t     *scratch;         // line buffer of 2D helpers (see Segment::moveX()), grows to the longest line used
+      size_t        scratchLen;
+    } render_ctx_t;
+
 
     WS2812FX() :
       paletteFade(0),
@@ -692,27 +827,37 @@ class WS2812FX {  // 96 bytes
 #ifndef WLED_DISABLE_2D
       panels(1),
 #endif
-      // semi-private (just obscured) used in effect functions through macros
-      _currentPalette(CRGBPalette16(CRGB::Black)),
-      _colors_t{0,0,0},
-      _virtualSegmentLength(0),
       // true private variables
       _length(DEFAULT_LED_COUNT),
       _brightness(DEFAULT_BRIGHTNESS),
       _transitionDur(750),
       _targetFps(WLED_FPS),
       _frametime(FRAMETIME_FIXED),
-      _cumulativeFps(2),
+      _renderBudget(0),
       _isServicing(false),
       _isOffRefreshRequired(false),
       _hasWhiteChannel(false),
       _triggered(false),
+      _framePending(false),
       _modeCount(MODE_COUNT),
       _callback(nullptr),
+      _pixels(nullptr),
+      _pixelCCT(nullptr),
       customMappingTable(nullptr),
       customMappingSize(0),
       _lastShow(0),
-      _segment_index(0),
+      _showPerf(),
+      _latencyPerf(),
+      _frameStart(0),
+      _framesDeferred(0),
+      _frameIndex(0),
+      _framesDropped(0),
+      _lastPushUs(0),
+      _frameIntervals{0},
+      _frameIntervalIdx(0),
+      _frameIntervalCount(0),
+      _renderCount(0),
+      _renderNow(0),
       _mainSegment(0),
       _queuedChangesSegId(255),
       _qStart(0),
@@ -732,6 +877,8 @@ class WS2812FX {  // 96 bytes
 
     ~WS2812FX() {
       if (customMappingTable) delete[] customMappingTable;
+      if (_pixels) free(_pixels);
+      if (_pixelCCT) free(_pixelCCT);
       _mode.clear();
       _modeData.clear();
       _segments.clear();
@@ -764,10 +911,12 @@ class WS2812FX {  // 96 bytes
       fixInvalidSegments(),
       setPixelColor(int n, uint32_t c),
       show(void),
+      handleOutput(void),
       setTargetFps(uint8_t fps);
 
     void setColor(uint8_t slot, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) { setColor(slot, RGBW32(r,g,b,w)); }
     void fill(uint32_t c) { for (int i = 0; i < getLengthTotal(); i++) setPixelColor(i, c); } // fill whole strip with color (inline)
+    void setPixels(uint16_t i, const uint32_t *c, uint16_t count); // contiguous run of pixels (realtime data)
     void addEffect(uint8_t id, mode_ptr mode_fn, const char *mode_name); // add effect to the list; defined in FX.cpp
     void setupEffectData(void); // add default effects to the list; defined in FX.cpp
 
@@ -785,6 +934,7 @@ class WS2812FX {  // 96 bytes
       hasCCTBus(void),
       // return true if the strip is being sent pixel updates
       isUpdating(void),
+      isSegmentRendering(uint8_t segId), // effect function of the segment is running on any render task
       deserializeMap(uint8_t n=0);
 
     inline bool isServicing(void) { return _isServicing; }
@@ -805,7 +955,7 @@ class WS2812FX {  // 96 bytes
     inline uint8_t getBrightness(void) { return _brightness; }
     inline uint8_t getMaxSegments(void) { return MAX_NUM_SEGMENTS; }  // returns maximum number of supported segments (fixed value)
     inline uint8_t getSegmentsNum(void) { return _segments.size(); }  // returns currently present segments
-    inline uint8_t getCurrSegmentId(void) { return _segment_index; }
+    inline uint8_t getCurrSegmentId(void) { return _ctx->segIndex; }
     inline uint8_t getMainSegmentId(void) { return _mainSegment; }
     inline uint8_t getPaletteCount() { return 13 + GRADIENT_PALETTE_COUNT; }  // will only return built-in palette count
     inline uint8_t getTargetFps() { return _targetFps; }
@@ -819,8 +969,11 @@ class WS2812FX {  // 96 bytes
       getFps();
 
     inline uint16_t getFrameTime(void) { return _frametime; }
+    inline uint32_t getRenderBudget(void) { return _renderBudget; }
+    inline void     setRenderBudget(uint32_t us) { _renderBudget = us; } // 0 = one frame period, RENDER_BUDGET_UNLIMITED renders all due segments
     inline uint16_t getMinShowDelay(void) { return MIN_SHOW_DELAY; }
     inline uint16_t getLength(void) { return _length; } // 2D matrix may have less pixels than W*H
+    inline uint16_t getMappedPixelIndex(uint16_t index) { return index < customMappingSize ? customMappingTable[index] : index; } // apply ledmap
     inline uint16_t getTransition(void) { return _transitionDur; }
 
     uint32_t
@@ -829,7 +982,12 @@ class WS2812FX {  // 96 bytes
       getPixelColor(uint16_t);
 
     inline uint32_t getLastShow(void) { return _lastShow; }
-    inline uint32_t segColor(uint8_t i) { return _colors_t[i]; }
+    inline const perf_stat_t& getShowPerf(void) { return _showPerf; }
+    inline const perf_stat_t& getLatencyPerf(void) { return _latencyPerf; }
+    inline uint32_t getFramesDeferred(void) { return _framesDeferred; }
+    inline uint32_t getFramesDropped(void) { return _framesDropped; }
+    uint32_t getFrameJitter(uint8_t percentile); // deviation of frame intervals from the frame time (µs)
+    inline uint32_t segColor(uint8_t i) { return _ctx->colors[i]; }
 
     const char *
       getModeData(uint8_t id = 0) { return (id && id<_modeCount) ? _modeData[id] : PSTR("Solid"); }
@@ -888,13 +1046,10 @@ class WS2812FX {  // 96 bytes
   // end 2D support
 
     void loadCustomPalettes(void); // loads custom palettes from JSON
-    CRGBPalette16 _currentPalette; // palette used for current effect (includes transition)
     std::vector<CRGBPalette16> customPalettes; // TODO: move custom palettes out of WS2812FX class
 
-    // using public variables to reduce code size increase due to inline function getSegment() (with bounds checking)
-    // and color transitions
-    uint32_t _colors_t[3]; // color used for effect (includes transition)
-    uint16_t _virtualSegmentLength;
+    // render context of the calling task, public to reduce code size of the effect macros
+    static WLED_RENDER_TLS render_ctx_t *_ctx;
 
     std::vector<segment> _segments;
     friend class Segment;
@@ -906,7 +1061,7 @@ class WS2812FX {  // 96 bytes
 
     uint8_t  _targetFps;
     uint16_t _frametime;
-    uint16_t _cumulativeFps;
+    uint32_t _renderBudget;   // effect time (µs, per render task) a frame may take before due segments are deferred
 
     // will require only 1 byte
     struct {
@@ -914,6 +1069,7 @@ class WS2812FX {  // 96 bytes
       bool _isOffRefreshRequired : 1; //periodic refresh is required for the strip to remain off.
       bool _hasWhiteChannel      : 1;
       bool _triggered            : 1;
+      bool _framePending         : 1; // complete frame in _pixels waits for the buses to become free
     };
 
     uint8_t                  _modeCount;
@@ -922,12 +1078,28 @@ class WS2812FX {  // 96 bytes
 
     show_callback _callback;
 
+    uint32_t* _pixels;        // physical frame buffer (_length pixels), pushed to buses by the output stage (handleOutput())
+    uint8_t*  _pixelCCT;      // CCT of the segment each physical pixel belongs to
+
     uint16_t* customMappingTable;
     uint16_t  customMappingSize;
 
     unsigned long _lastShow;
-
-    uint8_t _segment_index;
+    perf_stat_t   _showPerf;  // pushing the frame to the buses (per frame)
+    perf_stat_t   _latencyPerf; // from start of rendering until the frame is sent
+    uint32_t      _frameStart;  // micros() rendering of the frame in _pixels started
+    uint32_t      _framesDeferred; // frames that had to wait for the buses
+    uint64_t      _frameIndex;     // grid slot of the last frame (synchronized time / frame time), 0 = none yet
+    uint32_t      _framesDropped;  // grid slots skipped because the previous frame was late (rendering or buses)
+    uint64_t      _lastPushUs;     // frame clock when the last frame was sent
+    uint32_t      _frameIntervals[FRAME_JITTER_SAMPLES]; // µs between the last frames sent (ring buffer)
+    uint8_t       _frameIntervalIdx;
+    uint8_t       _frameIntervalCount;
+
+    static render_ctx_t _renderCtx[1 + WLED_RENDER_TASKS]; // [0] is used by the loop task (and outside of service())
+    uint8_t       _renderQueue[MAX_NUM_SEGMENTS]; // segments due in the current service() call, earliest deadline first
+    uint8_t       _renderCount;
+    unsigned long _renderNow;                     // millis() of the frame rendered in the current service() call (grid slot)
     uint8_t _mainSegment;
     uint8_t _queuedChangesSegId;
     uint16_t _qStart, _qStop, _qStartY, _qStopY;
@@ -938,7 +1110,16 @@ class WS2812FX {  // 96 bytes
       estimateCurrentAndLimitBri(void);
 
     void
+      prepareBusOutput(void),
+      pushPixels(bool segCCT),
+      pushFrame(void);
+
+    void
+      expandCurrentPalette(void),
+      renderSegment(uint8_t id, unsigned worker),
       setUpSegmentFromQueuedChanges(void);
+
+    static void renderJob(unsigned job, unsigned worker, void *arg);
 };
 
 extern const char JSON_mode_names[];
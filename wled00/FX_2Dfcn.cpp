@@ -35,6 +35,7 @@
 // but ledmap takes care of that. ledmap is constructed upon initialization
 // so matrix should disable regular ledmap processing
 void WS2812FX::setUpMatrix() {
+  Segment::invalidateMappings(); // matrix dimensions or panel layout may have changed
 #ifndef WLED_DISABLE_2D
   // erase old ledmap, just in case.
   if (customMappingTable != nullptr) delete[] customMappingTable;
@@ -173,51 +174,47 @@ uint16_t IRAM_ATTR Segment::XY(uint16_t x, uint16_t y)
 void IRAM_ATTR Segment::setPixelColorXY(int x, int y, uint32_t col)
 {
   if (!isActive()) return; // not active
-  if (x >= virtualWidth() || y >= virtualHeight() || x<0 || y<0) return;  // if pixel would fall out of virtual segment just exit
-
-  uint8_t _bri_t = currentBri();
-  if (_bri_t < 255) {
-    byte r = scale8(R(col), _bri_t);
-    byte g = scale8(G(col), _bri_t);
-    byte b = scale8(B(col), _bri_t);
-    byte w = scale8(W(col), _bri_t);
-    col = RGBW32(r, g, b, w);
-  }
+  const int vW = virtualWidth();
+  if (x >= vW || y >= virtualHeight() || x<0 || y<0) return;  // if pixel would fall out of virtual segment just exit
+  const unsigned i = x + y * vW;
+  if (i >= _pixelsLen) return; // pixel buffer not (yet) allocated or stale
+  pixels[i] = col;
+}
 
+// expand logical pixel to physical pixel indices (see Segment::mapPixel())
+unsigned Segment::mapPixelXY(int x, int y, uint16_t *tgt) const
+{
   if (reverse  ) x = virtualWidth()  - x - 1;
   if (reverse_y) y = virtualHeight() - y - 1;
   if (transpose) { uint16_t t = x; x = y; y = t; } // swap X & Y if segment transposed
 
   x *= groupLength(); // expand to physical pixels
   y *= groupLength(); // expand to physical pixels
-  if (x >= width() || y >= height()) return;  // if pixel would fall out of segment just exit
+  if (x >= width() || y >= height()) return 0;  // if pixel would fall out of segment just exit
 
-  uint32_t tmpCol = col;
+  unsigned n = 0;
+  auto add = [&](unsigned pX, unsigned pY) { if (tgt) tgt[n] = pY * Segment::maxWidth + pX; n++; };
   for (int j = 0; j < grouping; j++) {   // groupping vertically
     for (int g = 0; g < grouping; g++) { // groupping horizontally
       uint16_t xX = (x+g), yY = (y+j);
       if (xX >= width() || yY >= height()) continue; // we have reached one dimension's end
 
-#ifndef WLED_DISABLE_MODE_BLEND
-      // if blending modes, blend with underlying pixel
-      if (_modeBlend) tmpCol = color_blend(strip.getPixelColorXY(start + xX, startY + yY), col, 0xFFFFU - progress(), true);
-#endif
-
-      strip.setPixelColorXY(start + xX, startY + yY, tmpCol);
+      add(start + xX, startY + yY);
 
       if (mirror) { //set the corresponding horizontally mirrored pixel
-        if (transpose) strip.setPixelColorXY(start + xX, startY + height() - yY - 1, tmpCol);
-        else           strip.setPixelColorXY(start + width() - xX - 1, startY + yY, tmpCol);
+        if (transpose) add(start + xX, startY + height() - yY - 1);
+        else           add(start + width() - xX - 1, startY + yY);
       }
       if (mirror_y) { //set the corresponding vertically mirrored pixel
-        if (transpose) strip.setPixelColorXY(start + width() - xX - 1, startY + yY, tmpCol);
-        else           strip.setPixelColorXY(start + xX, startY + height() - yY - 1, tmpCol);
+        if (transpose) add(start + width() - xX - 1, startY + yY);
+        else           add(start + xX, startY + height() - yY - 1);
       }
       if (mirror_y && mirror) { //set the corresponding vertically AND horizontally mirrored pixel
-        strip.setPixelColorXY(width() - xX - 1, height() - yY - 1, tmpCol);
+        add(start + width() - xX - 1, startY + height() - yY - 1);
       }
     }
   }
+  return n;
 }
 
 // anti-aliased version of setPixelColorXY()
@@ -267,14 +264,11 @@ void Segment::setPixelColorXY(float x, float y, uint32_t col, bool aa)
 // returns RGBW values of pixel
 uint32_t Segment::getPixelColorXY(uint16_t x, uint16_t y) {
   if (!isActive()) return 0; // not active
-  if (x >= virtualWidth() || y >= virtualHeight() || x<0 || y<0) return 0;  // if pixel would fall out of virtual segment just exit
-  if (reverse  ) x = virtualWidth()  - x - 1;
-  if (reverse_y) y = virtualHeight() - y - 1;
-  if (transpose) { uint16_t t = x; x = y; y = t; } // swap X & Y if segment transposed
-  x *= groupLength(); // expand to physical pixels
-  y *= groupLength(); // expand to physical pixels
-  if (x >= width() || y >= height()) return 0;
-  return strip.getPixelColorXY(start + x, startY + y);
+  const unsigned vW = virtualWidth();
+  if (x >= vW || y >= virtualHeight()) return 0;  // if pixel would fall out of virtual segment just exit
+  const unsigned i = x + y * vW;
+  if (i >= _pixelsLen) return 0;
+  return pixels[i];
 }
 
 // Blends the specified color with the existing pixel color.
@@ -294,94 +288,72 @@ void Segment::fadePixelColorXY(uint16_t x, uint16_t y, uint8_t fade) {
   setPixelColorXY(x, y, color_fade(getPixelColorXY(x,y), fade, true));
 }
 
+// line buffer of the render task the effect runs on, nullptr if out of memory
+static uint32_t *scratchLine(size_t len) {
+  WS2812FX::render_ctx_t *ctx = WS2812FX::_ctx;
+  if (ctx->scratchLen < len) {
+    uint32_t *p = (uint32_t*) realloc(ctx->scratch, len * sizeof(uint32_t));
+    if (!p) { DEBUG_PRINTLN(F("!!! Scratch line allocation failed. !!!")); return nullptr; }
+    ctx->scratch = p;
+    ctx->scratchLen = len;
+  }
+  return ctx->scratch;
+}
+
+// blur a line of pixels in place with CRGB semantics: the white channel is dropped
+// (the last pixel keeps it if its color did not change)
+static void blurLine(uint32_t *line, unsigned len, fract8 blur_amount) {
+  const uint32_t last = line[len-1];
+  for (unsigned i = 0; i < len; i++) line[i] &= 0x00FFFFFF;
+  color_blur_buf(line, len, blur_amount);
+  if (line[len-1] == (last & 0x00FFFFFF)) line[len-1] = last;
+}
+
 // blurRow: perform a blur on a row of a rectangular matrix
 void Segment::blurRow(uint16_t row, fract8 blur_amount) {
   if (!isActive() || blur_amount == 0) return; // not active
-  const uint_fast16_t cols = virtualWidth();
-  const uint_fast16_t rows = virtualHeight();
-
-  if (row >= rows) return;
-  // blur one row
-  uint8_t keep = 255 - blur_amount;
-  uint8_t seep = blur_amount >> 1;
-  CRGB carryover = CRGB::Black;
-  for (unsigned x = 0; x < cols; x++) {
-    CRGB cur = getPixelColorXY(x, row);
-    CRGB before = cur;     // remember color before blur
-    CRGB part = cur;
-    part.nscale8(seep);
-    cur.nscale8(keep);
-    cur += carryover;
-    if (x>0) {
-      CRGB prev = CRGB(getPixelColorXY(x-1, row)) + part;
-      setPixelColorXY(x-1, row, prev);
-    }
-    if (before != cur)         // optimization: only set pixel if color has changed
-      setPixelColorXY(x, row, cur);
-    carryover = part;
-  }
+  const unsigned cols = virtualWidth();
+  const unsigned rows = virtualHeight();
+
+  if (row >= rows || !pixels || _pixelsLen < cols*rows) return;
+  blurLine(pixels + row*cols, cols, blur_amount);
 }
 
 // blurCol: perform a blur on a column of a rectangular matrix
 void Segment::blurCol(uint16_t col, fract8 blur_amount) {
   if (!isActive() || blur_amount == 0) return; // not active
-  const uint_fast16_t cols = virtualWidth();
-  const uint_fast16_t rows = virtualHeight();
-
-  if (col >= cols) return;
-  // blur one column
-  uint8_t keep = 255 - blur_amount;
-  uint8_t seep = blur_amount >> 1;
-  CRGB carryover = CRGB::Black;
-  for (unsigned y = 0; y < rows; y++) {
-    CRGB cur = getPixelColorXY(col, y);
-    CRGB part = cur;
-    CRGB before = cur;     // remember color before blur
-    part.nscale8(seep);
-    cur.nscale8(keep);
-    cur += carryover;
-    if (y>0) {
-      CRGB prev = CRGB(getPixelColorXY(col, y-1)) + part;
-      setPixelColorXY(col, y-1, prev);
-    }
-    if (before != cur)         // optimization: only set pixel if color has changed
-      setPixelColorXY(col, y, cur);
-    carryover = part;
-  }
+  const unsigned cols = virtualWidth();
+  const unsigned rows = virtualHeight();
+
+  if (col >= cols || !pixels || _pixelsLen < cols*rows) return;
+  uint32_t *line = scratchLine(rows); // blur a contiguous copy of the column
+  if (!line) return;
+  for (unsigned y = 0; y < rows; y++) line[y] = pixels[col + y*cols];
+  blurLine(line, rows, blur_amount);
+  for (unsigned y = 0; y < rows; y++) pixels[col + y*cols] = line[y];
 }
 
 // 1D Box blur (with added weight - blur_amount: [0=no blur, 255=max blur])
 void Segment::box_blur(uint16_t i, bool vertical, fract8 blur_amount) {
   if (!isActive() || blur_amount == 0) return; // not active
-  const uint16_t cols = virtualWidth();
-  const uint16_t rows = virtualHeight();
-  const uint16_t dim1 = vertical ? rows : cols;
-  const uint16_t dim2 = vertical ? cols : rows;
-  if (i >= dim2) return;
-  const float seep = blur_amount/255.f;
-  const float keep = 3.f - 2.f*seep;
-  // 1D box blur
-  CRGB tmp[dim1];
-  for (int j = 0; j < dim1; j++) {
-    uint16_t x = vertical ? i : j;
-    uint16_t y = vertical ? j : i;
-    int16_t xp = vertical ? x : x-1;  // "signed" to prevent underflow
-    int16_t yp = vertical ? y-1 : y;  // "signed" to prevent underflow
-    uint16_t xn = vertical ? x : x+1;
-    uint16_t yn = vertical ? y+1 : y;
-    CRGB curr = getPixelColorXY(x,y);
-    CRGB prev = (xp<0 || yp<0) ? CRGB::Black : getPixelColorXY(xp,yp);
-    CRGB next = ((vertical && yn>=dim1) || (!vertical && xn>=dim1)) ? CRGB::Black : getPixelColorXY(xn,yn);
-    uint16_t r, g, b;
-    r = (curr.r*keep + (prev.r + next.r)*seep) / 3;
-    g = (curr.g*keep + (prev.g + next.g)*seep) / 3;
-    b = (curr.b*keep + (prev.b + next.b)*seep) / 3;
-    tmp[j] = CRGB(r,g,b);
-  }
-  for (int j = 0; j < dim1; j++) {
-    uint16_t x = vertical ? i : j;
-    uint16_t y = vertical ? j : i;
-    setPixelColorXY(x, y, tmp[j]);
+  const unsigned cols = virtualWidth();
+  const unsigned rows = virtualHeight();
+  const unsigned dim1 = vertical ? rows : cols;
+  const unsigned dim2 = vertical ? cols : rows;
+  if (i >= dim2 || !pixels || _pixelsLen < cols*rows) return;
+  const unsigned stride = vertical ? cols : 1;
+  uint32_t *line = pixels + (vertical ? i : i*cols);
+  // (curr*keep + (prev+next)*seep) / 3 with seep = blur_amount/255 and keep = 3 - 2*seep, in integers
+  const unsigned seep = blur_amount;
+  const unsigned keep = 3*255 - 2*seep;
+  uint32_t prev = BLACK; // unblurred color of the previous pixel
+  for (unsigned j = 0; j < dim1; j++) {
+    const uint32_t curr = line[j*stride];
+    const uint32_t next = j+1 < dim1 ? line[(j+1)*stride] : BLACK;
+    line[j*stride] = RGBW32((R(curr)*keep + (R(prev) + R(next))*seep) / (3*255),
+                            (G(curr)*keep + (G(prev) + G(next))*seep) / (3*255),
+                            (B(curr)*keep + (B(prev) + B(next))*seep) / (3*255), 0);
+    prev = curr;
   }
 }
 
@@ -406,37 +378,46 @@ void Segment::blur1d(fract8 blur_amount) {
 
 void Segment::moveX(int8_t delta, bool wrap) {
   if (!isActive()) return; // not active
-  const uint16_t cols = virtualWidth();
-  const uint16_t rows = virtualHeight();
-  if (!delta || abs(delta) >= cols) return;
-  uint32_t newPxCol[cols];
-  for (int y = 0; y < rows; y++) {
+  const unsigned cols = virtualWidth();
+  const unsigned rows = virtualHeight();
+  const unsigned d = abs(delta);
+  if (!delta || d >= cols || !pixels || _pixelsLen < cols*rows) return;
+  // pixels moved out on one side are kept (wrap) or stay where they are
+  uint32_t *wrapped = wrap ? scratchLine(d) : nullptr;
+  if (wrap && !wrapped) return;
+  for (unsigned y = 0; y < rows; y++) {
+    uint32_t *row = pixels + y*cols;
     if (delta > 0) {
-      for (int x = 0; x < cols-delta; x++)    newPxCol[x] = getPixelColorXY((x + delta), y);
-      for (int x = cols-delta; x < cols; x++) newPxCol[x] = getPixelColorXY(wrap ? (x + delta) - cols : x, y);
+      if (wrap) memcpy(wrapped, row, d * sizeof(uint32_t));
+      memmove(row, row + d, (cols-d) * sizeof(uint32_t));
+      if (wrap) memcpy(row + cols-d, wrapped, d * sizeof(uint32_t));
     } else {
-      for (int x = cols-1; x >= -delta; x--) newPxCol[x] = getPixelColorXY((x + delta), y);
-      for (int x = -delta-1; x >= 0; x--)    newPxCol[x] = getPixelColorXY(wrap ? (x + delta) + cols : x, y);
+      if (wrap) memcpy(wrapped, row + cols-d, d * sizeof(uint32_t));
+      memmove(row + d, row, (cols-d) * sizeof(uint32_t));
+      if (wrap) memcpy(row, wrapped, d * sizeof(uint32_t));
     }
-    for (int x = 0; x < cols; x++) setPixelColorXY(x, y, newPxCol[x]);
   }
 }
 
 void Segment::moveY(int8_t delta, bool wrap) {
   if (!isActive()) return; // not active
-  const uint16_t cols = virtualWidth();
-  const uint16_t rows = virtualHeight();
-  if (!delta || abs(delta) >= rows) return;
-  uint32_t newPxCol[rows];
-  for (int x = 0; x < cols; x++) {
-    if (delta > 0) {
-      for (int y = 0; y < rows-delta; y++)    newPxCol[y] = getPixelColorXY(x, (y + delta));
-      for (int y = rows-delta; y < rows; y++) newPxCol[y] = getPixelColorXY(x, wrap ? (y + delta) - rows : y);
-    } else {
-      for (int y = rows-1; y >= -delta; y--) newPxCol[y] = getPixelColorXY(x, (y + delta));
-      for (int y = -delta-1; y >= 0; y--)    newPxCol[y] = getPixelColorXY(x, wrap ? (y + delta) + rows : y);
-    }
-    for (int y = 0; y < rows; y++) setPixelColorXY(x, y, newPxCol[y]);
+  const unsigned cols = virtualWidth();
+  const unsigned rows = virtualHeight();
+  const unsigned d = abs(delta);
+  if (!delta || d >= rows || !pixels || _pixelsLen < cols*rows) return;
+  // rows are contiguous: move the whole block at once
+  const size_t moved = (rows-d) * cols * sizeof(uint32_t);
+  const size_t kept  = d * cols * sizeof(uint32_t);
+  uint32_t *wrapped = wrap ? scratchLine(d*cols) : nullptr;
+  if (wrap && !wrapped) return;
+  if (delta > 0) {
+    if (wrap) memcpy(wrapped, pixels, kept);
+    memmove(pixels, pixels + d*cols, moved);
+    if (wrap) memcpy(pixels + (rows-d)*cols, wrapped, kept);
+  } else {
+    if (wrap) memcpy(wrapped, pixels + (rows-d)*cols, kept);
+    memmove(pixels + d*cols, pixels, moved);
+    if (wrap) memcpy(pixels, wrapped, kept);
   }
 }
 
@@ -497,13 +478,11 @@ void Segment::fill_circle(uint16_t cx, uint16_t cy, uint8_t radius, CRGB col) {
   }
 }
 
+// CRGB::nscale8() on every pixel (white channel is cleared)
 void Segment::nscale8(uint8_t scale) {
-  if (!isActive()) return; // not active
-  const uint16_t cols = virtualWidth();
-  const uint16_t rows = virtualHeight();
-  for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) {
-    setPixelColorXY(x, y, CRGB(getPixelColorXY(x, y)).nscale8(scale));
-  }
+  if (!isActive() || !pixels) return; // not active
+  for (unsigned i = 0; i < _pixelsLen; i++) pixels[i] &= 0x00FFFFFF;
+  color_fade_buf(pixels, _pixelsLen, scale);
 }
 
 //line function
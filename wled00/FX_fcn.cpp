@@ -26,6 +26,11 @@
 #include "wled.h"
 #include "FX.h"
 #include "palettes.h"
+#ifdef WLED_NATIVE
+  #include <mutex>
+#elif defined(ARDUINO_ARCH_ESP32)
+  #include <freertos/semphr.h>
+#endif
 
 /*
   Custom per-LED mapping has moved!
@@ -73,7 +78,27 @@
 ///////////////////////////////////////////////////////////////////////////////
 // Segment class implementation
 ///////////////////////////////////////////////////////////////////////////////
-uint16_t Segment::_usedSegmentData = 0U; // amount of RAM all segments use for their data[]
+// runtime data of all segments (data[]) and their transition copies, taken from the heap as needed (see segment_arena.h)
+#define SEGMENT_ARENA_HANDLES (2*MAX_NUM_SEGMENTS + 8) // data and transition copy of each segment, temporary segment copies
+static uint16_t segmentArenaSlots[SEGMENT_ARENA_HANDLES + 1];
+SegmentArena Segment::_arena(MAX_SEGMENT_DATA + SEGMENT_ARENA_HANDLES*SegmentArena::HEADER, segmentArenaSlots, SEGMENT_ARENA_HANDLES);
+
+// the arena is used by effects on the render tasks and by segment copies on other tasks (web server); blocks are
+// copied and moved (compaction, resizing) while it is locked, which is too long for the render pool's spinlock
+#if defined(WLED_NATIVE)
+static std::mutex        arenaMutex;
+static inline void lockData()   { arenaMutex.lock(); }
+static inline void unlockData() { arenaMutex.unlock(); }
+#elif defined(ARDUINO_ARCH_ESP32)
+static SemaphoreHandle_t arenaMutex = xSemaphoreCreateMutex();
+static inline void lockData()   { xSemaphoreTake(arenaMutex, portMAX_DELAY); }
+static inline void unlockData() { xSemaphoreGive(arenaMutex); }
+#else
+static inline void lockData()   {} // ESP8266: single task
+static inline void unlockData() {}
+#endif
+segment_perf_t Segment::_perfPool[SEGMENT_PERF_SLOTS+1];
+bool Segment::_perfUsed[SEGMENT_PERF_SLOTS] = {false};
 uint16_t Segment::maxWidth = DEFAULT_LED_COUNT;
 uint16_t Segment::maxHeight = 1;
 
@@ -82,19 +107,32 @@ CRGBPalette16 Segment::_newRandomPalette = CRGBPalette16(DEFAULT_COLOR);
 unsigned long Segment::_lastPaletteChange = 0; // perhaps it should be per segment
 
 #ifndef WLED_DISABLE_MODE_BLEND
-bool Segment::_modeBlend = false;
+WLED_RENDER_TLS bool Segment::_modeBlend = false;
 #endif
+uint8_t Segment::_mapGeneration = 0;
 
 // copy constructor
-Segment::Segment(const Segment &orig) {
+Segment::Segment(const Segment &orig) : Segment(orig, false) {}
+
+// copy constructor, settingsOnly copies just what differs() compares (no runtime data, pixel buffer, index tables, name or statistics)
+Segment::Segment(const Segment &orig, bool settingsOnly) {
   //DEBUG_PRINTF("-- Copy segment constructor: %p -> %p\n", &orig, this);
   memcpy((void*)this, (void*)&orig, sizeof(Segment));
   _t = nullptr; // copied segment cannot be in transition
+  _perfSlot = SEGMENT_PERF_SLOTS;
   name = nullptr;
   data = nullptr;
   _dataLen = 0;
+  pixels = nullptr;
+  _pixelsLen = 0;
+  _map = nullptr;
+  _m12 = nullptr;
+  if (settingsOnly) return;
+  _perfSlot = acquirePerfSlot();
+  perf() = orig.perf();
   if (orig.name) { name = new char[strlen(orig.name)+1]; if (name) strcpy(name, orig.name); }
   if (orig.data) { if (allocateData(orig._dataLen)) memcpy(data, orig.data, orig._dataLen); }
+  if (orig.pixels) { if (allocatePixelBuffer()) memcpy(pixels, orig.pixels, min(_pixelsLen, orig._pixelsLen) * sizeof(uint32_t)); }
 }
 
 // move constructor
@@ -102,9 +140,14 @@ Segment::Segment(Segment &&orig) noexcept {
   //DEBUG_PRINTF("-- Move segment constructor: %p -> %p\n", &orig, this);
   memcpy((void*)this, (void*)&orig, sizeof(Segment));
   orig._t   = nullptr; // old segment cannot be in transition any more
+  orig._perfSlot = SEGMENT_PERF_SLOTS; // statistics move along
   orig.name = nullptr;
   orig.data = nullptr;
   orig._dataLen = 0;
+  orig.pixels = nullptr;
+  orig._pixelsLen = 0;
+  orig._map = nullptr;
+  orig._m12 = nullptr;
 }
 
 // copy assignment
@@ -115,14 +158,25 @@ Segment& Segment::operator= (const Segment &orig) {
     if (name) { delete[] name; name = nullptr; }
     stopTransition();
     deallocateData();
+    deallocatePixelBuffer();
+    deallocateMapping();
+    if (_m12) free(_m12);
     // copy source
+    uint8_t slot = _perfSlot;
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
+    _perfSlot = slot;
+    perf() = orig.perf();
     // erase pointers to allocated data
     data = nullptr;
     _dataLen = 0;
+    pixels = nullptr;
+    _pixelsLen = 0;
+    _map = nullptr;
+    _m12 = nullptr;
     // copy source data
     if (orig.name) { name = new char[strlen(orig.name)+1]; if (name) strcpy(name, orig.name); }
     if (orig.data) { if (allocateData(orig._dataLen)) memcpy(data, orig.data, orig._dataLen); }
+    if (orig.pixels) { if (allocatePixelBuffer()) memcpy(pixels, orig.pixels, min(_pixelsLen, orig._pixelsLen) * sizeof(uint32_t)); }
   }
   return *this;
 }
@@ -134,15 +188,58 @@ Segment& Segment::operator= (Segment &&orig) noexcept {
     if (name) { delete[] name; name = nullptr; } // free old name
     stopTransition();
     deallocateData(); // free old runtime data
+    deallocatePixelBuffer();
+    deallocateMapping();
+    if (_m12) free(_m12);
+    releasePerfSlot(_perfSlot);
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
+    orig._perfSlot = SEGMENT_PERF_SLOTS;
     orig.name = nullptr;
     orig.data = nullptr;
     orig._dataLen = 0;
+    orig.pixels = nullptr;
+    orig._pixelsLen = 0;
+    orig._map = nullptr;
+    orig._m12 = nullptr;
     orig._t   = nullptr; // old segment cannot be in transition
   }
   return *this;
 }
 
+void PerfStat::add(uint32_t us) {
+  if (count == UINT16_MAX || sum > UINT32_MAX - us) {
+    // keep recent history only: halve everything (min and max are kept)
+    count >>= 1;
+    sum   >>= 1;
+    for (int i = 0; i < PERF_HIST_SIZE; i++) hist[i] >>= 1;
+    if (sum > UINT32_MAX - us) us = UINT32_MAX - sum; // single sample larger than 35 minutes
+  }
+  if (count == 0 || us < min) min = us;
+  if (us > max) max = us;
+  sum += us;
+  count++;
+  unsigned bucket = us < 64 ? 0 : (32 - __builtin_clz(us) - 5) / 2; // 4x wider per bucket, 1st ends at 64us
+  hist[bucket < PERF_HIST_SIZE ? bucket : PERF_HIST_SIZE-1]++;
+}
+
+// statistics live in a pool outside the segments, which keeps the segments small for iteration in service()
+uint8_t Segment::acquirePerfSlot() {
+  uint8_t slot = 0;
+  renderPool.lock();
+  while (slot < SEGMENT_PERF_SLOTS && _perfUsed[slot]) slot++;
+  if (slot < SEGMENT_PERF_SLOTS) _perfUsed[slot] = true;
+  renderPool.unlock();
+  if (slot < SEGMENT_PERF_SLOTS) memset((void*)&_perfPool[slot], 0, sizeof(segment_perf_t));
+  return slot;
+}
+
+void Segment::releasePerfSlot(uint8_t slot) {
+  if (slot >= SEGMENT_PERF_SLOTS) return;
+  renderPool.lock();
+  _perfUsed[slot] = false;
+  renderPool.unlock();
+}
+
 bool Segment::allocateData(size_t len) {
   if (data && _dataLen >= len) {          // already allocated enough (reduce fragmentation)
     if (call == 0) memset(data, 0, len);  // erase buffer if called during effect initialisation
@@ -151,16 +248,26 @@ bool Segment::allocateData(size_t len) {
   //DEBUG_PRINTF("--   Allocating data (%d): %p\n", len, this);
   deallocateData();
   if (len == 0) return false; // nothing to do
-  if (Segment::getUsedSegmentData() + len > MAX_SEGMENT_DATA) {
+  // effects of other segments may allocate concurrently (render tasks)
+  lockData();
+  data = _arena.alloc(len);
+  bool later = !data && _arena.fitsAfterCompaction(len);
+  unlockData();
+  if (!data) {
+    if (later) {
+      // the arena is compacted or grown before the next frame: start the effect over then
+      #ifndef WLED_DISABLE_MODE_BLEND
+      if (!_modeBlend)
+      #endif
+      markForReset();
+      DEBUG_PRINTLN(F("--- Effect RAM fragmented, retrying."));
+      return false;
+    }
     // not enough memory
     DEBUG_PRINT(F("!!! Effect RAM depleted: "));
     DEBUG_PRINTF("%d/%d !!!\n", len, Segment::getUsedSegmentData());
     return false;
   }
-  // do not use SPI RAM on ESP32 since it is slow
-  data = (byte*) malloc(len);
-  if (!data) { DEBUG_PRINTLN(F("!!! Allocation failed. !!!")); return false; } //allocation failed
-  Segment::addUsedSegmentData(len);
   //DEBUG_PRINTF("---  Allocated data (%p): %d/%d -> %p\n", this, len, Segment::getUsedSegmentData(), data);
   _dataLen = len;
   memset(data, 0, len);
@@ -170,20 +277,112 @@ bool Segment::allocateData(size_t len) {
 void Segment::deallocateData() {
   if (!data) { _dataLen = 0; return; }
   //DEBUG_PRINTF("---  Released data (%p): %d/%d -> %p\n", this, _dataLen, Segment::getUsedSegmentData(), data);
-  if ((Segment::getUsedSegmentData() > 0) && (_dataLen > 0)) { // check that we don't have a dangling / inconsistent data pointer
-    free(data);
-  } else {
+  lockData();
+  bool owned = _arena.owns(data); // check that we don't have a dangling / inconsistent data pointer
+  if (owned) _arena.free(data);
+  unlockData();
+  if (!owned) {
     DEBUG_PRINT(F("---- Released data "));
     DEBUG_PRINTF("(%p): ", this);
-    DEBUG_PRINT(F("inconsistent UsedSegmentData "));
-    DEBUG_PRINTF("(%d/%d)", _dataLen, Segment::getUsedSegmentData());
-    DEBUG_PRINTLN(F(", cowardly refusing to free nothing."));
+    DEBUG_PRINTLN(F("not in effect RAM, cowardly refusing to free it."));
   }
   data = nullptr;
-  Segment::addUsedSegmentData(_dataLen <= Segment::getUsedSegmentData() ? -_dataLen : -Segment::getUsedSegmentData());
   _dataLen = 0;
 }
 
+/*
+ * Closes the holes released effect data left in the arena, resizes it to what the effects need and rebases
+ * the data pointers of all segments (and of their transitions). Must not run while effect functions hold
+ * SEGENV.data, i.e. only between frames. Blocks of segment copies outside of segs (e.g. made on the web task)
+ * cannot be rebased: as long as one exists the arena is left as it is. Everything runs under the lock so copies
+ * do not race with the moving blocks.
+ */
+bool Segment::compactData(Segment *segs, size_t count) {
+  if (!_arena.needsCompaction()) return false;
+  uint8_t handles[2*MAX_NUM_SEGMENTS];
+  if (count > MAX_NUM_SEGMENTS) return false;
+  unsigned tracked = 0;
+  lockData();
+  for (size_t i = 0; i < count; i++) {
+    handles[2*i]   = _arena.handle(segs[i].data);
+    handles[2*i+1] = segs[i]._t ? _arena.handle(segs[i]._t->_segT._dataT) : 0;
+    tracked += (handles[2*i] != 0) + (handles[2*i+1] != 0);
+  }
+  bool compact = tracked == _arena.getBlocks();
+  if (compact && _arena.compact()) {
+    for (size_t i = 0; i < count; i++) {
+      if (handles[2*i])   segs[i].data = _arena.ptr(handles[2*i]);
+      if (handles[2*i+1]) segs[i]._t->_segT._dataT = _arena.ptr(handles[2*i+1]);
+    }
+  }
+  if (!compact) _arena.discardPending();
+  unlockData();
+  return compact;
+}
+
+// (re)allocates logical pixel buffer if segment's virtual dimensions changed
+bool Segment::allocatePixelBuffer() {
+  if (!isActive()) { deallocatePixelBuffer(); return false; }
+  size_t len = is2D() ? virtualWidth() * virtualHeight() : virtualLength();
+  if (pixels && _pixelsLen == len) return true;
+  deallocatePixelBuffer();
+  deallocateMapping(); // index table depends on buffer size
+  if (len == 0) return false;
+  // do not use SPI RAM on ESP32 since it is slow
+  pixels = (uint32_t*) calloc(len, sizeof(uint32_t));
+  if (!pixels) { DEBUG_PRINTLN(F("!!! Pixel buffer allocation failed. !!!")); return false; }
+  _pixelsLen = len;
+  #ifndef WLED_DISABLE_MODE_BLEND
+  if (isInTransition() && _t->_segT._pixelsT) { // previous effect's buffer must match in size
+    free(_t->_segT._pixelsT);
+    _t->_segT._pixelsT = (uint32_t*) calloc(len, sizeof(uint32_t));
+  }
+  #endif
+  return true;
+}
+
+void Segment::deallocatePixelBuffer() {
+  if (pixels) free(pixels);
+  pixels = nullptr;
+  _pixelsLen = 0;
+}
+
+/*
+ * (Re)builds logical to physical index table if segment geometry or strip mapping changed.
+ * Table layout: _pixelsLen+1 offsets followed by the physical (bus) indices of all logical pixels;
+ * physical pixels of logical pixel v are at [_map[v], _map[v+1]) in the second part.
+ */
+bool Segment::buildMapping() {
+  const uint16_t mapOpt = options & SEG_MAPPING_OPTIONS;
+  if (_map && _mapGen == _mapGeneration && _mapOpt == mapOpt) return true;
+  deallocateMapping();
+  if (!pixels) return false;
+  size_t count = 0;
+  for (unsigned v = 0; v < _pixelsLen; v++) count += mapPixel(v, nullptr);
+  if (count > UINT16_MAX) return false;
+  _map = (uint16_t*) malloc((_pixelsLen + 1 + count) * sizeof(uint16_t));
+  if (!_map) { DEBUG_PRINTLN(F("!!! Mapping table allocation failed. !!!")); return false; }
+  uint16_t *phys = _map + _pixelsLen + 1;
+  unsigned n = 0;
+  for (unsigned v = 0; v < _pixelsLen; v++) {
+    _map[v] = n;
+    unsigned k = mapPixel(v, phys + n);
+    for (unsigned j = 0; j < k; j++) {
+      uint16_t index = strip.getMappedPixelIndex(phys[n + j]); // apply ledmap
+      if (index < strip.getLength()) phys[n++] = index;         // drop nonexistent pixels
+    }
+  }
+  _map[_pixelsLen] = n;
+  _mapOpt = mapOpt;
+  _mapGen = _mapGeneration;
+  return true;
+}
+
+void Segment::deallocateMapping() {
+  if (_map) free(_map);
+  _map = nullptr;
+}
+
 /**
   * If reset of this segment was requested, clears runtime
   * settings of this segment.
@@ -196,6 +395,8 @@ void Segment::resetIfRequired() {
   //DEBUG_PRINTF("-- Segment reset: %p\n", this);
   deallocateData();
   next_time = 0; step = 0; call = 0; aux0 = 0; aux1 = 0;
+  randSeed = random16(); // taken from the loop task, not from the previous effect
+  memset((void*)&perf(), 0, sizeof(segment_perf_t)); // counters describe the current effect only
   reset = false;
 }
 
@@ -219,20 +420,9 @@ CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal) {
   switch (pal) {
     case 0: //default palette. Exceptions for specific effects above
       targetPalette = PartyColors_p; break;
-    case 1: {//periodically replace palette with a random one
-      unsigned long timeSinceLastChange = millis() - _lastPaletteChange;
-      if (timeSinceLastChange > randomPaletteChangeTime * 1000U) {
-        _randomPalette = _newRandomPalette;
-        _newRandomPalette = CRGBPalette16(
-                        CHSV(random8(), random8(160, 255), random8(128, 255)),
-                        CHSV(random8(), random8(160, 255), random8(128, 255)),
-                        CHSV(random8(), random8(160, 255), random8(128, 255)),
-                        CHSV(random8(), random8(160, 255), random8(128, 255)));
-        _lastPaletteChange = millis();
-        handleRandomPalette(); // do a 1st pass of blend
-      }
+    case 1: //periodically replace palette with a random one (see handleRandomPalette())
       targetPalette = _randomPalette;
-      break;}
+      break;
     case 2: {//primary color only
       CRGB prim = gamma32(colors[0]);
       targetPalette = CRGBPalette16(prim); break;}
@@ -274,7 +464,7 @@ CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal) {
         targetPalette = strip.customPalettes[255-pal]; // we checked bounds above
       } else {
         byte tcp[72];
-        memcpy_P(tcp, (byte*)pgm_read_dword(&(gGradientPalettes[pal-13])), 72);
+        memcpy_P(tcp, (byte*)pgm_read_ptr(&(gGradientPalettes[pal-13])), 72);
         targetPalette.loadDynamicGradientPalette(tcp);
       }
       break;
@@ -304,12 +494,20 @@ void Segment::startTransition(uint16_t dur) {
     _t->_segT._dataLenT = 0;
     _t->_segT._dataT    = nullptr;
     if (_dataLen > 0 && data) {
-      _t->_segT._dataT = (byte *)malloc(_dataLen);
+      lockData(); // copy under the lock too, compaction may move both blocks
+      _t->_segT._dataT = _arena.alloc(_dataLen);
       if (_t->_segT._dataT) {
         //DEBUG_PRINTF("--  Allocated duplicate data (%d): %p\n", _dataLen, _t->_segT._dataT);
         memcpy(_t->_segT._dataT, data, _dataLen);
         _t->_segT._dataLenT = _dataLen;
       }
+      unlockData();
+    }
+    // previous effect continues in its own copy of the pixel buffer, both are cross-faded in composite()
+    _t->_segT._pixelsT = nullptr;
+    if (pixels && _pixelsLen > 0) {
+      _t->_segT._pixelsT = (uint32_t*)malloc(_pixelsLen * sizeof(uint32_t));
+      if (_t->_segT._pixelsT) memcpy(_t->_segT._pixelsT, pixels, _pixelsLen * sizeof(uint32_t));
     }
   } else {
     for (size_t i=0; i<NUM_COLORS; i++) _t->_segT._colorT[i] = colors[i];
@@ -325,10 +523,14 @@ void Segment::stopTransition() {
     #ifndef WLED_DISABLE_MODE_BLEND
     if (_t->_segT._dataT && _t->_segT._dataLenT > 0) {
       //DEBUG_PRINTF("--  Released duplicate data (%d): %p\n", _t->_segT._dataLenT, _t->_segT._dataT);
-      free(_t->_segT._dataT);
+      lockData();
+      _arena.free(_t->_segT._dataT);
+      unlockData();
       _t->_segT._dataT = nullptr;
       _t->_segT._dataLenT = 0;
     }
+    if (_t->_segT._pixelsT) free(_t->_segT._pixelsT);
+    _t->_segT._pixelsT = nullptr;
     #endif
     delete _t;
     _t = nullptr;
@@ -368,6 +570,7 @@ void Segment::swapSegenv(tmpsegd_t &tmpSeg) {
   tmpSeg._callT      = call;
   tmpSeg._dataT      = data;
   tmpSeg._dataLenT   = _dataLen;
+  tmpSeg._pixelsT    = pixels;
   if (_t && &tmpSeg != &(_t->_segT)) {
     // swap SEGENV with transitional data
     options   = _t->_segT._optionsT;
@@ -386,6 +589,7 @@ void Segment::swapSegenv(tmpsegd_t &tmpSeg) {
     call      = _t->_segT._callT;
     data      = _t->_segT._dataT;
     _dataLen  = _t->_segT._dataLenT;
+    pixels    = _t->_segT._pixelsT;
   }
   //DEBUG_PRINTF("--   temp seg data: %p (%d,%p)\n", this, _dataLen, data);
 }
@@ -418,6 +622,7 @@ void Segment::restoreSegenv(tmpsegd_t &tmpSeg) {
   call      = tmpSeg._callT;
   data      = tmpSeg._dataT;
   _dataLen  = tmpSeg._dataLenT;
+  pixels    = tmpSeg._pixelsT;
   //DEBUG_PRINTF("--   temp seg data: %p (%d,%p)\n", this, _dataLen, data);
 }
 #endif
@@ -462,10 +667,24 @@ CRGBPalette16 &Segment::currentPalette(CRGBPalette16 &targetPalette, uint8_t pal
   return targetPalette;
 }
 
-// relies on WS2812FX::service() to call it max every 8ms or more (MIN_SHOW_DELAY)
+// relies on WS2812FX::service() to call it once per frame
+// runs on the loop task before effects are rendered so that render tasks only read the random palette
 void Segment::handleRandomPalette() {
+  if (millis() - _lastPaletteChange > randomPaletteChangeTime * 1000U) {
+    bool used = false;
+    for (const segment &seg : strip._segments) used |= seg.isActive() && seg.palette == 1;
+    if (used) {
+      _randomPalette = _newRandomPalette;
+      _newRandomPalette = CRGBPalette16(
+                      CHSV(random8(), random8(160, 255), random8(128, 255)),
+                      CHSV(random8(), random8(160, 255), random8(128, 255)),
+                      CHSV(random8(), random8(160, 255), random8(128, 255)),
+                      CHSV(random8(), random8(160, 255), random8(128, 255)));
+      _lastPaletteChange = millis();
+    }
+  }
   // just do a blend; if the palettes are identical it will just compare 48 bytes (same as _randomPalette == _newRandomPalette)
-  // this will slowly blend _newRandomPalette into _randomPalette every 15ms or 8ms (depending on MIN_SHOW_DELAY)
+  // this will slowly blend _newRandomPalette into _randomPalette every frame
   nblendPaletteTowardPalette(_randomPalette, _newRandomPalette, 48);
 }
 
@@ -482,7 +701,10 @@ void Segment::setUp(uint16_t i1, uint16_t i2, uint8_t grp, uint8_t spc, uint16_t
 
   stateChanged = true; // send UDP/WS broadcast
 
-  if (stop) fill(BLACK); // turn old segment range off (clears pixels if changing spacing)
+  if (stop) { // turn old segment range off (clears pixels if changing spacing)
+    fill(BLACK);
+    for (unsigned y = startY; y < stopY; y++) for (unsigned x = start; x < stop; x++) strip.setPixelColor(x + y * Segment::maxWidth, BLACK);
+  }
   if (grp) { // prevent assignment of 0
     grouping = grp;
     spacing = spc;
@@ -497,6 +719,7 @@ void Segment::setUp(uint16_t i1, uint16_t i2, uint8_t grp, uint8_t spc, uint16_t
   DEBUG_PRINT(F(" -> ")); DEBUG_PRINT(i1Y);
   DEBUG_PRINT(','); DEBUG_PRINTLN(i2Y);
   markForReset();
+  Segment::invalidateMappings();
   if (boundsUnchanged) return;
 
   // apply change immediately
@@ -659,6 +882,92 @@ uint16_t Segment::virtualLength() const {
   return vLength;
 }
 
+#ifndef WLED_DISABLE_2D
+// 2D pixels of 1D pixel i for the expanding map1D2D modes, in drawing order (may hit a pixel more than once or fall outside)
+template<typename F> static void expand1D2D(uint8_t mode, int i, int vW, int vH, F emit) {
+  switch (mode) {
+    case M12_pBar:
+      // expand 1D effect vertically
+      for (int x = 0; x < vW; x++) emit(x, vH - i - 1);
+      break;
+    case M12_pArc:
+      // expand in circular fashion from center
+      if (i == 0) emit(0, 0);
+      else {
+        float step = HALF_PI / (2.85f*i);
+        for (float rad = 0.0f; rad <= HALF_PI+step/2; rad += step) emit(int(roundf(sin_t(rad) * i)), int(roundf(cos_t(rad) * i)));
+      }
+      break;
+    case M12_pCorner:
+      for (int x = 0; x <= i; x++) emit(x, i);
+      for (int y = 0; y <  i; y++) emit(i, y);
+      break;
+  }
+}
+
+/*
+ * (Re)builds the expansion table of 1D effects on 2D segments (bar, arc and corner) on the loop task, so that
+ * setPixelColor()/getPixelColor() do not expand every pixel write again. Runs of pixels[] indices per 1D pixel.
+ * Table layout: vW | vH<<16, map1D2D, vLen, vLen+1 run offsets, then runs: start | length<<16 | vertical<<31
+ * (vertical runs step by vW, others by 1).
+ */
+bool Segment::build1D2DMap() {
+  if (!is2D() || map1D2D == M12_Pixels || map1D2D > M12_pCorner || !pixels) {
+    if (_m12) free(_m12);
+    _m12 = nullptr;
+    return false;
+  }
+  const unsigned vW = virtualWidth(), vH = virtualHeight();
+  if (_m12 && _m12[0] == (vW | (vH << 16)) && _m12[1] == map1D2D) return true;
+  if (_m12) free(_m12);
+  _m12 = nullptr;
+
+  const unsigned vLen = virtualLength();
+  uint32_t *tbl = nullptr;
+  size_t runs = 0;
+  for (int pass = 0; pass < 2; pass++) { // count runs, then store them
+    uint32_t *out = tbl ? tbl + 4 + vLen : nullptr;
+    runs = 0;
+    for (unsigned i = 0; i < vLen; i++) {
+      if (tbl) tbl[3+i] = runs;
+      int start = 0, len = 0, stride = 0;
+      auto close = [&]() {
+        if (!len) return;
+        if (out) out[runs] = start | (len << 16) | (stride > 1 ? 0x80000000U : 0);
+        runs++;
+        len = 0;
+      };
+      expand1D2D(map1D2D, i, vW, vH, [&](int x, int y) {
+        if (x < 0 || y < 0 || x >= (int)vW || y >= (int)vH) return;
+        int p = x + y * vW, last = start + (len - 1) * stride;
+        if (len && p == last) return; // arc hits pixels more than once
+        if (len == 1 && (p == last + 1 || p == last + (int)vW)) stride = p - last;
+        else if (len < 2 || p != last + stride) { close(); start = p; stride = 0; }
+        len++;
+      });
+      close();
+    }
+    if (!tbl) {
+      tbl = (uint32_t*)malloc((4 + vLen + runs) * sizeof(uint32_t));
+      if (!tbl) { DEBUG_PRINTLN(F("!!! 1D2D table allocation failed. !!!")); return false; }
+    }
+  }
+  tbl[0] = vW | (vH << 16);
+  tbl[1] = map1D2D;
+  tbl[2] = vLen;
+  tbl[3+vLen] = runs;
+  _m12 = tbl;
+  return true;
+}
+
+const uint32_t *Segment::m12Runs(unsigned i, unsigned vW, unsigned vH, const uint32_t *&end) const {
+  if (!_m12 || _m12[0] != (vW | (vH << 16)) || _m12[1] != map1D2D || i >= _m12[2] || vW * vH != _pixelsLen) return nullptr;
+  const uint32_t *runs = _m12 + 4 + _m12[2];
+  end = runs + _m12[4+i];
+  return runs + _m12[3+i];
+}
+#endif
+
 void IRAM_ATTR Segment::setPixelColor(int i, uint32_t col)
 {
   if (!isActive()) return; // not active
@@ -671,107 +980,31 @@ void IRAM_ATTR Segment::setPixelColor(int i, uint32_t col)
 
 #ifndef WLED_DISABLE_2D
   if (is2D()) {
-    uint16_t vH = virtualHeight();  // segment height in logical pixels
-    uint16_t vW = virtualWidth();
-    switch (map1D2D) {
-      case M12_Pixels:
-        // use all available pixels as a long strip
-        setPixelColorXY(i % vW, i / vW, col);
-        break;
-      case M12_pBar:
-        // expand 1D effect vertically or have it play on virtual strips
-        if (vStrip>0) setPixelColorXY(vStrip - 1, vH - i - 1, col);
-        else          for (int x = 0; x < vW; x++) setPixelColorXY(x, vH - i - 1, col);
-        break;
-      case M12_pArc:
-        // expand in circular fashion from center
-        if (i==0)
-          setPixelColorXY(0, 0, col);
-        else {
-          float step = HALF_PI / (2.85f*i);
-          for (float rad = 0.0f; rad <= HALF_PI+step/2; rad += step) {
-            // may want to try float version as well (with or without antialiasing)
-            int x = roundf(sin_t(rad) * i);
-            int y = roundf(cos_t(rad) * i);
-            setPixelColorXY(x, y, col);
-          }
-          // Bresenham’s Algorithm (may not fill every pixel)
-          //int d = 3 - (2*i);
-          //int y = i, x = 0;
-          //while (y >= x) {
-          //  setPixelColorXY(x, y, col);
-          //  setPixelColorXY(y, x, col);
-          //  x++;
-          //  if (d > 0) {
-          //    y--;
-          //    d += 4 * (x - y) + 10;
-          //  } else {
-          //    d += 4 * x + 6;
-          //  }
-          //}
-        }
-        break;
-      case M12_pCorner:
-        for (int x = 0; x <= i; x++) setPixelColorXY(x, i, col);
-        for (int y = 0; y <  i; y++) setPixelColorXY(i, y, col);
-        break;
+    const unsigned vH = virtualHeight();  // segment height in logical pixels
+    const unsigned vW = virtualWidth();
+    if (map1D2D == M12_Pixels) { // use all available pixels as a long strip
+      if (i < _pixelsLen) pixels[i] = col;
+      return;
     }
-    return;
-  } else if (Segment::maxHeight!=1 && (width()==1 || height()==1)) {
-    if (start < Segment::maxWidth*Segment::maxHeight) {
-      // we have a vertical or horizontal 1D segment (WARNING: virtual...() may be transposed)
-      int x = 0, y = 0;
-      if (virtualHeight()>1) y = i;
-      if (virtualWidth() >1) x = i;
-      setPixelColorXY(x, y, col);
+    if (map1D2D == M12_pBar && vStrip > 0) { // 1D effect playing on virtual strips
+      setPixelColorXY(vStrip - 1, int(vH) - i - 1, col);
       return;
     }
-  }
-#endif
-
-  uint16_t len = length();
-  uint8_t _bri_t = currentBri();
-  if (_bri_t < 255) {
-    byte r = scale8(R(col), _bri_t);
-    byte g = scale8(G(col), _bri_t);
-    byte b = scale8(B(col), _bri_t);
-    byte w = scale8(W(col), _bri_t);
-    col = RGBW32(r, g, b, w);
-  }
-
-  // expand pixel (taking into account start, grouping, spacing [and offset])
-  i = i * groupLength();
-  if (reverse) { // is segment reversed?
-    if (mirror) { // is segment mirrored?
-      i = (len - 1) / 2 - i;  //only need to index half the pixels
+    const uint32_t *end, *run = m12Runs(i, vW, vH, end);
+    if (run) {
+      for (; run < end; run++) {
+        unsigned p = *run & 0xFFFF, n = (*run >> 16) & 0x7FFF, step = (*run & 0x80000000U) ? vW : 1;
+        for (; n; n--, p += step) pixels[p] = col;
+      }
     } else {
-      i = (len - 1) - i;
+      expand1D2D(map1D2D, i, vW, vH, [&](int x, int y) { setPixelColorXY(x, y, col); }); // table not built yet
     }
+    return;
   }
-  i += start; // starting pixel in a group
-
-  uint32_t tmpCol = col;
-  // set all the pixels in the group
-  for (int j = 0; j < grouping; j++) {
-    uint16_t indexSet = i + ((reverse) ? -j : j);
-    if (indexSet >= start && indexSet < stop) {
-      if (mirror) { //set the corresponding mirrored pixel
-        uint16_t indexMir = stop - indexSet + start - 1;
-        indexMir += offset; // offset/phase
-        if (indexMir >= stop) indexMir -= len; // wrap
-#ifndef WLED_DISABLE_MODE_BLEND
-        if (_modeBlend) tmpCol = color_blend(strip.getPixelColor(indexMir), col, 0xFFFFU - progress(), true);
-#endif
-        strip.setPixelColor(indexMir, tmpCol);
-      }
-      indexSet += offset; // offset/phase
-      if (indexSet >= stop) indexSet -= len; // wrap
-#ifndef WLED_DISABLE_MODE_BLEND
-      if (_modeBlend) tmpCol = color_blend(strip.getPixelColor(indexSet), col, 0xFFFFU - progress(), true);
 #endif
-      strip.setPixelColor(indexSet, tmpCol);
-    }
-  }
+
+  if (i >= _pixelsLen) return; // pixel buffer not (yet) allocated or stale
+  pixels[i] = col;
 }
 
 // anti-aliased normalized version of setPixelColor()
@@ -817,33 +1050,102 @@ uint32_t Segment::getPixelColor(int i)
 
 #ifndef WLED_DISABLE_2D
   if (is2D()) {
-    uint16_t vH = virtualHeight();  // segment height in logical pixels
-    uint16_t vW = virtualWidth();
-    switch (map1D2D) {
-      case M12_Pixels:
-        return getPixelColorXY(i % vW, i / vW);
-        break;
-      case M12_pBar:
-        if (vStrip>0) return getPixelColorXY(vStrip - 1, vH - i -1);
-        else          return getPixelColorXY(0, vH - i -1);
-        break;
-      case M12_pArc:
-      case M12_pCorner:
-        // use longest dimension
-        return vW>vH ? getPixelColorXY(i, 0) : getPixelColorXY(0, i);
-        break;
-    }
-    return 0;
+    const unsigned vH = virtualHeight();  // segment height in logical pixels
+    const unsigned vW = virtualWidth();
+    if (map1D2D == M12_Pixels) return i < _pixelsLen ? pixels[i] : 0;
+    if (map1D2D == M12_pBar && vStrip > 0) return getPixelColorXY(vStrip - 1, vH - i - 1);
+    // first pixel the expansion writes
+    const uint32_t *end, *run = m12Runs(i, vW, vH, end);
+    if (run) return run < end ? pixels[*run & 0xFFFF] : 0;
+    int px = -1, py = -1;
+    expand1D2D(map1D2D, i, vW, vH, [&](int x, int y) { if (px < 0) { px = x; py = y; } });
+    return px < 0 ? 0 : getPixelColorXY(px, py);
+  }
+#endif
+
+  if (i < 0 || i >= _pixelsLen) return 0;
+  return pixels[i];
+}
+
+/*
+ * Expands logical pixel into physical (strip) pixel indices taking into account
+ * start, grouping, spacing, offset, mirroring and reversal. Custom ledmap is not applied.
+ * Returns number of physical pixels; indices are only stored if tgt is not null.
+ */
+unsigned Segment::mapPixel(unsigned v, uint16_t *tgt) const {
+#ifndef WLED_DISABLE_2D
+  if (is2D()) {
+    const unsigned vW = virtualWidth();
+    return mapPixelXY(v % vW, v / vW, tgt);
+  } else if (Segment::maxHeight!=1 && start < Segment::maxWidth*Segment::maxHeight) {
+    // we have a vertical or horizontal 1D segment (WARNING: virtual...() may be transposed)
+    unsigned x = virtualWidth() >1 ? v : 0;
+    unsigned y = virtualHeight()>1 ? v : 0;
+    if (x >= virtualWidth() || y >= virtualHeight()) return 0;
+    return mapPixelXY(x, y, tgt);
   }
 #endif
 
-  if (reverse) i = virtualLength() - i - 1;
-  i *= groupLength();
-  i += start;
-  /* offset/phase */
-  i += offset;
-  if ((i >= stop) && (stop>0)) i -= length(); // avoids negative pixel index (stop = 0 is a possible value)
-  return strip.getPixelColor(i);
+  const int len = length();
+  int i = v * groupLength();
+  if (reverse) { // is segment reversed?
+    if (mirror) { // is segment mirrored?
+      i = (len - 1) / 2 - i;  //only need to index half the pixels
+    } else {
+      i = (len - 1) - i;
+    }
+  }
+  i += start; // starting pixel in a group
+
+  unsigned n = 0;
+  // set all the pixels in the group
+  for (int j = 0; j < grouping; j++) {
+    uint16_t indexSet = i + ((reverse) ? -j : j);
+    if (indexSet >= start && indexSet < stop) {
+      if (mirror) { //set the corresponding mirrored pixel
+        uint16_t indexMir = stop - indexSet + start - 1;
+        indexMir += offset; // offset/phase
+        if (indexMir >= stop) indexMir -= len; // wrap
+        if (tgt) tgt[n] = indexMir;
+        n++;
+      }
+      indexSet += offset; // offset/phase
+      if (indexSet >= stop) indexSet -= len; // wrap
+      if (tgt) tgt[n] = indexSet;
+      n++;
+    }
+  }
+  return n;
+}
+
+/*
+ * Copies logical pixels from pixels[] onto the strip using precomputed index table.
+ * Opacity (incl. on/off transition) is applied here once per logical pixel per frame.
+ */
+void Segment::composite() {
+  if (!isActive() || !pixels || !buildMapping()) return;
+  const uint8_t _bri_t = currentBri();
+  const uint16_t *phys = _map + _pixelsLen + 1;
+  uint32_t *out = strip._pixels;
+  #ifndef WLED_DISABLE_MODE_BLEND
+  // cross-fade previous effect's buffer into the current one
+  const uint32_t *prev = isModeBlending() ? _t->_segT._pixelsT : nullptr;
+  const uint16_t prog = progress();
+  #endif
+  for (unsigned v = 0; v < _pixelsLen; v++) {
+    uint32_t col = pixels[v];
+    #ifndef WLED_DISABLE_MODE_BLEND
+    if (prev) col = color_blend(prev[v], col, prog, true);
+    #endif
+    if (_bri_t < 255) col = color_fade(col, _bri_t);
+    if (out) for (unsigned k = _map[v]; k < _map[v+1]; k++) out[phys[k]] = col;
+    else     for (unsigned k = _map[v]; k < _map[v+1]; k++) busses.setPixelColor(phys[k], col);
+  }
+  // remember segment's CCT for each of its pixels (applied by buses when frame is pushed)
+  if (out && strip._pixelCCT) {
+    const uint8_t cct = currentBri(true);
+    for (unsigned k = 0; k < _map[_pixelsLen]; k++) strip._pixelCCT[phys[k]] = cct;
+  }
 }
 
 uint8_t Segment::differs(Segment& b) const {
@@ -854,6 +1156,7 @@ uint8_t Segment::differs(Segment& b) const {
   if (grouping != b.grouping)   d |= SEG_DIFFERS_GSO;
   if (spacing != b.spacing)     d |= SEG_DIFFERS_GSO;
   if (opacity != b.opacity)     d |= SEG_DIFFERS_BRI;
+  if (fps != b.fps)             d |= SEG_DIFFERS_FX;
   if (mode != b.mode)           d |= SEG_DIFFERS_FX;
   if (speed != b.speed)         d |= SEG_DIFFERS_FX;
   if (intensity != b.intensity) d |= SEG_DIFFERS_FX;
@@ -927,13 +1230,8 @@ void Segment::refreshLightCapabilities() {
  * Fills segment with color
  */
 void Segment::fill(uint32_t c) {
-  if (!isActive()) return; // not active
-  const uint16_t cols = is2D() ? virtualWidth() : virtualLength();
-  const uint16_t rows = virtualHeight(); // will be 1 for 1D
-  for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) {
-    if (is2D()) setPixelColorXY(x, y, c);
-    else        setPixelColor(x, c);
-  }
+  if (!isActive() || !pixels) return; // not active
+  color_fill_buf(pixels, _pixelsLen, c); // whole logical buffer (1D or 2D)
 }
 
 // Blends the specified color with the existing pixel color.
@@ -956,52 +1254,36 @@ void Segment::fadePixelColor(uint16_t n, uint8_t fade) {
  * fade out function, higher rate = quicker fade
  */
 void Segment::fade_out(uint8_t rate) {
-  if (!isActive()) return; // not active
-  const uint16_t cols = is2D() ? virtualWidth() : virtualLength();
-  const uint16_t rows = virtualHeight(); // will be 1 for 1D
+  if (!isActive() || !pixels) return; // not active
 
   rate = (255-rate) >> 1;
   float mappedRate = float(rate) +1.1f;
 
-  uint32_t color = colors[1]; // SEGCOLOR(1); // target color
-  int w2 = W(color);
-  int r2 = R(color);
-  int g2 = G(color);
-  int b2 = B(color);
-
-  for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) {
-    color = is2D() ? getPixelColorXY(x, y) : getPixelColor(x);
-    int w1 = W(color);
-    int r1 = R(color);
-    int g1 = G(color);
-    int b1 = B(color);
+  // the step only depends on the difference to the target channel value: precompute all 511 of them
+  // if fade isn't complete, make sure delta is at least 1 (fixes rounding issues)
+  int16_t delta[511];
+  for (int d = -255; d <= 255; d++) delta[d+255] = int(d / mappedRate) + (d == 0 ? 0 : d > 0 ? 1 : -1);
 
-    int wdelta = (w2 - w1) / mappedRate;
-    int rdelta = (r2 - r1) / mappedRate;
-    int gdelta = (g2 - g1) / mappedRate;
-    int bdelta = (b2 - b1) / mappedRate;
+  const uint32_t color = colors[1]; // SEGCOLOR(1); // target color
+  const int w2 = W(color) + 255;
+  const int r2 = R(color) + 255;
+  const int g2 = G(color) + 255;
+  const int b2 = B(color) + 255;
 
-    // if fade isn't complete, make sure delta is at least 1 (fixes rounding issues)
-    wdelta += (w2 == w1) ? 0 : (w2 > w1) ? 1 : -1;
-    rdelta += (r2 == r1) ? 0 : (r2 > r1) ? 1 : -1;
-    gdelta += (g2 == g1) ? 0 : (g2 > g1) ? 1 : -1;
-    bdelta += (b2 == b1) ? 0 : (b2 > b1) ? 1 : -1;
-
-    if (is2D()) setPixelColorXY(x, y, r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
-    else        setPixelColor(x, r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
+  for (unsigned i = 0; i < _pixelsLen; i++) {
+    const uint32_t c = pixels[i];
+    const int w1 = W(c);
+    const int r1 = R(c);
+    const int g1 = G(c);
+    const int b1 = B(c);
+    pixels[i] = RGBW32(r1 + delta[r2-r1], g1 + delta[g2-g1], b1 + delta[b2-b1], w1 + delta[w2-w1]);
   }
 }
 
 // fades all pixels to black using nscale8()
 void Segment::fadeToBlackBy(uint8_t fadeBy) {
-  if (!isActive() || fadeBy == 0) return;   // optimization - no scaling to apply
-  const uint16_t cols = is2D() ? virtualWidth() : virtualLength();
-  const uint16_t rows = virtualHeight(); // will be 1 for 1D
-
-  for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) {
-    if (is2D()) setPixelColorXY(x, y, color_fade(getPixelColorXY(x,y), 255-fadeBy));
-    else        setPixelColor(x, color_fade(getPixelColor(x), 255-fadeBy));
-  }
+  if (!isActive() || !pixels || fadeBy == 0) return;   // optimization - no scaling to apply
+  color_fade_buf(pixels, _pixelsLen, 255-fadeBy);
 }
 
 /*
@@ -1020,21 +1302,7 @@ void Segment::blur(uint8_t blur_amount)
     return;
   }
 #endif
-  uint8_t keep = 255 - blur_amount;
-  uint8_t seep = blur_amount >> 1;
-  uint32_t carryover = BLACK;
-  unsigned vlength = virtualLength();
-  for (unsigned i = 0; i < vlength; i++) {
-    uint32_t cur = getPixelColor(i);
-    uint32_t part = color_fade(cur, seep);
-    cur = color_add(color_fade(cur, keep), carryover, true);
-    if (i > 0) {
-      uint32_t c = getPixelColor(i-1);
-      setPixelColor(i-1, color_add(c, part, true));
-    }
-    setPixelColor(i, cur);
-    carryover = part;
-  }
+  if (pixels) color_blur_buf(pixels, min((unsigned)virtualLength(), (unsigned)_pixelsLen), blur_amount);
 }
 
 /*
@@ -1058,7 +1326,7 @@ uint32_t Segment::color_wheel(uint8_t pos) {
 
 /*
  * Gets a single color from the currently selected palette.
- * @param i Palette Index (if mapping is true, the full palette will be _virtualSegmentLength long, if false, 255). Will wrap around automatically.
+ * @param i Palette Index (if mapping is true, the full palette will be SEGLEN long, if false, 255). Will wrap around automatically.
  * @param mapping if true, LED position in segment is considered for color
  * @param wrap FastLED palettes will usually wrap back to the start smoothly. Set false to get a hard edge
  * @param mcol If the default palette 0 is selected, return the standard color 0, 1 or 2 instead. If >2, Party palette is used instead
@@ -1078,11 +1346,21 @@ uint32_t Segment::color_from_palette(uint16_t i, bool mapping, bool wrap, uint8_
   uint8_t paletteIndex = i;
   if (mapping && virtualLength() > 1) paletteIndex = (i*255)/(virtualLength() -1);
   if (!wrap && strip.paletteBlend != 3) paletteIndex = scale8(paletteIndex, 240); //cut off blend at palette "end"
-  CRGBPalette16 curPal;
-  curPal = currentPalette(curPal, palette);
-  //if (isInTransition()) curPal = _t->_palT;
-  //else    loadPalette(curPal, palette);
-  CRGB fastled_col = ColorFromPalette(curPal, paletteIndex, pbri, (strip.paletteBlend == 3)? NOBLEND:LINEARBLEND); // NOTE: paletteBlend should be global
+  CRGB fastled_col;
+  WS2812FX::render_ctx_t *ctx = WS2812FX::_ctx;
+  if (this == ctx->paletteSegment) {
+    // palette has already been resolved for this frame in WS2812FX::renderSegment(), use its lookup table
+    if (!ctx->paletteLUTValid) strip.expandCurrentPalette();
+    fastled_col = ctx->paletteLUT[paletteIndex];
+    if (pbri < 255) {
+      if (pbri) fastled_col.nscale8(pbri + 1); // same rounding as ColorFromPalette()
+      else      fastled_col = CRGB::Black;
+    }
+  } else {
+    CRGBPalette16 curPal;
+    curPal = currentPalette(curPal, palette);
+    fastled_col = ColorFromPalette(curPal, paletteIndex, pbri, (strip.paletteBlend == 3)? NOBLEND:LINEARBLEND); // NOTE: paletteBlend should be global
+  }
 
   return RGBW32(fastled_col.r, fastled_col.g, fastled_col.b, 0);
 }
@@ -1146,6 +1424,14 @@ void WS2812FX::finalizeInit(void)
     #endif
   }
 
+  // (re)allocate physical frame buffer; if that fails pixels are written directly to buses
+  if (_pixels) free(_pixels);
+  if (_pixelCCT) free(_pixelCCT);
+  _pixels   = (uint32_t*) calloc(_length, sizeof(uint32_t));
+  _pixelCCT = (uint8_t*)  calloc(_length, sizeof(uint8_t));
+  _framePending = false;
+  DEBUG_PRINTF("Frame buffer: %uB\n", _pixels ? _length*sizeof(uint32_t) : 0);
+
   if (isMatrix) setUpMatrix();
   else {
     Segment::maxWidth  = _length;
@@ -1159,70 +1445,109 @@ void WS2812FX::finalizeInit(void)
   deserializeMap();     // (re)load default ledmap
 }
 
+// 64 bit µs clock frames are scheduled with (micros() rolls over every 71 minutes)
+static inline uint64_t frameClock() {
+#if defined(ESP8266) || defined(WLED_NATIVE)
+  return micros64();
+#else
+  return esp_timer_get_time();
+#endif
+}
+
 void WS2812FX::service() {
-  unsigned long nowUp = millis(); // Be aware, millis() rolls over every 49 days
-  now = nowUp + timebase;
-  if (nowUp - _lastShow < MIN_SHOW_DELAY) return;
+  handleOutput(); // send the previous frame if the buses became free
+  // previous frame still waits for the buses: rendering now would only add latency (or overwrite it)
+  if (_framePending) return;
+
+  // frame clock: frames are rendered on a fixed grid of the synchronized time (now), slot n starts at n * frame time
+  // so frames do not drift and synced controllers render in phase; slots that passed while the previous frame was
+  // rendered or sent are dropped (the next frame is the current slot)
+  const uint64_t nowUs   = frameClock();
+  const uint32_t frameUs = 1000000UL / _targetFps;
+  const uint32_t nowMs   = nowUs / 1000; // Be aware, millis() rolls over every 49 days
+  const uint64_t syncUs  = uint64_t(uint32_t(nowMs + timebase)) * 1000 + nowUs % 1000;
+  const uint64_t slot    = syncUs / frameUs;
+  if (slot == _frameIndex && !_triggered) return; // wait for the next slot
+  if (_frameIndex && slot > _frameIndex + 1) _framesDropped += slot - _frameIndex - 1;
+  // effects see the slot time (evenly spaced), triggered frames in between slots get the actual time
+  now = (slot != _frameIndex) ? uint32_t(slot * frameUs / 1000) : nowMs + timebase;
+  _frameIndex = slot;
+  unsigned long nowUp = now - timebase; // local millis() of the frame
   bool doShow = false;
 
   _isServicing = true;
-  _segment_index = 0;
+  _renderNow = nowUp;
+  uint32_t frameStart = micros();
+  _renderCount = 0;
   Segment::handleRandomPalette(); // move it into for loop when each segment has individual random palette
-  for (segment &seg : _segments) {
+  // collect segments that are due, everything that may change segment layout or shared state runs here on the loop task
+  for (size_t i = 0; i < _segments.size(); i++) {
+    segment &seg = _segments[i];
     // process transition (mode changes in the middle of transition)
     seg.handleTransition();
     // reset the segment runtime data if needed
     seg.resetIfRequired();
 
-    if (!seg.isActive()) continue;
+    // (re)allocate pixel buffer if segment dimensions changed (releases it if segment is inactive)
+    if (!seg.allocatePixelBuffer()) continue;
+    #ifndef WLED_DISABLE_2D
+    seg.build1D2DMap(); // expansion table of 1D effects on matrices
+    #endif
 
-    // last condition ensures all solid segments are updated at the same time
-    if (nowUp > seg.next_time || _triggered || (doShow && seg.mode == FX_MODE_STATIC))
+    // static segments are not re-rendered with the others, their pixel buffer is composited every frame anyway
+    if (nowUp >= seg.next_time || _triggered)
     {
       doShow = true;
-      uint16_t delay = FRAMETIME;
-
-      if (!seg.freeze) { //only run effect function if not frozen
-        _virtualSegmentLength = seg.virtualLength();
-        _colors_t[0] = seg.currentColor(0);
-        _colors_t[1] = seg.currentColor(1);
-        _colors_t[2] = seg.currentColor(2);
-        seg.currentPalette(_currentPalette, seg.palette); // we need to pass reference
-
-        if (!cctFromRgb || correctWB) busses.setSegmentCCT(seg.currentBri(true), correctWB);
-        for (int c = 0; c < NUM_COLORS; c++) _colors_t[c] = gamma32(_colors_t[c]);
-
-        // Effect blending
-        // When two effects are being blended, each may have different segment data, this
-        // data needs to be saved first and then restored before running previous mode.
-        // The blending will largely depend on the effect behaviour since actual output (LEDs) may be
-        // overwritten by later effect. To enable seamless blending for every effect, additional LED buffer
-        // would need to be allocated for each effect and then blended together for each pixel.
-        [[maybe_unused]] uint8_t tmpMode = seg.currentMode();  // this will return old mode while in transition
-        delay = (*_mode[seg.mode])();         // run new/current mode
-#ifndef WLED_DISABLE_MODE_BLEND
-        if (modeBlending && seg.mode != tmpMode) {
-          Segment::tmpsegd_t _tmpSegData;
-          Segment::modeBlend(true);           // set semaphore
-          seg.swapSegenv(_tmpSegData);        // temporarily store new mode state (and swap it with transitional state)
-          _virtualSegmentLength = seg.virtualLength(); // update SEGLEN (mapping may have changed)
-          uint16_t d2 = (*_mode[tmpMode])();  // run old mode
-          seg.restoreSegenv(_tmpSegData);     // restore mode state (will also update transitional state)
-          delay = MIN(delay,d2);              // use shortest delay
-          Segment::modeBlend(false);          // unset semaphore
-        }
-#endif
-        if (seg.mode != FX_MODE_HALLOWEEN_EYES) seg.call++;
-        if (seg.isInTransition() && delay > FRAMETIME) delay = FRAMETIME; // force faster updates during transition
-      }
+      if (!seg.freeze) _renderQueue[_renderCount++] = i; //only run effect function if not frozen
+      else             seg.next_time = nowUp + FRAMETIME;
+    }
+  }
 
-      seg.next_time = nowUp + delay;
+  // effect data released by resets or finished transitions leaves holes, close them while no effect runs
+  Segment::compactData(_segments.data(), _segments.size());
+
+  // earliest deadline first (insertion sort, the queue is short and mostly in order already)
+  for (unsigned i = 1; i < _renderCount; i++) {
+    uint8_t id = _renderQueue[i];
+    unsigned j = i;
+    for (; j > 0 && _segments[_renderQueue[j-1]].next_time > _segments[id].next_time; j--) _renderQueue[j] = _renderQueue[j-1];
+    _renderQueue[j] = id;
+  }
+
+  // render budget: segments that do not fit into this frame (by their average effect time) are deferred to the next one
+  // instead of delaying the output of all others, the most urgent segment is always rendered
+  if (_renderBudget != RENDER_BUDGET_UNLIMITED) {
+    uint64_t budget = uint64_t(_renderBudget ? _renderBudget : _frametime * 1000UL) * renderPool.getWorkers();
+    uint64_t cost = 0;
+    unsigned n = 0;
+    for (; n < _renderCount; n++) {
+      cost += _segments[_renderQueue[n]].perf().fx.avg();
+      if (n > 0 && cost > budget) break;
+    }
+    for (unsigned i = n; i < _renderCount; i++) {
+      segment &seg = _segments[_renderQueue[i]];
+      seg.perf().deferred++;
+      if (seg.next_time > nowUp) seg.next_time = nowUp; // was due because of trigger(), keep it due
     }
-    if (_segment_index == _queuedChangesSegId) setUpSegmentFromQueuedChanges();
-    _segment_index++;
+    _renderCount = n;
   }
-  _virtualSegmentLength = 0;
-  busses.setSegmentCCT(-1);
+
+  // deadline statistics
+  for (unsigned i = 0; i < _renderCount; i++) {
+    segment &seg = _segments[_renderQueue[i]];
+    if (!seg.next_time || nowUp <= seg.next_time) continue;
+    unsigned segFrame = seg.fps ? 1000 / seg.fps : _frametime;
+    unsigned late = nowUp - seg.next_time;
+    seg.perf().skipped += late / segFrame; // frames that could have been rendered while the segment was waiting to be serviced
+    if (late >= segFrame) seg.perf().missed++;
+  }
+
+  // effect functions of different segments only touch their own segment, run them in parallel
+  if (_renderCount == 1) renderSegment(_renderQueue[0], 0);
+  else                   renderPool.run(renderJob, this, _renderCount);
+
+  _ctx = &_renderCtx[0];
+  if (_queuedChangesSegId < _segments.size()) setUpSegmentFromQueuedChanges();
   _isServicing = false;
   _triggered = false;
 
@@ -1231,6 +1556,7 @@ void WS2812FX::service() {
   #endif
   if (doShow) {
     yield();
+    _frameStart = frameStart;
     show();
   }
   #ifdef WLED_DEBUG
@@ -1238,18 +1564,106 @@ void WS2812FX::service() {
   #endif
 }
 
+void WS2812FX::renderJob(unsigned job, unsigned worker, void *arg) {
+  WS2812FX *fx = static_cast<WS2812FX*>(arg);
+  fx->renderSegment(fx->_renderQueue[job], worker);
+}
+
+// runs effect function of a single segment, called on the loop task or a render task (worker)
+void WS2812FX::renderSegment(uint8_t id, unsigned worker) {
+  segment &seg = _segments[id];
+  render_ctx_t *ctx = _ctx = &_renderCtx[worker];
+  uint16_t delay = FRAMETIME;
+
+  uint32_t fxStart = micros();
+  if (seg.perf().rendered) seg.perf().interval.add(fxStart - seg.perf().lastFrame);
+  seg.perf().lastFrame = fxStart;
+  seg.perf().rendered++;
+  ctx->segIndex = id;
+  ctx->virtualLength = seg.virtualLength();
+  for (int c = 0; c < NUM_COLORS; c++) ctx->colors[c] = gamma32(seg.currentColor(c));
+  seg.currentPalette(ctx->palette, seg.palette); // we need to pass reference
+  ctx->paletteSegment = &seg;    // palette is resolved once per frame, color_from_palette() uses its expanded LUT
+  ctx->paletteLUTValid = false;
+  ctx->rendering = true;
+  const uint16_t taskSeed = random16_get_seed();
+  random16_set_seed(seg.randSeed);
+
+  // Effect blending
+  // When two effects are being blended, each has its own segment data and pixel buffer, these
+  // need to be swapped in before running previous mode and restored afterwards.
+  // Both pixel buffers are then cross-faded when the segment is composited (see Segment::composite()).
+  [[maybe_unused]] uint8_t tmpMode = seg.currentMode();  // this will return old mode while in transition
+  delay = (*_mode[seg.mode])();         // run new/current mode
+#ifndef WLED_DISABLE_MODE_BLEND
+  if (modeBlending && seg.mode != tmpMode && seg.isModeBlending()) {
+    Segment::tmpsegd_t _tmpSegData;
+    Segment::modeBlend(true);           // set semaphore
+    seg.swapSegenv(_tmpSegData);        // temporarily store new mode state (and swap it with transitional state)
+    ctx->virtualLength = seg.virtualLength(); // update SEGLEN (mapping may have changed)
+    uint16_t d2 = (*_mode[tmpMode])();  // run old mode
+    seg.restoreSegenv(_tmpSegData);     // restore mode state (will also update transitional state)
+    delay = MIN(delay,d2);              // use shortest delay
+    Segment::modeBlend(false);          // unset semaphore
+  }
+#endif
+  seg.randSeed = random16_get_seed();
+  random16_set_seed(taskSeed);
+  ctx->rendering = false;
+  ctx->paletteSegment = nullptr;
+  ctx->virtualLength = 0;
+  seg.perf().fx.add(micros() - fxStart);
+  if (seg.mode != FX_MODE_HALLOWEEN_EYES) seg.call++;
+  if (seg.fps) {
+    // segment frame rate: replaces the strip frame time, effects with their own timing are only slowed down
+    uint16_t segFrame = 1000 / seg.fps;
+    delay = (delay == FRAMETIME) ? segFrame : MAX(delay, segFrame);
+    if (seg.isInTransition() && delay > segFrame) delay = segFrame;
+  }
+  else if (seg.isInTransition() && delay > FRAMETIME) delay = FRAMETIME; // force faster updates during transition
+
+  seg.next_time = _renderNow + delay;
+}
+
+bool WS2812FX::isSegmentRendering(uint8_t segId) {
+  for (const render_ctx_t &ctx : _renderCtx) if (ctx.rendering && ctx.segIndex == segId) return true;
+  return false;
+}
+
+// expand current palette into 256 entry lookup table (once per segment per frame)
+void WS2812FX::expandCurrentPalette() {
+  render_ctx_t *ctx = _ctx;
+  TBlendType blendType = (paletteBlend == 3) ? NOBLEND : LINEARBLEND; // NOTE: paletteBlend should be global
+  for (int i = 0; i < 256; i++) ctx->paletteLUT[i] = ColorFromPalette(ctx->palette, i, 255, blendType);
+  ctx->paletteLUTValid = true;
+}
+
 void IRAM_ATTR WS2812FX::setPixelColor(int i, uint32_t col)
 {
   if (i < customMappingSize) i = customMappingTable[i];
   if (i >= _length) return;
-  busses.setPixelColor(i, col);
+  if (_pixels) _pixels[i] = col;
+  else         busses.setPixelColor(i, col);
+}
+
+// same as setPixelColor() for each pixel, but unmapped runs go to the frame buffer or the buses in one piece
+void WS2812FX::setPixels(uint16_t i, const uint32_t *c, uint16_t count)
+{
+  if (i < customMappingSize) {
+    for (uint16_t n = 0; n < count; n++) setPixelColor(i + n, c[n]);
+    return;
+  }
+  if (i >= _length) return;
+  if (count > _length - i) count = _length - i;
+  if (_pixels) memcpy(_pixels + i, c, count * sizeof(uint32_t));
+  else         busses.setPixels(i, c, count);
 }
 
 uint32_t WS2812FX::getPixelColor(uint16_t i)
 {
   if (i < customMappingSize) i = customMappingTable[i];
   if (i >= _length) return 0;
-  return busses.getPixelColor(i);
+  return _pixels ? _pixels[i] : busses.getPixelColor(i);
 }
 
 
@@ -1264,6 +1678,19 @@ uint32_t WS2812FX::getPixelColor(uint16_t i)
 #define MA_FOR_ESP        100 //how much mA does the ESP use (Wemos D1 about 80mA, ESP32 about 120mA)
                               //you can set it to 0 if the ESP is powered by USB and the LEDs by external
 
+// brightness needed to stay within the current budget (milliamps are the consumption at full brightness)
+static uint8_t limitBriToBudget(size_t milliamps, size_t budget, uint8_t bri) {
+  if (milliamps * bri / 255 <= budget) return bri;
+  float scale = (float)(budget * 255) / (float)(milliamps * bri);
+  uint16_t scaleI = scale * 255;
+  uint8_t scaleB = (scaleI > 255) ? 255 : scaleI;
+  return scale8(bri, scaleB) + 1;
+}
+
+// sets the (limited) brightness of all buses and returns the global one
+// with a frame buffer the channel sums are accumulated by the buses while the frame is pushed (see pushFrame()) and
+// the limit applies from the next frame on (buffered buses scale in show(), i.e. already this one), otherwise all
+// pixels are read back from the buses and repainted if the brightness has to be lowered
 uint8_t WS2812FX::estimateCurrentAndLimitBri() {
   //power limit calculation
   //each LED can draw up 195075 "power units" (approx. 53mA)
@@ -1274,6 +1701,7 @@ uint8_t WS2812FX::estimateCurrentAndLimitBri() {
 
   if (ablMilliampsMax < 150 || actualMilliampsPerLed == 0) { //0 mA per LED and too low numbers turn off calculation
     currentMilliamps = 0;
+    busses.setBrightness(_brightness, !_pixels);
     return _brightness;
   }
 
@@ -1286,21 +1714,19 @@ uint8_t WS2812FX::estimateCurrentAndLimitBri() {
 
   size_t pLen = 0; //getLengthPhysical();
   size_t powerSum = 0;
+  uint32_t busPower[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES] = {0};
+  bool busLimits = false;
   for (uint_fast8_t bNum = 0; bNum < busses.getNumBusses(); bNum++) {
     Bus *bus = busses.getBus(bNum);
     if (!IS_DIGITAL(bus->getType())) continue; //exclude non-digital network busses
     uint16_t len = bus->getLength();
     pLen += len;
     uint32_t busPowerSum = 0;
-    for (uint_fast16_t i = 0; i < len; i++) { //sum up the usage of each LED
+    if (_pixels) {
+      busPowerSum = bus->getPowerSum(); // accumulated in setPixels()
+    } else for (uint_fast16_t i = 0; i < len; i++) { //sum up the usage of each LED
       uint32_t c = bus->getPixelColor(i); // always returns original or restored color without brightness scaling
-      byte r = R(c), g = G(c), b = B(c), w = W(c);
-
-      if(useWackyWS2815PowerModel) { //ignore white component on WS2815 power calculation
-        busPowerSum += (MAX(MAX(r,g),b)) * 3;
-      } else {
-        busPowerSum += (r + g + b + w);
-      }
+      busPowerSum += Bus::pixelPower(useWackyWS2815PowerModel ? POWER_MODEL_WS2815 : POWER_MODEL_CHANNELS, R(c), G(c), B(c), W(c));
     }
 
     if (bus->hasWhite()) { //RGBW led total output with white LEDs enabled is still 50mA, so each channel uses less
@@ -1308,6 +1734,8 @@ uint8_t WS2812FX::estimateCurrentAndLimitBri() {
       busPowerSum >>= 2; //same as /= 4
     }
     powerSum += busPowerSum;
+    busPower[bNum] = busPowerSum;
+    busLimits |= bus->getMaxCurrent() > 0;
   }
 
   if (powerBudget > pLen) { //each LED uses about 1mA in standby, exclude that from power budget
@@ -1319,43 +1747,147 @@ uint8_t WS2812FX::estimateCurrentAndLimitBri() {
   // powerSum has all the values of channels summed (max would be pLen*765 as white is excluded) so convert to milliAmps
   powerSum = (powerSum * actualMilliampsPerLed) / 765;
 
-  uint8_t newBri = _brightness;
-  if (powerSum * _brightness / 255 > powerBudget) { //scale brightness down to stay in current limit
-    float scale = (float)(powerBudget * 255) / (float)(powerSum * _brightness);
-    uint16_t scaleI = scale * 255;
-    uint8_t scaleB = (scaleI > 255) ? 255 : scaleI;
-    newBri = scale8(_brightness, scaleB) + 1;
-  }
+  uint8_t newBri = limitBriToBudget(powerSum, powerBudget, _brightness); //scale brightness down to stay in current limit
   currentMilliamps = (powerSum * newBri) / 255;
+
+  if (busLimits) {
+    // additionally limit each bus to its own current limit (i.e. its power supply or wiring)
+    currentMilliamps = 0;
+    for (uint_fast8_t bNum = 0; bNum < busses.getNumBusses(); bNum++) {
+      Bus *bus = busses.getBus(bNum);
+      uint8_t busBri = newBri;
+      if (IS_DIGITAL(bus->getType())) {
+        size_t busMilliamps = (busPower[bNum] * actualMilliampsPerLed) / 765;
+        size_t busBudget = bus->getMaxCurrent();
+        if (busBudget) busBri = limitBriToBudget(busMilliamps, busBudget > bus->getLength() ? busBudget - bus->getLength() : 0, newBri);
+        currentMilliamps += (busMilliamps * busBri) / 255;
+      }
+      bus->setBrightness(busBri, !_pixels);
+    }
+  } else {
+    busses.setBrightness(newBri, !_pixels); // without a frame buffer pixels were already written and are repainted
+  }
+
   currentMilliamps += MA_FOR_ESP; //add power of ESP back to estimate
   currentMilliamps += pLen; //add standby power (1mA/LED) back to estimate
   return newBri;
 }
 
+// with a frame buffer the buses keep the ABL limit of the previous frame (lowered to the global brightness if it
+// dropped below it) and account the channel sums while the frame is pushed, without one pixels are written to
+// buses directly at full brightness and ones not overwritten need to be repainted
+void WS2812FX::prepareBusOutput() {
+  if (!_pixels || ablMilliampsMax < 150 || milliampsPerLed == 0) {
+    Bus::setPowerModel(POWER_MODEL_NONE);
+    busses.setBrightness(_brightness, !_pixels);
+    return;
+  }
+  Bus::setPowerModel(milliampsPerLed == 255 ? POWER_MODEL_WS2815 : POWER_MODEL_CHANNELS);
+  for (uint_fast8_t bNum = 0; bNum < busses.getNumBusses(); bNum++) {
+    Bus *bus = busses.getBus(bNum);
+    if (bus->getBrightness() > _brightness) bus->setBrightness(_brightness, false);
+  }
+}
+
+// Frames are double buffered: segments are composited into _pixels while the buses are still sending the
+// previous frame out of their own buffers (RMT/I2S/UART/network are asynchronous). The output stage hands
+// the frame over as soon as all buses are free, so neither rendering nor the loop wait for a transmission.
 void WS2812FX::show(void) {
+  // composite segment pixel buffers onto the strip (unless realtime data is being displayed)
+  const bool composite = !realtimeMode || realtimeOverride || useMainSegmentOnly;
+  const bool segCCT    = !cctFromRgb || correctWB;
+
+  if (!_frameStart) _frameStart = micros(); // not rendered by service() (i.e. realtime data)
+  if (!_pixels) prepareBusOutput(); // composited straight into the buses
+
+  if (composite) {
+    for (segment &seg : _segments) {
+      uint32_t compStart = micros();
+      if (!_pixels && segCCT) busses.setSegmentCCT(seg.currentBri(true), correctWB); // writing directly to buses
+      seg.composite();
+      if (seg.isActive()) seg.perf().composite.add(micros() - compStart);
+    }
+    busses.setSegmentCCT(-1);
+  }
+
   // avoid race condition, capture _callback value
   show_callback callback = _callback;
   if (callback) callback();
 
-  uint8_t newBri = estimateCurrentAndLimitBri();
-  busses.setBrightness(newBri); // "repaints" all pixels if brightness changed
+  // frame is complete, data written while it is pending (realtime) is sent along with it
+  if (!_framePending && !busses.canAllShow()) _framesDeferred++; // has to wait for the buses
+  _framePending = true;
+  handleOutput();
+}
+
+// output stage: sends the pending frame once all buses finished sending the previous one, never waits for them
+void WS2812FX::handleOutput() {
+  if (_framePending && busses.canAllShow()) pushFrame();
+}
+
+// hands the frame to the buses (in contiguous runs, bus by bus)
+void WS2812FX::pushPixels(bool segCCT) {
+  if (segCCT && _pixelCCT) {
+    // split frame into runs of equal segment CCT
+    for (unsigned i = 0; i < _length; ) {
+      unsigned j = i + 1;
+      while (j < _length && _pixelCCT[j] == _pixelCCT[i]) j++;
+      busses.setSegmentCCT(_pixelCCT[i], correctWB);
+      busses.setPixels(i, _pixels + i, j - i);
+      i = j;
+    }
+    busses.setSegmentCCT(-1);
+  } else {
+    busses.setPixels(0, _pixels, _length);
+  }
+}
+
+void WS2812FX::pushFrame() {
+  const bool composite = !realtimeMode || realtimeOverride || useMainSegmentOnly;
+  const bool segCCT    = !cctFromRgb || correctWB;
+  uint32_t showStart = micros();
+  _framePending = false;
+
+  // ABL channel sums are accumulated in the same pass, nothing has to be read back or repainted
+  if (_pixels) {
+    prepareBusOutput();
+    pushPixels(composite && segCCT);
+  }
+  estimateCurrentAndLimitBri();
 
   // some buses send asynchronously and this method will return before
   // all of the data has been sent.
   // See https://github.com/Makuna/NeoPixelBus/wiki/ESP32-NeoMethods#neoesp32rmt-methods
   busses.show();
+  uint32_t showNow_us = micros();
+  _showPerf.add(showNow_us - showStart);
+  _latencyPerf.add(showNow_us - _frameStart);
+  _frameStart = 0;
 
-  // restore bus brightness to its original value
-  // this is done right after show, so this is only OK if LED updates are completed before show() returns
-  // or async show has a separate buffer (ESP32 RMT and I2S are ok)
-  if (newBri < _brightness) busses.setBrightness(_brightness);
+  // frame interval in µs (FPS and jitter)
+  uint64_t pushUs = frameClock();
+  uint32_t interval = pushUs - _lastPushUs;
+  if (_lastPushUs && interval < 2000000UL) {
+    _frameIntervals[_frameIntervalIdx] = interval;
+    _frameIntervalIdx = (_frameIntervalIdx + 1) % FRAME_JITTER_SAMPLES;
+    if (_frameIntervalCount < FRAME_JITTER_SAMPLES) _frameIntervalCount++;
+  }
+  _lastPushUs = pushUs;
+  _lastShow = millis();
+}
 
-  unsigned long showNow = millis();
-  size_t diff = showNow - _lastShow;
-  size_t fpsCurr = 200;
-  if (diff > 0) fpsCurr = 1000 / diff;
-  _cumulativeFps = (3 * _cumulativeFps + fpsCurr +2) >> 2;   // "+2" for proper rounding (2/4 = 0.5)
-  _lastShow = showNow;
+// percentile (0-100) of the deviation of the last FRAME_JITTER_SAMPLES frame intervals from the frame grid, in µs
+// (intervals spanning several frame slots are compared with the nearest multiple of the frame time)
+uint32_t WS2812FX::getFrameJitter(uint8_t percentile) {
+  if (!_frameIntervalCount) return 0;
+  const uint32_t frameUs = 1000000UL / _targetFps;
+  uint32_t dev[FRAME_JITTER_SAMPLES];
+  for (unsigned i = 0; i < _frameIntervalCount; i++) {
+    uint32_t grid = MAX((_frameIntervals[i] + frameUs/2) / frameUs, 1U) * frameUs;
+    dev[i] = _frameIntervals[i] > grid ? _frameIntervals[i] - grid : grid - _frameIntervals[i];
+  }
+  std::sort(dev, dev + _frameIntervalCount);
+  return dev[(MIN(percentile, 100) * (_frameIntervalCount - 1) + 50) / 100];
 }
 
 /**
@@ -1371,13 +1903,17 @@ bool WS2812FX::isUpdating() {
  * Only updates on show() or is set to 0 fps if last show is more than 2 secs ago, so accuracy varies
  */
 uint16_t WS2812FX::getFps() {
-  if (millis() - _lastShow > 2000) return 0;
-  return _cumulativeFps +1;
+  if (millis() - _lastShow > 2000 || !_frameIntervalCount) return 0;
+  uint32_t sum = 0;
+  for (unsigned i = 0; i < _frameIntervalCount; i++) sum += _frameIntervals[i];
+  return (1000000ULL * _frameIntervalCount + sum/2) / MAX(sum, 1U); // average over the last FRAME_JITTER_SAMPLES frames
 }
 
 void WS2812FX::setTargetFps(uint8_t fps) {
   if (fps > 0 && fps <= 120) _targetFps = fps;
   _frametime = 1000 / _targetFps;
+  _frameIndex = 0; // new frame grid
+  _frameIntervalCount = 0;
 }
 
 void WS2812FX::setMode(uint8_t segid, uint8_t m) {
@@ -1420,9 +1956,9 @@ void WS2812FX::setBrightness(uint8_t b, bool direct) {
       seg.freeze = false;
     }
   }
-  // setting brightness with NeoPixelBusLg has no effect on already painted pixels,
-  // so we need to force an update to existing buffer
-  busses.setBrightness(b);
+  // brightness is applied when pixels are pushed to buses, so without a frame buffer
+  // we need to force an update to already painted pixels
+  busses.setBrightness(b, !_pixels);
   if (!direct) {
     unsigned long t = millis();
     if (_segments[0].next_time > t + 22 && t - _lastShow > MIN_SHOW_DELAY) trigger(); //apply brightness change immediately if no refresh soon
@@ -1542,14 +2078,14 @@ void WS2812FX::setSegment(uint8_t segId, uint16_t i1, uint16_t i2, uint8_t group
 
   if (_queuedChangesSegId == segId) _queuedChangesSegId = 255; // cancel queued change if already queued for this segment
 
-  if (segId < getMaxSegments() && segId == getCurrSegmentId() && isServicing()) { // queue change to prevent concurrent access
+  if (segId < getMaxSegments() && isServicing() && isSegmentRendering(segId)) { // queue change to prevent concurrent access
     // queuing a change for a second segment will lead to the loss of the first change if not yet applied
-    // however this is not a problem as the queued change is applied immediately after the effect function in that segment returns
+    // however this is not a problem as the queued change is applied immediately after the effect functions return
     _qStart  = i1; _qStop   = i2; _qStartY = startY; _qStopY  = stopY;
     _qGrouping = grouping; _qSpacing  = spacing; _qOffset   = offset;
     _queuedChangesSegId = segId;
     DEBUG_PRINT(F("Segment queued: ")); DEBUG_PRINTLN(segId);
-    return; // queued changes are applied immediately after effect function returns
+    return; // queued changes are applied immediately after effect functions return
   }
   
   _segments[segId].setUp(i1, i2, grouping, spacing, offset, startY, stopY);
@@ -1694,12 +2230,12 @@ bool WS2812FX::checkSegmentAlignment() {
 
 //After this function is called, setPixelColor() will use that segment (offsets, grouping, ... will apply)
 //Note: If called in an interrupt (e.g. JSON API), original segment must be restored,
-//otherwise it can lead to a crash on ESP32 because _segment_index is modified while in use by the main thread
+//otherwise SEGMENT/SEGLEN of the calling task keep pointing to segment n
 uint8_t WS2812FX::setPixelSegment(uint8_t n) {
-  uint8_t prevSegId = _segment_index;
+  uint8_t prevSegId = _ctx->segIndex;
   if (n < _segments.size()) {
-    _segment_index = n;
-    _virtualSegmentLength = _segments[_segment_index].virtualLength();
+    _ctx->segIndex = n;
+    _ctx->virtualLength = _segments[n].virtualLength();
   }
   return prevSegId;
 }
@@ -1778,6 +2314,7 @@ void WS2812FX::loadCustomPalettes() {
 //load custom mapping table from JSON file (called from finalizeInit() or deserializeState())
 bool WS2812FX::deserializeMap(uint8_t n) {
   // 2D support creates its own ledmap (on the fly) if a ledmap.json exists it will overwrite built one.
+  Segment::invalidateMappings(); // segment index tables include ledmap
 
   char fileName[32];
   strcpy_P(fileName, PSTR("/ledmap"));
@@ -1827,6 +2364,9 @@ bool WS2812FX::deserializeMap(uint8_t n) {
 
 
 WS2812FX* WS2812FX::instance = nullptr;
+WS2812FX::render_ctx_t WS2812FX::_renderCtx[1 + WLED_RENDER_TASKS];
+WLED_RENDER_TLS WS2812FX::render_ctx_t *WS2812FX::_ctx = &WS2812FX::_renderCtx[0];
+WLED_RENDER_TLS uint16_t fxRand16Seed = 1337; // same start value as FastLED's global seed (every task starts with it)
 
 const char JSON_mode_names[] PROGMEM = R"=====(["FX names moved"])=====";
 const char JSON_palette_names[] PROGMEM = R"=====([
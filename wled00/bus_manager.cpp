@@ -11,11 +11,13 @@
 
 //colors.cpp
 uint32_t colorBalanceFromKelvin(uint16_t kelvin, uint32_t rgb);
+void colorKtoRGB(uint16_t kelvin, byte* rgb);
 uint16_t approximateKelvinFromRGB(uint32_t rgb);
 void colorRGBtoRGBW(byte* rgb);
 
 //udp.cpp
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte *buffer, uint8_t bri=255, bool isRGBW=false);
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte *buffer, uint8_t bri, bool isRGBW, uint8_t *packet, NetSendStats *stats = nullptr);
+size_t  realtimePacketSize(uint8_t type);
 
 // enable additional debug output
 #if defined(WLED_DEBUG_HOST)
@@ -75,9 +77,7 @@ uint8_t IRAM_ATTR ColorOrderMap::getPixelColorOrder(uint16_t pix, uint8_t defaul
 }
 
 
-uint32_t Bus::autoWhiteCalc(uint32_t c) {
-  uint8_t aWM = _autoWhiteMode;
-  if (_gAWM != AW_GLOBAL_DISABLED) aWM = _gAWM;
+uint32_t IRAM_ATTR Bus::autoWhiteCalc(uint32_t c, uint8_t aWM) {
   if (aWM == RGBW_MODE_MANUAL_ONLY) return c;
   uint8_t w = W(c);
   //ignore auto-white calculation if w>0 and mode DUAL (DUAL behaves as BRIGHTER if w==0)
@@ -91,6 +91,40 @@ uint32_t Bus::autoWhiteCalc(uint32_t c) {
   return RGBW32(r, g, b, w);
 }
 
+// (re)build the output transform of this bus: white balance correction and brightness scaling fused into one table per channel
+// brightness is applied the same way NeoPixelBusLg did it, so restoreColorLossy() remains valid
+void Bus::prepareOutputLUT(uint8_t bri, int16_t kelvin) {
+  if (kelvin < 1900) kelvin = 0;
+  if (bri == _outLUTBri && kelvin == _outLUTKelvin) return;
+  const uint8_t *wb = whiteBalance(kelvin);
+  for (unsigned c = 0; c < 4; c++) {
+    const unsigned corr = c < 3 ? wb[c] : 255; // W channel is never corrected
+    for (unsigned i = 0; i < 256; i++) {
+      unsigned v = (corr * i) / 255;
+      _outLUT[c][i] = (v * (bri + 1)) >> 8;
+    }
+  }
+  _outLUTBri    = bri;
+  _outLUTKelvin = kelvin;
+}
+
+// white balance correction of the output LUT, recomputed only if the color temperature changes
+const uint8_t *Bus::whiteBalance(int16_t kelvin) {
+  if (kelvin < 1900) kelvin = 0;
+  if (kelvin != _wbKelvin) {
+    byte corr[4] = {255,255,255,255};
+    if (kelvin) colorKtoRGB(kelvin, corr);
+    memcpy(_wbCorr, corr, sizeof(_wbCorr));
+    _wbKelvin = kelvin;
+  }
+  return _wbCorr;
+}
+
+// generic (slow) implementation, buses with larger pixel count should override it
+void Bus::setPixels(uint16_t pix, const uint32_t *c, uint16_t count) {
+  for (uint16_t i = 0; i < count; i++) setPixelColor(pix + i, c[i]);
+}
+
 uint8_t *Bus::allocData(size_t size) {
   if (_data) free(_data); // should not happen, but for safety
   return _data = (uint8_t *)(size>0 ? calloc(size, sizeof(uint8_t)) : nullptr);
@@ -102,6 +136,8 @@ BusDigital::BusDigital(BusConfig &bc, uint8_t nr, const ColorOrderMap &com)
 , _skip(bc.skipAmount) //sacrificial pixels
 , _colorOrder(bc.colorOrder)
 , _colorOrderMap(com)
+, _milliAmpsMax(bc.milliAmpsMax)
+, _powerSum(0)
 {
   if (!IS_DIGITAL(bc.type) || !bc.count) return;
   if (!pinManager.allocatePin(bc.pins[0], true, PinOwner::BusDigital)) return;
@@ -117,6 +153,7 @@ BusDigital::BusDigital(BusConfig &bc, uint8_t nr, const ColorOrderMap &com)
   }
   _iType = PolyBus::getI(bc.type, _pins, nr);
   if (_iType == I_NONE) return;
+  if (!allocOutputLUT()) return;
   if (bc.doubleBuffer && !allocData(bc.count * (Bus::hasWhite(_type) + 3*Bus::hasRGB(_type)))) return; //warning: hardcoded channel count
   _buffering = bc.doubleBuffer;
   uint16_t lenToCreate = bc.count;
@@ -130,6 +167,7 @@ void BusDigital::show() {
   if (!_valid) return;
   if (_buffering) { // should be _data != nullptr, but that causes ~20% FPS drop
     size_t channels = Bus::hasWhite(_type) + 3*Bus::hasRGB(_type);
+    const uint16_t bri = _bri + 1; // _data holds unscaled colors, brightness is applied on transfer
     for (size_t i=0; i<_len; i++) {
       size_t offset = i*channels;
       uint8_t co = _colorOrderMap.getPixelColorOrder(i+_start, _colorOrder);
@@ -143,6 +181,7 @@ void BusDigital::show() {
       } else {
         c = RGBW32(_data[offset],_data[offset+1],_data[offset+2],(Bus::hasWhite(_type)?_data[offset+3]:0));
       }
+      if (bri < 256) c = RGBW32((R(c)*bri)>>8, (G(c)*bri)>>8, (B(c)*bri)>>8, (W(c)*bri)>>8);
       uint16_t pix = i;
       if (_reversed) pix = _len - pix -1;
       pix += _skip;
@@ -154,6 +193,7 @@ void BusDigital::show() {
     for (int i=1; i<_skip; i++) PolyBus::setPixelColor(_busPtr, _iType, i, 0, _colorOrderMap.getPixelColorOrder(_start, _colorOrder)); // paint skipped pixels black
   }
   PolyBus::show(_busPtr, _iType, !_buffering); // faster if buffer consistency is not important
+  _powerSum = 0;
 }
 
 bool BusDigital::canShow() {
@@ -161,7 +201,9 @@ bool BusDigital::canShow() {
   return PolyBus::canShow(_busPtr, _iType);
 }
 
-void BusDigital::setBrightness(uint8_t b) {
+// brightness is no longer applied by NeoPixelBus (luminance stays at 255) but by the output LUT when pixels are set
+// immediate=true repaints pixels already in the NeoPixelBus buffer, not needed if the whole frame is set before the next show
+void BusDigital::setBrightness(uint8_t b, bool immediate) {
   if (_bri == b) return;
   //Fix for turning off onboard LED breaking bus
   #ifdef LED_BUILTIN
@@ -171,18 +213,18 @@ void BusDigital::setBrightness(uint8_t b) {
   #endif
   uint8_t prevBri = _bri;
   Bus::setBrightness(b);
-  PolyBus::setBrightness(_busPtr, _iType, b);
 
-  if (_buffering) return;
+  if (_buffering || !immediate) return;
 
-  // must update/repaint every LED in the NeoPixelBus buffer to the new brightness
-  // the only case where repainting is unnecessary is when all pixels are set after the brightness change but before the next show
-  // (which we can't rely on)
+  // update/repaint every LED in the NeoPixelBus buffer to the new brightness
+  // white balance is already applied, only rescale (same scaling as the output LUT, which is left alone)
+  const uint16_t scale = b + 1;
   uint16_t hwLen = _len;
   if (_type == TYPE_WS2812_1CH_X3) hwLen = NUM_ICS_WS2812_1CH_3X(_len); // only needs a third of "RGB" LEDs for NeoPixelBus
   for (uint_fast16_t i = 0; i < hwLen; i++) {
     // use 0 as color order, actual order does not matter here as we just update the channel values as-is
     uint32_t c = restoreColorLossy(PolyBus::getPixelColor(_busPtr, _iType, i, 0),prevBri);
+    c = RGBW32((R(c)*scale)>>8, (G(c)*scale)>>8, (B(c)*scale)>>8, (W(c)*scale)>>8);
     PolyBus::setPixelColor(_busPtr, _iType, i, c, 0);
   }
 }
@@ -191,6 +233,8 @@ void BusDigital::setBrightness(uint8_t b) {
 //TODO only show if no new show due in the next 50ms
 void BusDigital::setStatusPixel(uint32_t c) {
   if (_valid && _skip) {
+    const uint16_t bri = _bri + 1;
+    c = RGBW32((R(c)*bri)>>8, (G(c)*bri)>>8, (B(c)*bri)>>8, (W(c)*bri)>>8);
     PolyBus::setPixelColor(_busPtr, _iType, 0, c, _colorOrderMap.getPixelColorOrder(_start, _colorOrder));
     if (canShow()) PolyBus::show(_busPtr, _iType);
   }
@@ -199,7 +243,9 @@ void BusDigital::setStatusPixel(uint32_t c) {
 void IRAM_ATTR BusDigital::setPixelColor(uint16_t pix, uint32_t c) {
   if (!_valid) return;
   if (Bus::hasWhite(_type)) c = autoWhiteCalc(c);
-  if (_cct >= 1900) c = colorBalanceFromKelvin(_cct, c); //color correction from CCT
+  prepareOutputLUT(_buffering ? 255 : _bri, _cct); // brightness of buffered data is applied in show()
+  if (_type == TYPE_WS2812_1CH_X3) c = RGBW32(_outLUT[3][R(c)], _outLUT[3][G(c)], _outLUT[3][B(c)], _outLUT[3][W(c)]); // each channel is a white LED
+  else                             c = RGBW32(_outLUT[0][R(c)], _outLUT[1][G(c)], _outLUT[2][B(c)], _outLUT[3][W(c)]);
   if (_buffering) { // should be _data != nullptr, but that causes ~20% FPS drop
     size_t channels = Bus::hasWhite(_type) + 3*Bus::hasRGB(_type);
     size_t offset = pix*channels;
@@ -216,17 +262,80 @@ void IRAM_ATTR BusDigital::setPixelColor(uint16_t pix, uint32_t c) {
     if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs
       uint16_t pOld = pix;
       pix = IC_INDEX_WS2812_1CH_3X(pix);
-      uint32_t cOld = restoreColorLossy(PolyBus::getPixelColor(_busPtr, _iType, pix, co),_bri);
-      switch (pOld % 3) { // change only the single channel (TODO: this can cause loss because of get/set)
-        case 0: c = RGBW32(R(cOld), W(c)   , B(cOld), 0); break;
-        case 1: c = RGBW32(W(c)   , G(cOld), B(cOld), 0); break;
-        case 2: c = RGBW32(R(cOld), G(cOld), W(c)   , 0); break;
+      uint32_t cOld = PolyBus::getPixelColor(_busPtr, _iType, pix, co); // already scaled
+      uint8_t  w    = W(c);
+      switch (pOld % 3) { // change only the single channel
+        case 0: c = RGBW32(R(cOld), w      , B(cOld), 0); break;
+        case 1: c = RGBW32(w      , G(cOld), B(cOld), 0); break;
+        case 2: c = RGBW32(R(cOld), G(cOld), w      , 0); break;
       }
     }
     PolyBus::setPixelColor(_busPtr, _iType, pix, c, co);
   }
 }
 
+// auto-white mode, output LUT (white balance & brightness), channel layout and color order are resolved once per run
+// the ABL channel sums are accumulated on the way (see getPowerSum()): white balanced but unscaled, with the channels
+// the bus actually stores (buffered: as in _data, unbuffered: 4 channels for RGBW chips, 3 for all others, white-only
+// x3 chips count their single channel on all four), i.e. what getPixelColor() returns at full brightness
+void IRAM_ATTR BusDigital::setPixels(uint16_t pix, const uint32_t *c, uint16_t count) {
+  if (!_valid || pix >= _len) return;
+  if (count > _len - pix) count = _len - pix;
+  const bool    hasW = Bus::hasWhite(_type);
+  const bool    hasRGB = Bus::hasRGB(_type);
+  const uint8_t aWM  = hasW ? effectiveAWMode() : RGBW_MODE_MANUAL_ONLY;
+  const uint8_t pm   = _powerModel;
+  uint32_t power = 0;
+  if (_type == TYPE_WS2812_1CH_X3 && !_buffering) { // channel read-modify-write, needs per pixel handling
+    for (uint16_t i = 0; i < count; i++) {
+      if (pm != POWER_MODEL_NONE) { uint8_t w = W(autoWhiteCalc(c[i], aWM)); power += pixelPower(pm, w, w, w, w); }
+      setPixelColor(pix + i, c[i]);
+    }
+    _powerSum += power;
+    return;
+  }
+  prepareOutputLUT(_buffering ? 255 : _bri, _cct); // brightness of buffered data is applied in show()
+  const uint8_t *lutR = _outLUT[0], *lutG = _outLUT[1], *lutB = _outLUT[2], *lutW = _outLUT[3];
+  if (_type == TYPE_WS2812_1CH_X3) lutR = lutG = lutB = lutW; // each channel is a white LED
+
+  if (_buffering) { // should be _data != nullptr, but that causes ~20% FPS drop
+    const size_t channels = hasW + 3*hasRGB;
+    uint8_t *d = _data + pix*channels;
+    for (uint16_t i = 0; i < count; i++) {
+      uint32_t col = autoWhiteCalc(c[i], aWM);
+      uint8_t r = lutR[R(col)], g = lutG[G(col)], b = lutB[B(col)], w = lutW[W(col)];
+      if (hasRGB) {
+        *d++ = r;
+        *d++ = g;
+        *d++ = b;
+      }
+      if (hasW) *d++ = w;
+      if (pm != POWER_MODEL_NONE) power += hasRGB ? pixelPower(pm, r, g, b, hasW ? w : 0) : pixelPower(pm, w, w, w, w);
+    }
+  } else {
+    const bool perPixelCO = _colorOrderMap.count() > 0;
+    const bool keepW = hasRGB && hasW;
+    const uint8_t *wb = whiteBalance(_cct); // the LUT includes brightness, the sums must not
+    const bool correct = wb[0] != 255 || wb[1] != 255 || wb[2] != 255;
+    uint8_t co = _colorOrder;
+    for (uint16_t i = 0; i < count; i++) {
+      uint32_t col = autoWhiteCalc(c[i], aWM);
+      if (pm != POWER_MODEL_NONE) {
+        uint8_t r = R(col), g = G(col), b = B(col);
+        if (correct) { r = (wb[0] * r) / 255; g = (wb[1] * g) / 255; b = (wb[2] * b) / 255; }
+        power += pixelPower(pm, r, g, b, keepW ? W(col) : 0);
+      }
+      col = RGBW32(lutR[R(col)], lutG[G(col)], lutB[B(col)], lutW[W(col)]);
+      uint16_t p = pix + i;
+      if (_reversed) p = _len - p -1;
+      p += _skip;
+      if (perPixelCO) co = _colorOrderMap.getPixelColorOrder(p+_start, _colorOrder);
+      PolyBus::setPixelColor(_busPtr, _iType, p, col, co);
+    }
+  }
+  _powerSum += power;
+}
+
 // returns original color if global buffering is enabled, else returns lossly restored color from bus
 uint32_t BusDigital::getPixelColor(uint16_t pix) {
   if (!_valid) return 0;
@@ -464,33 +573,46 @@ uint8_t BusOnOff::getPins(uint8_t* pinArray) {
 }
 
 
+// protocol type of realtimeBroadcast() for a network bus type
+static uint8_t netUDPType(uint8_t busType) {
+  switch (busType) {
+    case TYPE_NET_ARTNET_RGB: return 2;
+    case TYPE_NET_E131_RGB:   return 1;
+    default:                  return 0; // TYPE_NET_DDP_RGB / TYPE_NET_DDP_RGBW
+  }
+}
+
+void NetSendStats::updateRates(uint32_t now) {
+  uint32_t elapsed = now - rateStart;
+  if (elapsed < 1000) return;
+  packetsPerSec = (uint64_t)(packets - ratePackets) * 1000 / elapsed;
+  bytesPerSec   = (uint64_t)(bytes - rateBytes) * 1000 / elapsed;
+  rateStart   = now;
+  ratePackets = packets;
+  rateBytes   = bytes;
+}
+
 BusNetwork::BusNetwork(BusConfig &bc)
 : Bus(bc.type, bc.start, bc.autoWhite, bc.count)
 , _broadcastLock(false)
+, _packet(nullptr)
+, _stats()
 {
-  switch (bc.type) {
-    case TYPE_NET_ARTNET_RGB:
-      _rgbw = false;
-      _UDPtype = 2;
-      break;
-    case TYPE_NET_E131_RGB:
-      _rgbw = false;
-      _UDPtype = 1;
-      break;
-    default: // TYPE_NET_DDP_RGB / TYPE_NET_DDP_RGBW
-      _rgbw = bc.type == TYPE_NET_DDP_RGBW;
-      _UDPtype = 0;
-      break;
-  }
+  _UDPtype = netUDPType(bc.type);
+  _rgbw = bc.type == TYPE_NET_DDP_RGBW;
   _UDPchannels = _rgbw ? 4 : 3;
   _client = IPAddress(bc.pins[0],bc.pins[1],bc.pins[2],bc.pins[3]);
-  _valid = (allocData(_len * _UDPchannels) != nullptr);
+  _stats.rateStart = millis();
+  if (allocData(_len * _UDPchannels) == nullptr || !allocOutputLUT()) return;
+  _packet = (uint8_t *)calloc(realtimePacketSize(_UDPtype), 1);
+  _valid = _packet != nullptr;
 }
 
 void BusNetwork::setPixelColor(uint16_t pix, uint32_t c) {
   if (!_valid || pix >= _len) return;
   if (_rgbw) c = autoWhiteCalc(c);
-  if (_cct >= 1900) c = colorBalanceFromKelvin(_cct, c); //color correction from CCT
+  prepareOutputLUT(255, _cct); // only white balance, brightness is sent with the data
+  c = RGBW32(_outLUT[0][R(c)], _outLUT[1][G(c)], _outLUT[2][B(c)], W(c));
   uint16_t offset = pix * _UDPchannels;
   _data[offset]   = R(c);
   _data[offset+1] = G(c);
@@ -498,6 +620,21 @@ void BusNetwork::setPixelColor(uint16_t pix, uint32_t c) {
   if (_rgbw) _data[offset+3] = W(c);
 }
 
+void BusNetwork::setPixels(uint16_t pix, const uint32_t *c, uint16_t count) {
+  if (!_valid || pix >= _len) return;
+  if (count > _len - pix) count = _len - pix;
+  const uint8_t aWM = _rgbw ? effectiveAWMode() : RGBW_MODE_MANUAL_ONLY;
+  prepareOutputLUT(255, _cct); // only white balance, brightness is sent with the data
+  uint8_t *d = _data + pix * _UDPchannels;
+  for (uint16_t i = 0; i < count; i++) {
+    uint32_t col = autoWhiteCalc(c[i], aWM);
+    *d++ = _outLUT[0][R(col)];
+    *d++ = _outLUT[1][G(col)];
+    *d++ = _outLUT[2][B(col)];
+    if (_rgbw) *d++ = W(col);
+  }
+}
+
 uint32_t BusNetwork::getPixelColor(uint16_t pix) {
   if (!_valid || pix >= _len) return 0;
   uint16_t offset = pix * _UDPchannels;
@@ -507,7 +644,7 @@ uint32_t BusNetwork::getPixelColor(uint16_t pix) {
 void BusNetwork::show() {
   if (!_valid || !canShow()) return;
   _broadcastLock = true;
-  realtimeBroadcast(_UDPtype, _client, _len, _data, _bri, _rgbw);
+  realtimeBroadcast(_UDPtype, _client, _len, _data, _bri, _rgbw, _packet, &_stats);
   _broadcastLock = false;
 }
 
@@ -522,6 +659,74 @@ void BusNetwork::cleanup() {
   _type = I_NONE;
   _valid = false;
   freeData();
+  free(_packet);
+  _packet = nullptr;
+}
+
+
+uint16_t BusVirtual::_wireTime = 0;
+
+BusVirtual::BusVirtual(BusConfig &bc)
+: Bus(bc.type, bc.start, bc.autoWhite, bc.count, bc.reversed)
+, _frame(nullptr)
+, _frameCount(0)
+, _sendStart(0)
+{
+  _autoWhiteMode = bc.autoWhite; // Bus() only allows auto white for types with a white channel
+  if (allocData(_len * sizeof(uint32_t)) == nullptr || !allocOutputLUT()) return;
+  _frame = (uint32_t*)calloc(_len, sizeof(uint32_t));
+  _valid = (_frame != nullptr);
+}
+
+void BusVirtual::setPixelColor(uint16_t pix, uint32_t c) {
+  if (!_valid || pix >= _len) return;
+  if (_reversed) pix = _len - pix -1;
+  c = autoWhiteCalc(c);
+  prepareOutputLUT(255, _cct); // only white balance, brightness is applied in show()
+  ((uint32_t*)_data)[pix] = RGBW32(_outLUT[0][R(c)], _outLUT[1][G(c)], _outLUT[2][B(c)], W(c));
+}
+
+void BusVirtual::setPixels(uint16_t pix, const uint32_t *c, uint16_t count) {
+  if (!_valid || pix >= _len) return;
+  if (count > _len - pix) count = _len - pix;
+  const uint8_t aWM = effectiveAWMode();
+  prepareOutputLUT(255, _cct);
+  uint32_t *d = (uint32_t*)_data;
+  for (uint16_t i = 0; i < count; i++, pix++) {
+    uint32_t col = autoWhiteCalc(c[i], aWM);
+    d[_reversed ? _len - pix -1 : pix] = RGBW32(_outLUT[0][R(col)], _outLUT[1][G(col)], _outLUT[2][B(col)], W(col));
+  }
+}
+
+uint32_t BusVirtual::getPixelColor(uint16_t pix) {
+  if (!_valid || pix >= _len) return 0;
+  if (_reversed) pix = _len - pix -1;
+  return ((uint32_t*)_data)[pix];
+}
+
+bool BusVirtual::canShow() {
+  return micros() - _sendStart >= (uint32_t)_len * _wireTime;
+}
+
+void BusVirtual::show() {
+  if (!_valid) return;
+  while (!canShow()) yield();
+  _sendStart = micros();
+  const uint32_t *d = (const uint32_t*)_data;
+  const uint16_t scale = _bri + 1; // same scaling as the output LUT
+  for (uint16_t i = 0; i < _len; i++) {
+    uint32_t c = d[i];
+    _frame[i] = RGBW32((R(c)*scale)>>8, (G(c)*scale)>>8, (B(c)*scale)>>8, (W(c)*scale)>>8);
+  }
+  _frameCount++;
+}
+
+void BusVirtual::cleanup() {
+  _type = I_NONE;
+  _valid = false;
+  freeData();
+  free(_frame);
+  _frame = nullptr;
 }
 
 
@@ -544,6 +749,8 @@ uint32_t BusManager::memUsage(BusConfig &bc) {
     #endif
   }
   if (type > 31 && type < 48) return 5;
+  if (type == TYPE_VIRTUAL) return len*8; // working buffer + frame
+  if (type >= TYPE_NET_DDP_RGB && type < 96) return len*(type == TYPE_NET_DDP_RGBW ? 4 : 3) + realtimePacketSize(netUDPType(type));
   return len*3; //RGB
 }
 
@@ -555,12 +762,25 @@ int BusManager::add(BusConfig &bc) {
     busses[numBusses] = new BusDigital(bc, numBusses, colorOrderMap);
   } else if (bc.type == TYPE_ONOFF) {
     busses[numBusses] = new BusOnOff(bc);
+  } else if (bc.type == TYPE_VIRTUAL) {
+    busses[numBusses] = new BusVirtual(bc);
   } else {
     busses[numBusses] = new BusPwm(bc);
   }
+  addRange(busses[numBusses]);
   return numBusses++;
 }
 
+// insert bus into range index (sorted by start)
+void BusManager::addRange(Bus* b) {
+  uint8_t i = numRanges++;
+  uint16_t start = b->getStart();
+  for (; i > 0 && ranges[i-1].start > start; i--) ranges[i] = ranges[i-1];
+  ranges[i].start = start;
+  ranges[i].end   = start + b->getLength();
+  ranges[i].bus   = b;
+}
+
 //do not call this method from system context (network callback)
 void BusManager::removeAll() {
   DEBUG_PRINTLN(F("Removing all."));
@@ -568,6 +788,7 @@ void BusManager::removeAll() {
   while (!canAllShow()) yield();
   for (uint8_t i = 0; i < numBusses; i++) delete busses[i];
   numBusses = 0;
+  numRanges = 0;
 }
 
 void BusManager::show() {
@@ -583,17 +804,25 @@ void BusManager::setStatusPixel(uint32_t c) {
 }
 
 void IRAM_ATTR BusManager::setPixelColor(uint16_t pix, uint32_t c) {
-  for (uint8_t i = 0; i < numBusses; i++) {
-    Bus* b = busses[i];
-    uint16_t bstart = b->getStart();
-    if (pix < bstart || pix >= bstart + b->getLength()) continue;
-    busses[i]->setPixelColor(pix - bstart, c);
+  for (uint8_t i = 0; i < numRanges && ranges[i].start <= pix; i++) { // buses may overlap
+    if (pix >= ranges[i].end) continue;
+    ranges[i].bus->setPixelColor(pix - ranges[i].start, c);
+  }
+}
+
+void IRAM_ATTR BusManager::setPixels(uint16_t pix, const uint32_t *c, uint16_t count) {
+  const uint32_t end = pix + count;
+  for (uint8_t i = 0; i < numRanges && ranges[i].start < end; i++) {
+    if (pix >= ranges[i].end) continue;
+    uint16_t s = max(pix, ranges[i].start);
+    uint16_t e = min(end, (uint32_t)ranges[i].end);
+    ranges[i].bus->setPixels(s - ranges[i].start, c + (s - pix), e - s);
   }
 }
 
-void BusManager::setBrightness(uint8_t b) {
+void BusManager::setBrightness(uint8_t b, bool immediate) {
   for (uint8_t i = 0; i < numBusses; i++) {
-    busses[i]->setBrightness(b);
+    busses[i]->setBrightness(b, immediate);
   }
 }
 
@@ -607,11 +836,9 @@ void BusManager::setSegmentCCT(int16_t cct, bool allowWBCorrection) {
 }
 
 uint32_t BusManager::getPixelColor(uint16_t pix) {
-  for (uint8_t i = 0; i < numBusses; i++) {
-    Bus* b = busses[i];
-    uint16_t bstart = b->getStart();
-    if (pix < bstart || pix >= bstart + b->getLength()) continue;
-    return b->getPixelColor(pix - bstart);
+  for (uint8_t i = 0; i < numRanges && ranges[i].start <= pix; i++) {
+    if (pix >= ranges[i].end) continue;
+    return ranges[i].bus->getPixelColor(pix - ranges[i].start);
   }
   return 0;
 }
@@ -639,3 +866,5 @@ uint16_t BusManager::getTotalLength() {
 int16_t Bus::_cct = -1;
 uint8_t Bus::_cctBlend = 0;
 uint8_t Bus::_gAWM = 255;
+uint8_t Bus::_powerModel = POWER_MODEL_NONE;
+
@@ -35,8 +35,9 @@ struct BusConfig {
   uint8_t pins[5] = {LEDPIN, 255, 255, 255, 255};
   uint16_t frequency;
   bool doubleBuffer;
+  uint16_t milliAmpsMax; // per bus current limit (0 = only global limit applies)
 
-  BusConfig(uint8_t busType, uint8_t* ppins, uint16_t pstart, uint16_t len = 1, uint8_t pcolorOrder = COL_ORDER_GRB, bool rev = false, uint8_t skip = 0, byte aw=RGBW_MODE_MANUAL_ONLY, uint16_t clock_kHz=0U, bool dblBfr=false)
+  BusConfig(uint8_t busType, uint8_t* ppins, uint16_t pstart, uint16_t len = 1, uint8_t pcolorOrder = COL_ORDER_GRB, bool rev = false, uint8_t skip = 0, byte aw=RGBW_MODE_MANUAL_ONLY, uint16_t clock_kHz=0U, bool dblBfr=false, uint16_t maxPwr=0)
   : count(len)
   , start(pstart)
   , colorOrder(pcolorOrder)
@@ -45,6 +46,7 @@ struct BusConfig {
   , autoWhite(aw)
   , frequency(clock_kHz)
   , doubleBuffer(dblBfr)
+  , milliAmpsMax(maxPwr)
   {
     refreshReq = (bool) GET_BIT(busType,7);
     type = busType & 0x7F;  // bit 7 may be/is hacked to include refresh info (1=refresh in off state, 0=no refresh)
@@ -113,18 +115,23 @@ class Bus {
     , _valid(false)
     , _needsRefresh(refresh)
     , _data(nullptr) // keep data access consistent across all types of buses
+    , _outLUT(nullptr)
+    , _outLUTBri(0)
+    , _outLUTKelvin(-1) // invalid, forces initial build
+    , _wbKelvin(-1)
     {
       _autoWhiteMode = Bus::hasWhite(type) ? aw : RGBW_MODE_MANUAL_ONLY;
     };
 
-    virtual ~Bus() {} //throw the bus under the bus
+    virtual ~Bus() { free(_outLUT); } //throw the bus under the bus
 
     virtual void     show() = 0;
     virtual bool     canShow()                   { return true; }
     virtual void     setStatusPixel(uint32_t c)  {}
     virtual void     setPixelColor(uint16_t pix, uint32_t c) = 0;
+    virtual void     setPixels(uint16_t pix, const uint32_t *c, uint16_t count); // set a contiguous run of pixels
     virtual uint32_t getPixelColor(uint16_t pix) { return 0; }
-    virtual void     setBrightness(uint8_t b)    { _bri = b; };
+    virtual void     setBrightness(uint8_t b, bool immediate=false) { _bri = b; };
     virtual void     cleanup() = 0;
     virtual uint8_t  getPins(uint8_t* pinArray)  { return 0; }
     virtual uint16_t getLength()                 { return _len; }
@@ -132,10 +139,13 @@ class Bus {
     virtual uint8_t  getColorOrder()             { return COL_ORDER_RGB; }
     virtual uint8_t  skippedLeds()               { return 0; }
     virtual uint16_t getFrequency()              { return 0U; }
+    virtual uint16_t getMaxCurrent()             { return 0; }  // per bus ABL limit in mA (0 = none)
+    virtual uint32_t getPowerSum()               { return 0; }  // ABL channel sum of the pixels set by setPixels() since last show()
     inline  void     setReversed(bool reversed)  { _reversed = reversed; }
     inline  uint16_t getStart()                  { return _start; }
     inline  void     setStart(uint16_t start)    { _start = start; }
     inline  uint8_t  getType()                   { return _type; }
+    inline  uint8_t  getBrightness()             { return _bri; }
     inline  bool     isOk()                      { return _valid; }
     inline  bool     isReversed()                { return _reversed; }
     inline  bool     isOffRefreshRequired()      { return _needsRefresh; }
@@ -174,6 +184,15 @@ class Bus {
     inline        uint8_t getAutoWhiteMode()          { return _autoWhiteMode; }
     inline static void    setGlobalAWMode(uint8_t m)  { if (m < 5) _gAWM = m; else _gAWM = AW_GLOBAL_DISABLED; }
     inline static uint8_t getGlobalAWMode()           { return _gAWM; }
+    inline static void    setPowerModel(uint8_t m)    { _powerModel = m; }
+    // ABL "power units" of a single (unscaled) pixel
+    static inline uint32_t pixelPower(uint8_t powerModel, uint8_t r, uint8_t g, uint8_t b, uint8_t w) {
+      if (powerModel == POWER_MODEL_WS2815) return (r > g ? (r > b ? r : b) : (g > b ? g : b)) * 3; // ignore white component
+      return r + g + b + w;
+    }
+    inline        uint8_t effectiveAWMode() const     { return _gAWM != AW_GLOBAL_DISABLED ? _gAWM : _autoWhiteMode; }
+    static        uint32_t autoWhiteCalc(uint32_t c, uint8_t aWM);
+    inline        uint32_t autoWhiteCalc(uint32_t c)  { return autoWhiteCalc(c, effectiveAWMode()); }
 
   protected:
     uint8_t  _type;
@@ -188,8 +207,17 @@ class Bus {
     static uint8_t _gAWM;
     static int16_t _cct;
     static uint8_t _cctBlend;
+    static uint8_t _powerModel; // POWER_MODEL_*, how pixels are accounted for ABL
+
+    uint8_t (*_outLUT)[256];  // fused output transform (white balance & brightness) for R, G, B and W, per bus
+    uint8_t  _outLUTBri;
+    int16_t  _outLUTKelvin;
+    int16_t  _wbKelvin;
+    uint8_t  _wbCorr[3];      // white balance correction for _wbKelvin
 
-    uint32_t autoWhiteCalc(uint32_t c);
+    bool     allocOutputLUT() { return (_outLUT = (uint8_t (*)[256])malloc(4*256)) != nullptr; }
+    void     prepareOutputLUT(uint8_t bri, int16_t kelvin); // kelvin < 1900: no white balance correction
+    const uint8_t *whiteBalance(int16_t kelvin);            // R, G and B correction (255: none)
     uint8_t *allocData(size_t size = 1);
     void     freeData() { if (_data != nullptr) free(_data); _data = nullptr; }
 };
@@ -202,15 +230,18 @@ class BusDigital : public Bus {
 
     void show();
     bool canShow();
-    void setBrightness(uint8_t b);
+    void setBrightness(uint8_t b, bool immediate);
     void setStatusPixel(uint32_t c);
     void setPixelColor(uint16_t pix, uint32_t c);
+    void setPixels(uint16_t pix, const uint32_t *c, uint16_t count);
     void setColorOrder(uint8_t colorOrder);
     uint32_t getPixelColor(uint16_t pix);
     uint8_t  getColorOrder() { return _colorOrder; }
     uint8_t  getPins(uint8_t* pinArray);
     uint8_t  skippedLeds()   { return _skip; }
     uint16_t getFrequency()  { return _frequencykHz; }
+    uint16_t getMaxCurrent() { return _milliAmpsMax; }
+    uint32_t getPowerSum()   { return _powerSum; }
     void reinit();
     void cleanup();
 
@@ -223,6 +254,8 @@ class BusDigital : public Bus {
     void * _busPtr;
     const ColorOrderMap &_colorOrderMap;
     bool _buffering; // temporary until we figure out why comparison "_data != nullptr" causes severe FPS drop
+    uint16_t _milliAmpsMax;
+    uint32_t _powerSum;   // running ABL channel sum, accumulated in setPixels() and cleared in show()
 
     inline uint32_t restoreColorLossy(uint32_t c, uint8_t restoreBri) {
       if (restoreBri < 255) {
@@ -278,6 +311,21 @@ class BusOnOff : public Bus {
 };
 
 
+// packets and bytes (headers included) a network bus handed to the UDP stack
+struct NetSendStats {
+  uint32_t packets;
+  uint32_t bytes;
+  uint32_t errors;          // packets the UDP stack refused
+  uint32_t packetsPerSec;   // rates over the last completed interval of at least a second
+  uint32_t bytesPerSec;
+  uint32_t rateStart;       // millis() the current interval started
+  uint32_t ratePackets;     // totals at rateStart
+  uint32_t rateBytes;
+
+  inline void sent(size_t len, bool ok) { if (ok) { packets++; bytes += len; } else errors++; }
+  void updateRates(uint32_t now);
+};
+
 class BusNetwork : public Bus {
   public:
     BusNetwork(BusConfig &bc);
@@ -287,23 +335,58 @@ class BusNetwork : public Bus {
     bool hasWhite() { return _rgbw; }
     bool canShow()  { return !_broadcastLock; } // this should be a return value from UDP routine if it is still sending data out
     void setPixelColor(uint16_t pix, uint32_t c);
+    void setPixels(uint16_t pix, const uint32_t *c, uint16_t count);
     uint32_t getPixelColor(uint16_t pix);
     uint8_t  getPins(uint8_t* pinArray);
     void show();
     void cleanup();
 
+    inline uint8_t getUDPType() const        { return _UDPtype; } // 0: DDP, 1: E1.31, 2: Art-Net
+    inline const NetSendStats& getSendStats() { _stats.updateRates(millis()); return _stats; }
+
   private:
     IPAddress _client;
     uint8_t   _UDPtype;
     uint8_t   _UDPchannels;
     bool      _rgbw;
     bool      _broadcastLock;
+    uint8_t  *_packet;        // packets are built here, see realtimeBroadcast()
+    NetSendStats _stats;
+};
+
+
+// in-memory bus: keeps the last shown frame (brightness & white balance applied) for the native simulator and benchmarks
+class BusVirtual : public Bus {
+  public:
+    BusVirtual(BusConfig &bc);
+    ~BusVirtual() { cleanup(); }
+
+    bool hasRGB()   { return true; }
+    bool hasWhite() { return true; }
+    void setPixelColor(uint16_t pix, uint32_t c);
+    void setPixels(uint16_t pix, const uint32_t *c, uint16_t count);
+    uint32_t getPixelColor(uint16_t pix);
+    bool canShow();
+    void show();
+    void cleanup();
+
+    inline const uint32_t* getFrame() const      { return _frame; }      // RGBW32 per pixel, as it would be sent to the LEDs
+    inline uint32_t        getFrameCount() const { return _frameCount; } // number of show() calls
+
+    // simulated transmission time per pixel in us (WS281x: 30), show() waits for the previous frame like NeoPixelBus does
+    static void setWireTime(uint16_t us) { _wireTime = us; }
+
+  private:
+    uint32_t *_frame;
+    uint32_t  _frameCount;
+    uint32_t  _sendStart;
+    static uint16_t _wireTime;
 };
 
 
 class BusManager {
   public:
-    BusManager() : numBusses(0) {};
+    BusManager() : numBusses(0), numRanges(0) {};
 
     //utility to get the approx. memory usage of a given BusConfig
     static uint32_t memUsage(BusConfig &bc);
@@ -317,7 +400,8 @@ class BusManager {
     bool canAllShow();
     void setStatusPixel(uint32_t c);
     void setPixelColor(uint16_t pix, uint32_t c);
-    void setBrightness(uint8_t b);
+    void setPixels(uint16_t pix, const uint32_t *c, uint16_t count); // push a run of pixels (e.g. whole frame) bus-by-bus
+    void setBrightness(uint8_t b, bool immediate = false); // immediate: repaint pixels already sent to buses
     void setSegmentCCT(int16_t cct, bool allowWBCorrection = false);
     uint32_t getPixelColor(uint16_t pix);
 
@@ -335,6 +419,16 @@ class BusManager {
     Bus* busses[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
     ColorOrderMap colorOrderMap;
 
+    // bus range index sorted by start (avoids virtual calls when looking up the bus of a pixel)
+    struct BusRange {
+      uint16_t start;
+      uint16_t end;   // exclusive
+      Bus*     bus;
+    } ranges[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
+    uint8_t numRanges;
+
+    void addRange(Bus* b);
+
     inline uint8_t getNumVirtualBusses() {
       int j = 0;
       for (int i=0; i<numBusses; i++) if (busses[i]->getType() >= TYPE_NET_DDP_RGB && busses[i]->getType() < 96) j++;
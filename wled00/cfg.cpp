@@ -89,8 +89,18 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   CJSON(strip.cctBlending, hw_led[F("cb")]);
   Bus::setCCTBlend(strip.cctBlending);
   strip.setTargetFps(hw_led["fps"]); //NOP if 0, default 42 FPS
+  strip.setRenderBudget(hw_led[F("rbudget")] | strip.getRenderBudget()); // µs, 0 = one frame period
   CJSON(useGlobalLedBuffer, hw_led[F("ld")]);
 
+  JsonObject hw_led_e131 = hw_led[F("e131")]; // E1.31 network bus output
+  CJSON(e131OutUniverse, hw_led_e131[F("uni")]);
+  if (e131OutUniverse == 0) e131OutUniverse = 1;
+  CJSON(e131OutPriority, hw_led_e131[F("prio")]);
+  if (e131OutPriority > 200) e131OutPriority = 200;
+  CJSON(e131OutSyncUniverse, hw_led_e131[F("sync")]);
+  const char *cid = hw_led_e131[F("cid")];
+  if (cid != nullptr) setE131OutCID(cid); // 32 hex digits, dashes are ignored
+
   #ifndef WLED_DISABLE_2D
   // 2D Matrix Settings
   JsonObject matrix = hw_led[F("matrix")];
@@ -159,8 +169,9 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
       uint16_t freqkHz = elm[F("freq")] | 0;  // will be in kHz for DotStar and Hz for PWM (not yet implemented fully)
       ledType |= refresh << 7; // hack bit 7 to indicate strip requires off refresh
       uint8_t AWmode = elm[F("rgbwm")] | RGBW_MODE_MANUAL_ONLY;
+      uint16_t maxPwr = elm[F("maxpwr")] | 0; // per bus ABL current limit
       if (fromFS) {
-        BusConfig bc = BusConfig(ledType, pins, start, length, colorOrder, reversed, skipFirst, AWmode, freqkHz, useGlobalLedBuffer);
+        BusConfig bc = BusConfig(ledType, pins, start, length, colorOrder, reversed, skipFirst, AWmode, freqkHz, useGlobalLedBuffer, maxPwr);
         mem += BusManager::memUsage(bc);
         if (useGlobalLedBuffer && start + length > maxlen) {
           maxlen = start + length;
@@ -169,7 +180,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
         if (mem + globalBufMem <= MAX_LED_MEMORY) if (busses.add(bc) == -1) break;  // finalization will be done in WLED::beginStrip()
       } else {
         if (busConfigs[s] != nullptr) delete busConfigs[s];
-        busConfigs[s] = new BusConfig(ledType, pins, start, length, colorOrder, reversed, skipFirst, AWmode, freqkHz, useGlobalLedBuffer);
+        busConfigs[s] = new BusConfig(ledType, pins, start, length, colorOrder, reversed, skipFirst, AWmode, freqkHz, useGlobalLedBuffer, maxPwr);
         busesChanged = true;
       }
       s++;
@@ -384,6 +395,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   JsonObject if_sync = interfaces["sync"];
   CJSON(udpPort, if_sync[F("port0")]); // 21324
   CJSON(udpPort2, if_sync[F("port1")]); // 65506
+  CJSON(udpRxBudgetUs, if_sync[F("budget")]); // µs
 
   JsonObject if_sync_recv = if_sync["recv"];
   CJSON(receiveNotificationBrightness, if_sync_recv["bri"]);
@@ -421,6 +433,9 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   JsonObject if_live_dmx = if_live[F("dmx")];
   CJSON(e131Universe, if_live_dmx[F("uni")]);
   CJSON(e131SkipOutOfSequence, if_live_dmx[F("seqskip")]);
+  CJSON(e131FrameSync, if_live_dmx[F("fsync")]);
+  CJSON(e131FrameTimeout, if_live_dmx[F("ftimeout")]);
+  if (e131FrameTimeout < 5) e131FrameTimeout = 5;
   CJSON(DMXAddress, if_live_dmx[F("addr")]);
   if (!DMXAddress || DMXAddress > 510) DMXAddress = 1;
   CJSON(DMXSegmentSpacing, if_live_dmx[F("dss")]);
@@ -718,9 +733,18 @@ void serializeConfig() {
   hw_led[F("cr")] = cctFromRgb;
   hw_led[F("cb")] = strip.cctBlending;
   hw_led["fps"] = strip.getTargetFps();
+  hw_led[F("rbudget")] = strip.getRenderBudget();
   hw_led[F("rgbwm")] = Bus::getGlobalAWMode(); // global auto white mode override
   hw_led[F("ld")] = useGlobalLedBuffer;
 
+  JsonObject hw_led_e131 = hw_led.createNestedObject(F("e131"));
+  hw_led_e131[F("uni")] = e131OutUniverse;
+  hw_led_e131[F("prio")] = e131OutPriority;
+  hw_led_e131[F("sync")] = e131OutSyncUniverse;
+  char cid[33];
+  getE131OutCID(cid);
+  hw_led_e131[F("cid")] = cid;
+
   #ifndef WLED_DISABLE_2D
   // 2D Matrix Settings
   if (strip.isMatrix) {
@@ -760,6 +784,7 @@ void serializeConfig() {
     ins["ref"] = bus->isOffRefreshRequired();
     ins[F("rgbwm")] = bus->getAutoWhiteMode();
     ins[F("freq")] = bus->getFrequency();
+    ins[F("maxpwr")] = bus->getMaxCurrent();
   }
 
   JsonArray hw_com = hw.createNestedArray(F("com"));
@@ -851,6 +876,7 @@ void serializeConfig() {
   JsonObject if_sync = interfaces.createNestedObject("sync");
   if_sync[F("port0")] = udpPort;
   if_sync[F("port1")] = udpPort2;
+  if_sync[F("budget")] = udpRxBudgetUs;
 
   JsonObject if_sync_recv = if_sync.createNestedObject("recv");
   if_sync_recv["bri"] = receiveNotificationBrightness;
@@ -882,6 +908,8 @@ void serializeConfig() {
   JsonObject if_live_dmx = if_live.createNestedObject("dmx");
   if_live_dmx[F("uni")] = e131Universe;
   if_live_dmx[F("seqskip")] = e131SkipOutOfSequence;
+  if_live_dmx[F("fsync")] = e131FrameSync;
+  if_live_dmx[F("ftimeout")] = e131FrameTimeout;
   if_live_dmx[F("e131prio")] = e131Priority;
   if_live_dmx[F("addr")] = DMXAddress;
   if_live_dmx[F("dss")] = DMXSegmentSpacing;
@@ -4,6 +4,46 @@
  * Color conversion & utility methods
  */
 
+/*
+ * SWAR helpers: a RGBW32 color is processed as two 16 bit lanes per 32 bit word (B|R and G|W),
+ * each lane holds one 8 bit channel plus 8 bits of headroom for products and carries
+ */
+#define SWAR_RB 0x00FF00FFu
+#define SWAR_GW 0xFF00FF00u
+
+#if defined(FASTLED_SCALE8_FIXED) && FASTLED_SCALE8_FIXED == 0
+#define SWAR_SCALE8(s) (uint32_t(s))     // scale8(): (i * scale) >> 8
+#else
+#define SWAR_SCALE8(s) (uint32_t(s) + 1) // scale8(): (i * (scale+1)) >> 8 (FastLED default)
+#endif
+
+// (channel * scale) >> 8 for all 4 channels, scale <= 256
+static inline uint32_t swar_scale(uint32_t c, uint32_t scale) {
+  return ((((c & SWAR_RB) * scale) >> 8) & SWAR_RB) | (((c >> 8) & SWAR_RB) * scale & SWAR_GW);
+}
+
+// 0x01 in every byte that is not 0
+static inline uint32_t swar_nonzero(uint32_t c) {
+  return ((((c & 0x7F7F7F7Fu) + 0x7F7F7F7Fu) | c) >> 7) & 0x01010101u;
+}
+
+// (c2 * blend + c1 * (255-blend)) >> 8 for all 4 channels
+static inline uint32_t swar_blend8(uint32_t c1, uint32_t c2, uint32_t blend) {
+  uint32_t inv = 255 - blend;
+  uint32_t rb = (((c2 & SWAR_RB) * blend + (c1 & SWAR_RB) * inv) >> 8) & SWAR_RB;
+  uint32_t gw = (((c2 >> 8) & SWAR_RB) * blend + ((c1 >> 8) & SWAR_RB) * inv) & SWAR_GW;
+  return rb | gw;
+}
+
+// qadd8() for all 4 channels
+static inline uint32_t swar_qadd(uint32_t c1, uint32_t c2) {
+  uint32_t rb = (c1 & SWAR_RB) + (c2 & SWAR_RB);
+  uint32_t gw = ((c1 >> 8) & SWAR_RB) + ((c2 >> 8) & SWAR_RB);
+  rb |= 0x01000100u - ((rb >> 8) & 0x00010001u); // lanes that overflowed become 0x..FF
+  gw |= 0x01000100u - ((gw >> 8) & 0x00010001u);
+  return (rb & SWAR_RB) | ((gw & SWAR_RB) << 8);
+}
+
 /*
  * color blend function
  */
@@ -11,7 +51,7 @@ uint32_t color_blend(uint32_t color1, uint32_t color2, uint16_t blend, bool b16)
   if(blend == 0)   return color1;
   uint16_t blendmax = b16 ? 0xFFFF : 0xFF;
   if(blend == blendmax) return color2;
-  uint8_t shift = b16 ? 16 : 8;
+  if (!b16) return swar_blend8(color1, color2, blend);
 
   uint32_t w1 = W(color1);
   uint32_t r1 = R(color1);
@@ -23,10 +63,10 @@ uint32_t color_blend(uint32_t color1, uint32_t color2, uint16_t blend, bool b16)
   uint32_t g2 = G(color2);
   uint32_t b2 = B(color2);
 
-  uint32_t w3 = ((w2 * blend) + (w1 * (blendmax - blend))) >> shift;
-  uint32_t r3 = ((r2 * blend) + (r1 * (blendmax - blend))) >> shift;
-  uint32_t g3 = ((g2 * blend) + (g1 * (blendmax - blend))) >> shift;
-  uint32_t b3 = ((b2 * blend) + (b1 * (blendmax - blend))) >> shift;
+  uint32_t w3 = ((w2 * blend) + (w1 * (blendmax - blend))) >> 16;
+  uint32_t r3 = ((r2 * blend) + (r1 * (blendmax - blend))) >> 16;
+  uint32_t g3 = ((g2 * blend) + (g1 * (blendmax - blend))) >> 16;
+  uint32_t b3 = ((b2 * blend) + (b1 * (blendmax - blend))) >> 16;
 
   return RGBW32(r3, g3, b3, w3);
 }
@@ -37,28 +77,19 @@ uint32_t color_blend(uint32_t color1, uint32_t color2, uint16_t blend, bool b16)
  */
 uint32_t color_add(uint32_t c1, uint32_t c2, bool fast)
 {
-  if (fast) {
-    uint8_t r = R(c1);
-    uint8_t g = G(c1);
-    uint8_t b = B(c1);
-    uint8_t w = W(c1);
-    r = qadd8(r, R(c2));
-    g = qadd8(g, G(c2));
-    b = qadd8(b, B(c2));
-    w = qadd8(w, W(c2));
-    return RGBW32(r,g,b,w);
-  } else {
-    uint32_t r = R(c1) + R(c2);
-    uint32_t g = G(c1) + G(c2);
-    uint32_t b = B(c1) + B(c2);
-    uint32_t w = W(c1) + W(c2);
-    uint16_t max = r;
-    if (g > max) max = g;
-    if (b > max) max = b;
-    if (w > max) max = w;
-    if (max < 256) return RGBW32(r, g, b, w);
-    else           return RGBW32(r * 255 / max, g * 255 / max, b * 255 / max, w * 255 / max);
-  }
+  if (fast) return swar_qadd(c1, c2);
+  uint32_t rb = (c1 & SWAR_RB) + (c2 & SWAR_RB);
+  uint32_t gw = ((c1 >> 8) & SWAR_RB) + ((c2 >> 8) & SWAR_RB);
+  if (!((rb | gw) & 0x01000100u)) return rb | (gw << 8); // no channel overflows
+  uint32_t r = rb >> 16;
+  uint32_t g = gw & 0xFFFF;
+  uint32_t b = rb & 0xFFFF;
+  uint32_t w = gw >> 16;
+  uint16_t max = r;
+  if (g > max) max = g;
+  if (b > max) max = b;
+  if (w > max) max = w;
+  return RGBW32(r * 255 / max, g * 255 / max, b * 255 / max, w * 255 / max);
 }
 
 /*
@@ -67,22 +98,101 @@ uint32_t color_add(uint32_t c1, uint32_t c2, bool fast)
  */
 uint32_t color_fade(uint32_t c1, uint8_t amount, bool video)
 {
-  uint8_t r = R(c1);
-  uint8_t g = G(c1);
-  uint8_t b = B(c1);
-  uint8_t w = W(c1);
+  if (video) return swar_scale(c1, amount) + (amount ? swar_nonzero(c1) : 0); // scale8_video()
+  return swar_scale(c1, SWAR_SCALE8(amount));                                   // scale8()
+}
+
+/*
+ * bulk versions of the above for contiguous RGBW32 buffers (segment pixel buffers), results are identical
+ * to calling the single color functions for each pixel
+ * hosts with SIMD units (native build) process the buffer bytewise so the compiler can vectorize the loops,
+ * everything else (ESP32/S3/C3/ESP8266) uses the SWAR helpers: one 32 bit word holds a complete pixel
+ */
+#if defined(WLED_NATIVE) && (defined(__SSE2__) || defined(__ARM_NEON))
+#define WLED_COLOR_VECTORIZE
+#define VECTORIZE __attribute__((optimize("tree-vectorize", "vect-cost-model=dynamic"))) // -O2 only vectorizes trivial loops
+#else
+#define VECTORIZE
+#endif
+
+void color_fill_buf(uint32_t *buf, size_t len, uint32_t c)
+{
+  for (size_t i = 0; i < len; i++) buf[i] = c;
+}
+
+VECTORIZE void color_fade_buf(uint32_t *buf, size_t len, uint8_t amount, bool video)
+{
+  if (!video && amount == 255 && SWAR_SCALE8(255) == 256) return;
+#ifdef WLED_COLOR_VECTORIZE
+  uint8_t *p = reinterpret_cast<uint8_t*>(buf);
   if (video) {
-    r = scale8_video(r, amount);
-    g = scale8_video(g, amount);
-    b = scale8_video(b, amount);
-    w = scale8_video(w, amount);
+    uint8_t add = amount ? 1 : 0;
+    for (size_t i = 0; i < len*4; i++) p[i] = ((p[i] * amount) >> 8) + (p[i] ? add : 0);
   } else {
-    r = scale8(r, amount);
-    g = scale8(g, amount);
-    b = scale8(b, amount);
-    w = scale8(w, amount);
+    uint16_t scale = SWAR_SCALE8(amount);
+    for (size_t i = 0; i < len*4; i++) p[i] = (p[i] * scale) >> 8;
+  }
+#else
+  if (video) {
+    if (amount) for (size_t i = 0; i < len; i++) buf[i] = swar_scale(buf[i], amount) + swar_nonzero(buf[i]);
+    else        color_fill_buf(buf, len, 0);
+  } else {
+    uint32_t scale = SWAR_SCALE8(amount);
+    for (size_t i = 0; i < len; i++) buf[i] = swar_scale(buf[i], scale);
+  }
+#endif
+}
+
+// dst = color_blend(dst, src, blend)
+VECTORIZE void color_blend_buf(uint32_t *dst, const uint32_t *src, size_t len, uint16_t blend, bool b16)
+{
+  if (blend == 0) return;
+  if (blend == (b16 ? 0xFFFF : 0xFF)) { memmove(dst, src, len * sizeof(uint32_t)); return; }
+  if (b16) {
+    for (size_t i = 0; i < len; i++) dst[i] = color_blend(dst[i], src[i], blend, true);
+    return;
+  }
+#ifdef WLED_COLOR_VECTORIZE
+  uint8_t *d = reinterpret_cast<uint8_t*>(dst);
+  const uint8_t *s = reinterpret_cast<const uint8_t*>(src);
+  uint16_t inv = 255 - blend;
+  for (size_t i = 0; i < len*4; i++) d[i] = (s[i] * blend + d[i] * inv) >> 8;
+#else
+  for (size_t i = 0; i < len; i++) dst[i] = swar_blend8(dst[i], src[i], blend);
+#endif
+}
+
+// dst = color_add(dst, src, fast)
+VECTORIZE void color_add_buf(uint32_t *dst, const uint32_t *src, size_t len, bool fast)
+{
+  if (!fast) {
+    for (size_t i = 0; i < len; i++) dst[i] = color_add(dst[i], src[i]);
+    return;
+  }
+#ifdef WLED_COLOR_VECTORIZE
+  uint8_t *d = reinterpret_cast<uint8_t*>(dst);
+  const uint8_t *s = reinterpret_cast<const uint8_t*>(src);
+  for (size_t i = 0; i < len*4; i++) { unsigned t = d[i] + s[i]; d[i] = t > 255 ? 255 : t; }
+#else
+  for (size_t i = 0; i < len; i++) dst[i] = swar_qadd(dst[i], src[i]);
+#endif
+}
+
+// 1D blur of a buffer, same as Segment::blur() on a 1D segment: each pixel keeps 255-amount and seeps amount/2 to each neighbour
+void color_blur_buf(uint32_t *buf, size_t len, uint8_t amount)
+{
+  if (len == 0 || amount == 0) return;
+  uint32_t keep = SWAR_SCALE8(255 - amount);
+  uint32_t seep = SWAR_SCALE8(amount >> 1);
+  uint32_t carryover = 0;
+  for (size_t i = 0; i < len; i++) {
+    uint32_t cur  = buf[i];
+    uint32_t part = swar_scale(cur, seep);
+    cur = swar_qadd(swar_scale(cur, keep), carryover);
+    if (i > 0) buf[i-1] = swar_qadd(buf[i-1], part);
+    buf[i] = cur;
+    carryover = part;
   }
-  return RGBW32(r, g, b, w);
 }
 
 void setRandomColor(byte* rgb)
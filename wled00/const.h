@@ -66,6 +66,15 @@
   #endif
 #endif
 
+// additional tasks rendering segments in parallel with the loop task (see render_pool.h), 0 renders serially
+#ifndef WLED_RENDER_TASKS
+  #if defined(WLED_NATIVE) || (defined(ARDUINO_ARCH_ESP32) && !defined(CONFIG_FREERTOS_UNICORE))
+    #define WLED_RENDER_TASKS 1
+  #else
+    #define WLED_RENDER_TASKS 0
+  #endif
+#endif
+
 #ifndef WLED_MAX_BUTTONS
   #ifdef ESP8266
     #define WLED_MAX_BUTTONS 2
@@ -226,6 +235,7 @@
 
 #define TYPE_NONE                 0            //light is not configured
 #define TYPE_RESERVED             1            //unused. Might indicate a "virtual" light
+#define TYPE_VIRTUAL              2            //in-memory RGBW bus capturing frames (native simulator, tests)
 //Digital types (data pin only) (16-31)
 #define TYPE_WS2812_1CH          18            //white-only chips (1 channel per IC) (unused)
 #define TYPE_WS2812_1CH_X3       19            //white-only chips (3 channels per IC)
@@ -254,7 +264,7 @@
 #define TYPE_LPD6803             54
 //Network types (master broadcast) (80-95)
 #define TYPE_NET_DDP_RGB         80            //network DDP RGB bus (master broadcast bus)
-#define TYPE_NET_E131_RGB        81            //network E131 RGB bus (master broadcast bus, unused)
+#define TYPE_NET_E131_RGB        81            //network E131 RGB bus (master broadcast bus)
 #define TYPE_NET_ARTNET_RGB      82            //network ArtNet RGB bus (master broadcast bus, unused)
 #define TYPE_NET_DDP_RGBW        88            //network DDP RGBW bus (master broadcast bus)
 
@@ -318,6 +328,8 @@
 #define SEG_OPTION_REVERSED_Y     6
 #define SEG_OPTION_MIRROR_Y       7
 #define SEG_OPTION_TRANSPOSED     8
+//options affecting logical to physical pixel mapping (reverse, mirror, reverse Y, mirror Y & transpose)
+#define SEG_MAPPING_OPTIONS       ((1<<SEG_OPTION_REVERSED) | (1<<SEG_OPTION_MIRROR) | (1<<SEG_OPTION_REVERSED_Y) | (1<<SEG_OPTION_MIRROR_Y) | (1<<SEG_OPTION_TRANSPOSED))
 
 //Segment differs return byte
 #define SEG_DIFFERS_BRI        0x01 // opacity
@@ -431,6 +443,11 @@
   #endif
 #endif
 
+// how pixels are accounted for ABL (Bus::setPowerModel())
+#define POWER_MODEL_NONE     0    // ABL disabled, no accounting
+#define POWER_MODEL_CHANNELS 1    // sum of all channels
+#define POWER_MODEL_WS2815   2    // brightest RGB channel x3, white is ignored
+
 // PWM settings
 #ifndef WLED_PWM_FREQ
 #ifdef ESP8266
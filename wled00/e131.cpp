@@ -1,8 +1,15 @@
 #include "wled.h"
+#ifdef WLED_NATIVE
+  #include <mutex>
+#elif defined(ARDUINO_ARCH_ESP32)
+  #include <freertos/semphr.h>
+#endif
 
 #define MAX_3_CH_LEDS_PER_UNIVERSE 170
 #define MAX_4_CH_LEDS_PER_UNIVERSE 128
 #define MAX_CHANNELS_PER_UNIVERSE 512
+#define E131_FRAME_SLOT 513   // buffered bytes per universe (E1.31 data starts with the start code)
+#define E131_SYNC_HOLD_MS 2500 // stop waiting for sync packets if none arrived for this long (E1.31: 6.7.1)
 
 /*
  * E1.31 handler
@@ -29,18 +36,14 @@ void handleDDPPacket(e131_packet_t* p) {
 
   uint32_t start =  htonl(p->channelOffset) / ddpChannelsPerLed;
   start += DMXAddress / ddpChannelsPerLed;
-  uint16_t stop = start + htons(p->dataLen) / ddpChannelsPerLed;
+  uint16_t count = htons(p->dataLen) / ddpChannelsPerLed;
   uint8_t* data = p->data;
-  uint16_t c = 0;
-  if (p->flags & DDP_TIMECODE_FLAG) c = 4; //packet has timecode flag, we do not support it, but data starts 4 bytes later
+  if (p->flags & DDP_TIMECODE_FLAG) data += 4; //packet has timecode flag, we do not support it, but data starts 4 bytes later
 
   realtimeLock(realtimeTimeoutMs, REALTIME_MODE_DDP);
 
   if (!realtimeOverride || (realtimeMode && useMainSegmentOnly)) {
-    for (uint16_t i = start; i < stop; i++) {
-      setRealtimePixel(i, data[c], data[c+1], data[c+2], ddpChannelsPerLed >3 ? data[c+3] : 0);
-      c += ddpChannelsPerLed;
-    }
+    realtimeWrite(start, data, count, ddpChannelsPerLed);
   }
 
   bool push = p->flags & DDP_PUSH_FLAG;
@@ -51,12 +54,185 @@ void handleDDPPacket(e131_packet_t* p) {
   }
 }
 
+static void applyE131Universe(uint16_t uni, uint8_t* e131_data, uint16_t dmxChannels, byte protocol);
+
+// number of universes needed for all LEDs in the DMX mode (only DMX_MODE_MULTIPLE_* span more than one)
+static uint8_t e131UniverseCount() {
+  if (DMXMode != DMX_MODE_MULTIPLE_RGB && DMXMode != DMX_MODE_MULTIPLE_RGBW && DMXMode != DMX_MODE_MULTIPLE_DRGB) return 1;
+
+  bool is4Chan = (DMXMode == DMX_MODE_MULTIPLE_RGBW);
+  const uint16_t dmxChannelsPerLed = is4Chan ? 4 : 3;
+  const uint16_t dimmerOffset = (DMXMode == DMX_MODE_MULTIPLE_DRGB) ? 1 : 0;
+  const uint16_t dmxLenOffset = (DMXAddress == 0) ? 0 : 1; // For legacy DMX start address 0
+  const uint16_t ledsInFirstUniverse = (((MAX_CHANNELS_PER_UNIVERSE - DMXAddress) + dmxLenOffset) - dimmerOffset) / dmxChannelsPerLed;
+  const uint16_t totalLen = strip.getLengthTotal();
+  if (totalLen <= ledsInFirstUniverse) return 1;
+
+  const uint16_t ledsPerUniverse = is4Chan ? MAX_4_CH_LEDS_PER_UNIVERSE : MAX_3_CH_LEDS_PER_UNIVERSE;
+  const uint16_t count = 1 + (totalLen - ledsInFirstUniverse + ledsPerUniverse - 1) / ledsPerUniverse;
+  return count < E131_MAX_UNIVERSE_COUNT ? count : E131_MAX_UNIVERSE_COUNT;
+}
+
+/*
+ * Frame assembly (e131FrameSync)
+ * Universes are buffered and written to the strip together, so a show() never sees half of a frame.
+ * A frame is presented
+ *  - when all universes needed for the LEDs have arrived, unless the sender uses sync packets
+ *  - on an E1.31 synchronization packet for the announced sync universe or on an ArtSync
+ *  - when a universe arrives twice (the sender starts the next frame without completing this one)
+ *  - after e131FrameTimeout ms with the universes that have arrived (handleE131Frame())
+ * Universes that were missing from a presented frame and arrive before the next frame starts are late,
+ * they are written to the strip directly.
+ */
+static uint8_t *frameData = nullptr;                    // E131_FRAME_SLOT bytes per universe
+static uint16_t frameChannels[E131_MAX_UNIVERSE_COUNT]; // DMX channels of the buffered universes
+static byte     frameProtocol[E131_MAX_UNIVERSE_COUNT];
+static uint8_t  frameUniverses = 0;                     // universes the buffer holds
+static uint32_t frameReceived = 0;                      // universes of the current frame (bit per universe)
+static uint32_t frameMissed = 0;                        // universes missing from the last presented frame
+static unsigned long frameStart = 0;                    // arrival of the first universe of the current frame
+static unsigned long lastSync = 0;                      // arrival of the last sync packet (0: none yet)
+static uint16_t syncAddress = 0;                        // E1.31 synchronization universe announced in the data packets
+static bool     syncArtnet = false;                     // last sync packet was an ArtSync
+static e131_frame_stats_t    frameStats;
+static e131_universe_stats_t universeStats[E131_MAX_UNIVERSE_COUNT];
+static uint8_t  highestSeq[E131_MAX_UNIVERSE_COUNT];  // newest sequence number per universe (statistics)
+
+// the assembler is fed from the E1.31 callback (AsyncUDP task on ESP32) and serviced by handleE131Frame() on the
+// loop task, all access to its state (frame buffer, masks) including the presentation of frames is serialized
+#if defined(WLED_NATIVE)
+static std::mutex        frameMutex;
+static inline void lockFrame()   { frameMutex.lock(); }
+static inline void unlockFrame() { frameMutex.unlock(); }
+#elif defined(ARDUINO_ARCH_ESP32)
+static SemaphoreHandle_t frameMutex = xSemaphoreCreateMutex(); // may block, frames are written to the strip while held
+static inline void lockFrame()   { xSemaphoreTake(frameMutex, portMAX_DELAY); }
+static inline void unlockFrame() { xSemaphoreGive(frameMutex); }
+#else
+static inline void lockFrame()   {} // ESP8266: callbacks of the network stack do not interrupt loop()
+static inline void unlockFrame() {}
+#endif
+
+// the sender synchronizes its universes, wait for its sync packet instead of presenting complete frames
+static bool e131Synced() {
+  return lastSync && millis() - lastSync < E131_SYNC_HOLD_MS && (syncArtnet || syncAddress);
+}
+
+static void presentE131Frame(uint32_t &counter) {
+  counter++;
+  e131NewData = false; // a pending show() of the previous frame must not catch this one half written
+  for (uint8_t u = 0; u < frameUniverses; u++) {
+    if (frameReceived & (1UL << u))
+      applyE131Universe(e131Universe + u, frameData + u * E131_FRAME_SLOT, frameChannels[u], frameProtocol[u]);
+  }
+  frameMissed = ((1UL << frameUniverses) - 1) & ~frameReceived;
+  frameReceived = 0;
+}
+
+// returns false if the universe is not buffered and has to be applied directly
+static bool bufferE131Universe(uint8_t u, const uint8_t* data, uint16_t dmxChannels, byte protocol) {
+  if (!e131FrameSync) return false;
+
+  const uint8_t universes = e131UniverseCount();
+  if (universes != frameUniverses) {
+    free(frameData);
+    frameData = (uint8_t*)malloc(universes * E131_FRAME_SLOT);
+    frameUniverses = frameData ? universes : 0;
+    frameReceived = frameMissed = 0;
+    DEBUG_PRINTF("E1.31 frame buffer: %u universes\n", frameUniverses);
+  }
+  if (!frameData) return false; // not enough memory, write universes as they arrive
+  if (u >= frameUniverses) return true; // all LEDs are covered by the previous universes
+
+  const uint32_t bit = 1UL << u;
+  if (frameMissed & bit) {
+    frameMissed &= ~bit;
+    if (!frameReceived) { universeStats[u].late++; return false; }
+  }
+  const bool synced = e131Synced();
+  if ((frameReceived & bit) && !synced) presentE131Frame(frameStats.incomplete);
+  if (!frameReceived) frameStart = millis();
+
+  const uint16_t len = dmxChannels + (protocol == P_E131); // E1.31 data includes the start code
+  memcpy(frameData + u * E131_FRAME_SLOT, data, len < E131_FRAME_SLOT ? len : E131_FRAME_SLOT);
+  frameChannels[u] = dmxChannels;
+  frameProtocol[u] = protocol;
+  frameReceived |= bit;
+
+  if (!synced && frameReceived == (1UL << frameUniverses) - 1) presentE131Frame(frameStats.complete);
+  return true;
+}
+
+static void handleE131Sync(uint16_t universe, byte protocol) {
+  if (!e131FrameSync) return;
+  lockFrame();
+  if (protocol == P_E131 && (syncAddress == 0 || universe != syncAddress)) { // not our synchronization universe
+    unlockFrame();
+    return;
+  }
+  syncArtnet = protocol == P_ARTNET;
+  lastSync = millis();
+  if (!lastSync) lastSync = 1;
+  if (frameReceived) presentE131Frame(frameStats.synced);
+  unlockFrame();
+}
+
+// presents a frame that did not complete in time and frees the buffer if frame assembly was turned off
+void handleE131Frame() {
+  if (!frameData) return;
+  lockFrame();
+  if (!e131FrameSync) {
+    free(frameData);
+    frameData = nullptr;
+    frameUniverses = 0;
+    frameReceived = frameMissed = 0;
+  } else if (frameReceived && millis() - frameStart > e131FrameTimeout) presentE131Frame(frameStats.timeouts);
+  unlockFrame();
+}
+
+const e131_frame_stats_t& getE131FrameStats() {
+  return frameStats;
+}
+
+const e131_universe_stats_t* getE131UniverseStats(uint8_t &count) {
+  count = e131UniverseCount();
+  return universeStats;
+}
+
+// updates the sequence statistics of a universe, returns false if the packet should be skipped
+static bool checkE131Sequence(uint8_t u, uint8_t seq, uint16_t uni) {
+  e131_universe_stats_t &stats = universeStats[u];
+  const uint8_t last = e131LastSequenceNumber[u];
+  const int8_t diff = stats.packets++ ? seq - highestSeq[u] : 1;
+  if (diff > 0) {
+    stats.lost += diff - 1;
+    highestSeq[u] = seq;
+  } else if (diff < 0) {
+    stats.ooo++;
+    if (stats.lost) stats.lost--; // fills a gap counted as lost before
+  }
+
+  if (e131SkipOutOfSequence)
+    if (seq < last && seq > 20 && last < 250){
+      DEBUG_PRINT(F("skipping E1.31 frame (last seq="));
+      DEBUG_PRINT(last);
+      DEBUG_PRINT(F(", current seq="));
+      DEBUG_PRINT(seq);
+      DEBUG_PRINT(F(", universe="));
+      DEBUG_PRINT(uni);
+      DEBUG_PRINTLN(")");
+      return false;
+    }
+  e131LastSequenceNumber[u] = seq;
+  return true;
+}
+
 //E1.31 and Art-Net protocol support
 void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
 
   uint16_t uni = 0, dmxChannels = 0;
   uint8_t* e131_data = nullptr;
-  uint8_t seq = 0, mde = REALTIME_MODE_E131;
+  uint8_t seq = 0;
 
   if (protocol == P_ARTNET)
   {
@@ -64,12 +240,19 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       handleArtnetPollReply(clientIP);
       return;
     }
+    if (p->art_opcode == ARTNET_OPCODE_OPSYNC) {
+      handleE131Sync(0, P_ARTNET);
+      return;
+    }
     uni = p->art_universe;
     dmxChannels = htons(p->art_length);
     e131_data = p->art_data;
     seq = p->art_sequence_number;
-    mde = REALTIME_MODE_ARTNET;
   } else if (protocol == P_E131) {
+    if (htonl(p->root_vector) == E131_VECTOR_ROOT_EXTENDED) {
+      handleE131Sync((p->raw[E131_SYNC_UNIVERSE] << 8) | p->raw[E131_SYNC_UNIVERSE+1], P_E131);
+      return;
+    }
     // Ignore PREVIEW data (E1.31: 6.2.6)
     if ((p->options & 0x80) != 0) return;
     dmxChannels = htons(p->property_value_count) - 1;
@@ -103,22 +286,21 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
   if (uni < e131Universe || uni >= (e131Universe + E131_MAX_UNIVERSE_COUNT)) return;
 
   uint8_t previousUniverses = uni - e131Universe;
-
-  if (e131SkipOutOfSequence)
-    if (seq < e131LastSequenceNumber[previousUniverses] && seq > 20 && e131LastSequenceNumber[previousUniverses] < 250){
-      DEBUG_PRINT(F("skipping E1.31 frame (last seq="));
-      DEBUG_PRINT(e131LastSequenceNumber[previousUniverses]);
-      DEBUG_PRINT(F(", current seq="));
-      DEBUG_PRINT(seq);
-      DEBUG_PRINT(F(", universe="));
-      DEBUG_PRINT(uni);
-      DEBUG_PRINTLN(")");
-      return;
-    }
-  e131LastSequenceNumber[previousUniverses] = seq;
+  if (!checkE131Sequence(previousUniverses, seq, uni)) return;
 
   // update status info
   realtimeIP = clientIP;
+  lockFrame();
+  if (protocol == P_E131) syncAddress = htons(p->reserved);
+  if (!bufferE131Universe(previousUniverses, e131_data, dmxChannels, protocol))
+    applyE131Universe(uni, e131_data, dmxChannels, protocol);
+  unlockFrame();
+}
+
+// writes the DMX data of a universe to the strip according to DMXMode
+static void applyE131Universe(uint16_t uni, uint8_t* e131_data, uint16_t dmxChannels, byte protocol) {
+  const uint8_t previousUniverses = uni - e131Universe;
+  const uint8_t mde = protocol == P_ARTNET ? REALTIME_MODE_ARTNET : REALTIME_MODE_E131;
   byte wChannel = 0;
   uint16_t totalLen = strip.getLengthTotal();
   uint16_t availDMXLen = 0;
@@ -308,17 +490,7 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
           }
         }
 
-        if (!is4Chan) {
-          for (uint16_t i = previousLeds; i < ledsTotal; i++) {
-            setRealtimePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], 0);
-            dmxOffset+=3;
-          }
-        } else {
-          for (uint16_t i = previousLeds; i < ledsTotal; i++) {
-            setRealtimePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], e131_data[dmxOffset+3]);
-            dmxOffset+=4;
-          }
-        }
+        if (ledsTotal > previousLeds) realtimeWrite(previousLeds, e131_data + dmxOffset, ledsTotal - previousLeds, dmxChannelsPerLed);
         break;
       }
     default:
@@ -354,30 +526,8 @@ void handleArtnetPollReply(IPAddress ipAddress) {
     case DMX_MODE_MULTIPLE_DRGB:
     case DMX_MODE_MULTIPLE_RGB:
     case DMX_MODE_MULTIPLE_RGBW:
-      {
-        bool is4Chan = (DMXMode == DMX_MODE_MULTIPLE_RGBW);
-        const uint16_t dmxChannelsPerLed = is4Chan ? 4 : 3;
-        const uint16_t dimmerOffset = (DMXMode == DMX_MODE_MULTIPLE_DRGB) ? 1 : 0;
-        const uint16_t dmxLenOffset = (DMXAddress == 0) ? 0 : 1; // For legacy DMX start address 0
-        const uint16_t ledsInFirstUniverse = (((MAX_CHANNELS_PER_UNIVERSE - DMXAddress) + dmxLenOffset) - dimmerOffset) / dmxChannelsPerLed;
-        const uint16_t totalLen = strip.getLengthTotal();
-
-        if (totalLen > ledsInFirstUniverse) {
-          const uint16_t ledsPerUniverse = is4Chan ? MAX_4_CH_LEDS_PER_UNIVERSE : MAX_3_CH_LEDS_PER_UNIVERSE;
-          const uint16_t remainLED = totalLen - ledsInFirstUniverse;
-
-          endUniverse += (remainLED / ledsPerUniverse);
-
-          if ((remainLED % ledsPerUniverse) > 0) {
-            endUniverse++;
-          }
-
-          if ((endUniverse - startUniverse) > E131_MAX_UNIVERSE_COUNT) {
-            endUniverse = startUniverse + E131_MAX_UNIVERSE_COUNT - 1;
-          }
-        }
-        break;
-      }
+      endUniverse += e131UniverseCount() - 1;
+      break;
     default:
       DEBUG_PRINTLN(F("unknown E1.31 DMX mode"));
       return;  // nothing to do
@@ -57,6 +57,7 @@ class NeoGammaWLEDMethod {
     static uint32_t Correct32(uint32_t color);  // apply Gamma to RGBW32 color (WLED specific, not used by NPB)
     static void calcGammaTable(float gamma);    // re-calculates & fills gamma table
     static inline uint8_t rawGamma8(uint8_t val) { return gammaT[val]; }  // get value from Gamma table (WLED specific, not used by NPB)
+    static inline const uint8_t *rawGammaTable() { return gammaT; }        // whole table for bulk conversions (WLED specific)
   private:
     static uint8_t gammaT[];
 };
@@ -65,6 +66,12 @@ class NeoGammaWLEDMethod {
 uint32_t color_blend(uint32_t,uint32_t,uint16_t,bool b16=false);
 uint32_t color_add(uint32_t,uint32_t, bool fast=false);
 uint32_t color_fade(uint32_t c1, uint8_t amount, bool video=false);
+// bulk operations on RGBW32 buffers (same results as the functions above applied to each pixel)
+void color_fill_buf(uint32_t *buf, size_t len, uint32_t c);
+void color_fade_buf(uint32_t *buf, size_t len, uint8_t amount, bool video=false);
+void color_blend_buf(uint32_t *dst, const uint32_t *src, size_t len, uint16_t blend, bool b16=false);
+void color_add_buf(uint32_t *dst, const uint32_t *src, size_t len, bool fast=false);
+void color_blur_buf(uint32_t *buf, size_t len, uint8_t amount);
 inline uint32_t colorFromRgbw(byte* rgbw) { return uint32_t((byte(rgbw[3]) << 24) | (byte(rgbw[0]) << 16) | (byte(rgbw[1]) << 8) | (byte(rgbw[2]))); }
 void colorHStoRGB(uint16_t hue, byte sat, byte* rgb); //hue, sat to rgb
 void colorKtoRGB(uint16_t kelvin, byte* rgb);
@@ -82,7 +89,24 @@ void initDMX();
 void handleDMX();
 
 //e131.cpp
+typedef struct {
+  uint32_t packets;
+  uint32_t lost;     // gaps in the sequence numbers
+  uint32_t ooo;      // out of order, sequence number older than the last one
+  uint32_t late;     // arrived after their frame was presented without them
+} e131_universe_stats_t;
+
+typedef struct {
+  uint32_t complete;   // all universes arrived
+  uint32_t synced;     // E1.31 sync packet or ArtSync
+  uint32_t incomplete; // a universe arrived again before the frame was complete
+  uint32_t timeouts;   // not complete after e131FrameTimeout
+} e131_frame_stats_t;
+
 void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol);
+void handleE131Frame();
+const e131_frame_stats_t& getE131FrameStats();
+const e131_universe_stats_t* getE131UniverseStats(uint8_t &count);
 void handleArtnetPollReply(IPAddress ipAddress);
 void prepareArtnetPollReply(ArtPollReply* reply);
 void sendArtnetPollReply(ArtPollReply* reply, IPAddress ipAddress, uint16_t portAddress);
@@ -148,6 +172,7 @@ bool deserializeState(JsonObject root, byte callMode = CALL_MODE_DIRECT_CHANGE,
 void serializeSegment(JsonObject& root, Segment& seg, byte id, bool forPreset = false, bool segmentBounds = true);
 void serializeState(JsonObject root, bool forPreset = false, bool includeBri = true, bool segmentBounds = true, bool selectedSegmentsOnly = false);
 void serializeInfo(JsonObject root);
+void serializePerf(JsonObject root, int histSegment = -1);
 void serializeModeNames(JsonArray root);
 void serializeModeData(JsonArray root);
 void serveJson(AsyncWebServerRequest* request);
@@ -228,11 +253,26 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply=tru
 
 //udp.cpp
 void notify(byte callMode, bool followUp=false);
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri=255, bool isRGBW=false);
+struct NetSendStats;
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri, bool isRGBW, uint8_t *packet, NetSendStats *stats = nullptr);
+size_t  realtimePacketSize(uint8_t type);
+void setE131OutCID(const char *hex);
+void getE131OutCID(char *hex);
 void realtimeLock(uint32_t timeoutMs, byte md = REALTIME_MODE_GENERIC);
 void exitRealtime();
+typedef struct {
+  uint32_t packets;    // read from the notifier, supplemental notifier and Hyperion sockets
+  uint32_t dropped;    // read but not applied (receiving disabled, filtered, invalid, own broadcasts)
+  uint32_t coalesced;  // realtime packets shown together with a later one instead of on their own
+  uint32_t budgetHits; // loops that stopped reading because udpRxBudgetUs was used up
+  uint16_t depth;      // packets read in the last loop
+  uint16_t maxDepth;
+} udp_rx_stats_t;
+
 void handleNotifications();
+const udp_rx_stats_t& getUDPReceiveStats();
 void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w);
+void realtimeWrite(uint16_t start, const uint8_t* data, uint16_t count, uint8_t channelsPerPixel);
 void refreshNodeList();
 void sendSysInfoUDP();
 
@@ -372,6 +412,21 @@ class JSONBufferGuard {
     inline void release() { if (holding_lock) releaseJSONBufferLock(); holding_lock = false; }
 };
 
+#ifdef WLED_NATIVE
+//wled_bench.cpp
+void runEffectBenchmark(FILE *out, bool json, uint16_t frames, int fx = -1);
+int  runRenderPoolCheck(FILE *out, uint16_t frames, int fx = -1);
+int  runColorKernelCheck(FILE *out);
+void runServiceBenchmark(FILE *out, uint8_t segments, uint16_t frames);
+int  runDataArenaCheck(FILE *out, unsigned cycles);
+int  runMathCheck(FILE *out);
+int  runNetworkOutputCheck(FILE *out);
+int  runFrameSyncCheck(FILE *out);
+int  runRealtimeIngestBenchmark(FILE *out, unsigned frames);
+int  runUDPReceiveCheck(FILE *out);
+int  runABLCheck(FILE *out, unsigned frames);
+#endif
+
 #ifdef WLED_ADD_EEPROM_SUPPORT
 //wled_eeprom.cpp
 void applyMacro(byte index);
@@ -401,6 +456,12 @@ void clearEEPROM();
   #define fmod_t fmod
   #define floor_t floor
 #endif
+// fixed point, 16 bit angles (65536 per full circle)
+int16_t  sin16_t(uint16_t theta);   // Q15
+int16_t  cos16_t(uint16_t theta);   // Q15
+int16_t  atan2_16_t(int32_t y, int32_t x);
+uint16_t sqrt32_t(uint32_t x);
+uint32_t exp16_t(int32_t x);        // Q16
 
 //wled_serial.cpp
 void handleSerial();
@@ -10,6 +10,7 @@
 #define JSON_PATH_FXDATA     6
 #define JSON_PATH_NETWORKS   7
 #define JSON_PATH_EFFECTS    8
+#define JSON_PATH_PERF       9
 
 /*
  * JSON API (De)serialization
@@ -34,7 +35,7 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
   //DEBUG_PRINTLN("-- JSON deserialize segment.");
   Segment& seg = strip.getSegment(id);
   //DEBUG_PRINTF("--  Original segment: %p\n", &seg);
-  Segment prev = seg; //make a backup so we can tell if something changed
+  Segment prev(seg, true); //make a backup of the settings so we can tell if something changed
   //DEBUG_PRINTF("--  Duplicate segment: %p\n", &prev);
 
   uint16_t start = elem["start"] | seg.start;
@@ -105,6 +106,9 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
   uint8_t set = elem[F("set")] | seg.set;
   seg.set = constrain(set, 0, 3);
 
+  uint8_t fps = elem["fps"] | seg.fps;
+  seg.fps = MIN(fps, 120); // same limit as the strip target FPS
+
   uint16_t len = 1;
   if (stop > start) len = stop - start;
   int offset = elem[F("of")] | INT32_MAX;
@@ -503,6 +507,7 @@ void serializeSegment(JsonObject& root, Segment& seg, byte id, bool forPreset, b
   root["bri"]    = (segbri) ? segbri : 255;
   root["cct"]    = seg.cct;
   root[F("set")] = seg.set;
+  root["fps"]    = seg.fps;
 
   if (seg.name != nullptr) root["n"] = reinterpret_cast<const char *>(seg.name); //not good practice, but decreases required JSON buffer
   else if (forPreset) root["n"] = "";
@@ -609,6 +614,17 @@ void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segme
   }
 }
 
+// min/avg/max (us) and optionally the histogram of a performance counter (see PerfStat in FX.h)
+static void serializePerfStat(JsonObject root, const perf_stat_t &stat, bool histogram = true)
+{
+  root[F("min")] = stat.count ? stat.min : 0;
+  root[F("avg")] = stat.avg();
+  root[F("max")] = stat.max;
+  if (!histogram) return;
+  JsonArray hist = root.createNestedArray("h");
+  for (size_t i = 0; i < PERF_HIST_SIZE; i++) hist.add(stat.hist[i]);
+}
+
 void serializeInfo(JsonObject root)
 {
   root[F("ver")] = versionString;
@@ -750,6 +766,17 @@ void serializeInfo(JsonObject root)
   #if defined(ARDUINO_ARCH_ESP32) && defined(BOARD_HAS_PSRAM)
   if (psramFound()) root[F("psram")] = ESP.getFreePsram();
   #endif
+  const SegmentArena &arena = Segment::getDataArena(); // effect data of all segments
+  JsonObject fxdata = root.createNestedObject(F("fxdata"));
+  fxdata[F("size")]  = arena.getSize();    // currently taken from the heap
+  fxdata[F("max")]   = arena.getMaxSize();
+  fxdata[F("used")]  = arena.getUsed();
+  fxdata[F("peak")]  = arena.getPeak();
+  fxdata[F("blocks")] = arena.getBlocks();
+  fxdata[F("lfb")]   = arena.getLargestFree();
+  fxdata[F("frag")]  = arena.getFragmentation();
+  fxdata[F("compactions")] = arena.getCompactions();
+  fxdata[F("fails")] = arena.getFailures();
   root[F("uptime")] = millis()/1000 + rolloverMillis*4294967;
 
   char time[32];
@@ -801,6 +828,78 @@ void serializeInfo(JsonObject root)
   root["ip"] = s;
 }
 
+// timing of active segments (current effect only), of pushing frames to the buses and network statistics (/json/perf)
+// kept out of serializeInfo() since it grows with the number of segments and busses; to fit into the JSON buffer
+// with all segments active the histograms are only added for a single segment on request (/json/perf?h=<id>)
+void serializePerf(JsonObject root, int histSegment)
+{
+  serializePerfStat(root.createNestedObject(F("show")), strip.getShowPerf());
+  serializePerfStat(root.createNestedObject(F("lat")), strip.getLatencyPerf()); // frame start to sending
+  root[F("deferred")] = strip.getFramesDeferred();
+  root[F("dropped")]  = strip.getFramesDropped(); // frame slots skipped (overload)
+  JsonObject jitter = root.createNestedObject(F("jitter")); // frame interval deviation from the frame time (µs)
+  jitter[F("p50")] = strip.getFrameJitter(50);
+  jitter[F("p95")] = strip.getFrameJitter(95);
+  jitter[F("p99")] = strip.getFrameJitter(99);
+  jitter[F("max")] = strip.getFrameJitter(100);
+  JsonArray perfNet = root.createNestedArray(F("net")); // network busses
+  for (uint8_t b = 0; b < busses.getNumBusses(); b++) {
+    Bus *bus = busses.getBus(b);
+    if (bus == nullptr || bus->getType() < TYPE_NET_DDP_RGB || bus->getType() >= 96 || !bus->isOk()) continue;
+    const NetSendStats &ns = static_cast<BusNetwork*>(bus)->getSendStats();
+    JsonObject pn = perfNet.createNestedObject();
+    pn["id"] = b;
+    pn[F("pkts")]  = ns.packets;
+    pn[F("bytes")] = ns.bytes;
+    pn[F("err")]   = ns.errors;
+    pn[F("pps")]   = ns.packetsPerSec;
+    pn[F("bps")]   = ns.bytesPerSec;   // bytes per second
+  }
+  const udp_rx_stats_t &rx = getUDPReceiveStats();
+  JsonObject perfUdp = root.createNestedObject(F("udp")); // notifier, UDP realtime and Hyperion receive
+  perfUdp[F("pkts")]      = rx.packets;
+  perfUdp[F("dropped")]   = rx.dropped;
+  perfUdp[F("coalesced")] = rx.coalesced;
+  perfUdp[F("budget")]    = rx.budgetHits;
+  perfUdp[F("depth")]     = rx.depth;
+  perfUdp[F("maxdepth")]  = rx.maxDepth;
+  JsonObject perfDmx = root.createNestedObject(F("dmx")); // E1.31/Art-Net receive
+  const e131_frame_stats_t &fs = getE131FrameStats();
+  perfDmx[F("complete")]   = fs.complete;
+  perfDmx[F("synced")]     = fs.synced;
+  perfDmx[F("incomplete")] = fs.incomplete;
+  perfDmx[F("timeouts")]   = fs.timeouts;
+  uint8_t numUniverses;
+  const e131_universe_stats_t *us = getE131UniverseStats(numUniverses);
+  JsonArray perfUni = perfDmx.createNestedArray(F("uni"));
+  for (uint8_t u = 0; u < numUniverses; u++) {
+    JsonObject pu = perfUni.createNestedObject();
+    pu["u"] = e131Universe + u;
+    pu[F("pkts")] = us[u].packets;
+    pu[F("lost")] = us[u].lost;
+    pu[F("ooo")]  = us[u].ooo;
+    pu[F("late")] = us[u].late;
+  }
+  JsonArray perfSeg = root.createNestedArray(F("seg"));
+  uint32_t nowUs = micros();
+  for (size_t s = 0; s < strip.getSegmentsNum(); s++) {
+    Segment &seg = strip.getSegment(s);
+    if (!seg.isActive()) continue;
+    JsonObject ps = perfSeg.createNestedObject();
+    ps["id"] = s;
+    ps["fx"] = seg.mode;
+    ps[F("frames")]  = seg.perf().rendered;
+    ps[F("skipped")] = seg.perf().skipped;
+    ps[F("missed")]  = seg.perf().missed;   // deadlines missed by a frame or more
+    ps[F("deferred")] = seg.perf().deferred; // postponed because the render budget was used up
+    ps[F("last")]    = seg.perf().rendered ? (long)((nowUs - seg.perf().lastFrame) / 1000) : -1; // ms since last frame
+    serializePerfStat(ps.createNestedObject(F("render")), seg.perf().fx, histSegment == (int)s);
+    serializePerfStat(ps.createNestedObject(F("comp")), seg.perf().composite, histSegment == (int)s);
+    serializePerfStat(ps.createNestedObject(F("int")), seg.perf().interval, histSegment == (int)s);
+  }
+
+}
+
 void setPaletteColors(JsonArray json, CRGBPalette16 palette)
 {
     for (int i = 0; i < 16; i++) {
@@ -933,7 +1032,7 @@ void serializePalettes(JsonObject root, int page)
         if (i>=palettesCount) {
           setPaletteColors(curPalette, strip.customPalettes[i - palettesCount]);
         } else {
-          memcpy_P(tcp, (byte*)pgm_read_dword(&(gGradientPalettes[i - 13])), 72);
+          memcpy_P(tcp, (byte*)pgm_read_ptr(&(gGradientPalettes[i - 13])), 72);
           setPaletteColors(curPalette, tcp);
         }
         }
@@ -1056,6 +1155,7 @@ void serveJson(AsyncWebServerRequest* request)
   else if (url.indexOf("palx")  > 0) subJson = JSON_PATH_PALETTES;
   else if (url.indexOf("fxda")  > 0) subJson = JSON_PATH_FXDATA;
   else if (url.indexOf("net")   > 0) subJson = JSON_PATH_NETWORKS;
+  else if (url.indexOf("perf")  > 0) subJson = JSON_PATH_PERF;
   #ifdef WLED_ENABLE_JSONLIVE
   else if (url.indexOf("live")  > 0) {
     serveLiveLeds(request);
@@ -1100,6 +1200,8 @@ void serveJson(AsyncWebServerRequest* request)
       serializeModeData(lDoc); break;
     case JSON_PATH_NETWORKS:
       serializeNetworks(lDoc); break;
+    case JSON_PATH_PERF:
+      serializePerf(lDoc, request->hasParam("h") ? request->getParam("h")->value().toInt() : -1); break;
     default: //all
       JsonObject state = lDoc.createNestedObject("state");
       serializeState(state);
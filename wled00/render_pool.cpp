@@ -0,0 +1,148 @@
+#include "wled.h"
+
+/*
+ * Render task pool, see render_pool.h
+ */
+
+RenderPool::RenderPool()
+: _fn(nullptr)
+, _arg(nullptr)
+, _count(0)
+, _next(0)
+, _enabled(true)
+, _started(false)
+#if WLED_RENDER_TASKS > 0
+  #ifdef WLED_NATIVE
+, _generation(0)
+, _busy(0)
+, _stop(false)
+  #else
+, _done(nullptr)
+, _mux(portMUX_INITIALIZER_UNLOCKED)
+  #endif
+#endif
+{}
+
+RenderPool::~RenderPool() {
+#if WLED_RENDER_TASKS > 0 && defined(WLED_NATIVE)
+  if (!_started) return;
+  {
+    std::lock_guard<std::mutex> l(_syncMutex);
+    _stop = true;
+  }
+  _wake.notify_all();
+  for (std::thread &t : _threads) if (t.joinable()) t.join();
+#endif
+}
+
+void RenderPool::begin() {
+  if (_started) return;
+#if WLED_RENDER_TASKS > 0
+  #ifdef WLED_NATIVE
+  for (unsigned w = 0; w < WLED_RENDER_TASKS; w++) _threads[w] = std::thread(&RenderPool::thread, this, w+1);
+  _started = true;
+  #else
+  _done = xSemaphoreCreateCounting(WLED_RENDER_TASKS, 0);
+  if (!_done) return;
+  // loop task runs on ARDUINO_RUNNING_CORE, render on the other one (next to WiFi, which has higher priority)
+  BaseType_t core = xPortGetCoreID() ? 0 : 1;
+  for (unsigned w = 0; w < WLED_RENDER_TASKS; w++) {
+    if (xTaskCreatePinnedToCore(task, "render", 8192, (void*)(uintptr_t)(w+1), 1, &_tasks[w], core) != pdPASS) {
+      DEBUG_PRINTLN(F("Render task creation failed."));
+      while (w--) vTaskDelete(_tasks[w]);
+      return;
+    }
+  }
+  _started = true;
+  #endif
+  DEBUG_PRINTF("Render tasks: %d\n", WLED_RENDER_TASKS);
+#endif
+}
+
+void RenderPool::lock() {
+#if WLED_RENDER_TASKS > 0
+  #ifdef WLED_NATIVE
+  _jobMutex.lock();
+  #else
+  portENTER_CRITICAL(&_mux);
+  #endif
+#endif
+}
+
+void RenderPool::unlock() {
+#if WLED_RENDER_TASKS > 0
+  #ifdef WLED_NATIVE
+  _jobMutex.unlock();
+  #else
+  portEXIT_CRITICAL(&_mux);
+  #endif
+#endif
+}
+
+// pick jobs until there are none left
+void RenderPool::work(unsigned worker) {
+  for (;;) {
+    lock();
+    unsigned job = _next++;
+    unlock();
+    if (job >= _count) break;
+    _fn(job, worker, _arg);
+  }
+}
+
+void RenderPool::run(job_fn fn, void *arg, unsigned count) {
+  if (count == 0) return;
+  if (count == 1 || getWorkers() == 1) {
+    for (unsigned i = 0; i < count; i++) fn(i, 0, arg);
+    return;
+  }
+  _fn    = fn;
+  _arg   = arg;
+  _count = count;
+  _next  = 0;
+#if WLED_RENDER_TASKS > 0
+  #ifdef WLED_NATIVE
+  {
+    std::lock_guard<std::mutex> l(_syncMutex);
+    _busy = WLED_RENDER_TASKS;
+    _generation++;
+  }
+  _wake.notify_all();
+  work(0);
+  std::unique_lock<std::mutex> l(_syncMutex);
+  _idle.wait(l, [this]{ return _busy == 0; });
+  #else
+  for (unsigned w = 0; w < WLED_RENDER_TASKS; w++) xTaskNotifyGive(_tasks[w]);
+  work(0);
+  for (unsigned w = 0; w < WLED_RENDER_TASKS; w++) xSemaphoreTake(_done, portMAX_DELAY);
+  #endif
+#endif
+}
+
+#if WLED_RENDER_TASKS > 0
+  #ifdef WLED_NATIVE
+void RenderPool::thread(unsigned worker) {
+  unsigned generation = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> l(_syncMutex);
+      _wake.wait(l, [&]{ return _stop || _generation != generation; });
+      if (_stop) return;
+      generation = _generation;
+    }
+    work(worker);
+    std::lock_guard<std::mutex> l(_syncMutex);
+    if (--_busy == 0) _idle.notify_one();
+  }
+}
+  #else
+void RenderPool::task(void *param) {
+  unsigned worker = (uintptr_t)param;
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    renderPool.work(worker);
+    xSemaphoreGive(renderPool._done);
+  }
+}
+  #endif
+#endif
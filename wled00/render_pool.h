@@ -0,0 +1,74 @@
+#ifndef RenderPool_h
+#define RenderPool_h
+
+/*
+ * Small pool of render tasks used by WS2812FX::service() to run effect functions of independent segments in parallel.
+ * Workers are FreeRTOS tasks on dual core ESP32 (pinned to the core the loop task does not run on) and std::threads
+ * on the native build. With WLED_RENDER_TASKS 0 (ESP8266, single core ESP32) all jobs run on the calling task.
+ */
+
+#include "const.h"
+
+#if WLED_RENDER_TASKS > 0
+  #ifdef WLED_NATIVE
+    #include <thread>
+    #include <mutex>
+    #include <condition_variable>
+  #else
+    #include <freertos/FreeRTOS.h>
+    #include <freertos/task.h>
+    #include <freertos/semphr.h>
+  #endif
+  #define WLED_RENDER_TLS thread_local // render context of the task (see WS2812FX::_ctx)
+#else
+  #define WLED_RENDER_TLS
+#endif
+
+class RenderPool {
+  public:
+    // job callback: job index (0..count-1), worker index (0 is the calling task) and user argument
+    typedef void (*job_fn)(unsigned job, unsigned worker, void *arg);
+
+    RenderPool();
+    ~RenderPool();
+
+    void begin();                                   // start worker tasks
+    void run(job_fn fn, void *arg, unsigned count); // distribute jobs to caller and workers, returns when all are done
+    void lock();                                    // short critical section shared by all workers (no blocking calls inside)
+    void unlock();
+
+    inline void     setEnabled(bool en)  { _enabled = en; } // disabled pool runs every job on the caller (serial rendering)
+    inline bool     isEnabled() const    { return _enabled; }
+    inline unsigned getWorkers() const   { return _started && _enabled ? 1 + WLED_RENDER_TASKS : 1; }
+
+  private:
+    job_fn   _fn;
+    void    *_arg;
+    unsigned _count;
+    unsigned _next;     // next job to pick, protected by lock()
+    bool     _enabled;
+    bool     _started;
+
+    void work(unsigned worker);
+
+#if WLED_RENDER_TASKS > 0
+  #ifdef WLED_NATIVE
+    std::thread             _threads[WLED_RENDER_TASKS];
+    std::mutex              _jobMutex;    // lock()
+    std::mutex              _syncMutex;   // guards _generation, _busy and _stop
+    std::condition_variable _wake;
+    std::condition_variable _idle;
+    unsigned                _generation;  // incremented for every run()
+    unsigned                _busy;        // workers still working on the current run()
+    bool                    _stop;
+    void thread(unsigned worker);
+  #else
+    TaskHandle_t      _tasks[WLED_RENDER_TASKS];
+    SemaphoreHandle_t _done;              // given by a worker when it ran out of jobs
+    portMUX_TYPE      _mux;
+    static void task(void *param);
+  #endif
+#endif
+};
+
+#endif
@@ -0,0 +1,161 @@
+#include <string.h>
+#include <stdlib.h>
+#include "segment_arena.h"
+
+/*
+ * Segment data arena, see segment_arena.h
+ */
+
+#define ARENA_MAGIC 0xA5
+#define ARENA_NONE  0xFFFF
+
+typedef struct {
+  uint16_t len;     // data bytes of the block (rounded to 4)
+  uint8_t  handle;  // 0 if the block was freed
+  uint8_t  magic;
+} arena_block_t;
+
+SegmentArena::SegmentArena(size_t maxSize, uint16_t *slots, unsigned numSlots)
+: _mem(nullptr)
+, _slots(slots)
+, _size(0)
+, _maxSize(maxSize > 0xFFFC ? 0xFFFC : maxSize & ~3U)
+, _limit(_maxSize)
+, _pending(0)
+, _numSlots(numSlots > 255 ? 255 : numSlots)
+, _blocks(0)
+, _top(0)
+, _holes(0)
+, _used(0)
+, _peak(0)
+, _compactions(0)
+, _failures(0)
+{
+  for (unsigned h = 0; h <= _numSlots; h++) _slots[h] = ARENA_NONE;
+}
+
+SegmentArena::~SegmentArena() {
+  ::free(_mem);
+}
+
+uint8_t *SegmentArena::alloc(size_t len) {
+  if (len == 0 || len > 0xFFFC) return nullptr;
+  size_t bytes = blockSize(len);
+  if (_top + bytes > _size) {
+    if (fitsAfterCompaction(len)) _pending = _pending + bytes < _maxSize ? _pending + bytes : _maxSize; // compact() makes room
+    else                          _failures++;
+    return nullptr;
+  }
+  unsigned h = 1;
+  while (h <= _numSlots && _slots[h] != ARENA_NONE) h++;
+  if (h > _numSlots) { _failures++; return nullptr; }
+
+  arena_block_t *b = (arena_block_t*)(_mem + _top);
+  b->len    = bytes - HEADER;
+  b->handle = h;
+  b->magic  = ARENA_MAGIC;
+  _slots[h] = _top;
+  _top   += bytes;
+  _used  += b->len;
+  _blocks++;
+  if (_used > _peak) _peak = _used;
+  return (uint8_t*)b + HEADER;
+}
+
+void SegmentArena::free(uint8_t *p) {
+  uint8_t h = handle(p);
+  if (!h) return;
+  arena_block_t *b = (arena_block_t*)(p - HEADER);
+  size_t bytes = HEADER + b->len;
+  _slots[h] = ARENA_NONE;
+  b->handle = 0;
+  _used -= b->len;
+  _blocks--;
+  if (p + b->len == _mem + _top) _top -= bytes; // last block, no hole
+  else                           _holes += bytes;
+  if (_blocks == 0) _top = _holes = 0;
+  _limit = _maxSize; // the heap may have room again
+}
+
+bool SegmentArena::owns(const uint8_t *p) const {
+  return handle(p) != 0;
+}
+
+uint8_t SegmentArena::handle(const uint8_t *p) const {
+  if (p < _mem + HEADER || p >= _mem + _top || ((p - _mem) & 3)) return 0;
+  const arena_block_t *b = (const arena_block_t*)(p - HEADER);
+  if (b->magic != ARENA_MAGIC || b->handle == 0 || b->handle > _numSlots) return 0;
+  return _slots[b->handle] == (p - _mem) - HEADER ? b->handle : 0;
+}
+
+uint8_t *SegmentArena::ptr(uint8_t handle) const {
+  if (handle == 0 || handle > _numSlots || _slots[handle] == ARENA_NONE) return nullptr;
+  return _mem + _slots[handle] + HEADER;
+}
+
+bool SegmentArena::compact() {
+  bool moved = false;
+  if (_holes) {
+    uint16_t src = 0, dst = 0;
+    while (src < _top) {
+      arena_block_t *b = (arena_block_t*)(_mem + src);
+      uint16_t bytes = HEADER + b->len;
+      if (b->handle) {
+        if (src != dst) {
+          _slots[b->handle] = dst;
+          memmove(_mem + dst, _mem + src, bytes);
+          moved = true;
+        }
+        dst += bytes;
+      }
+      src += bytes;
+    }
+    _top = dst;
+    _holes = 0;
+    _compactions++;
+  }
+  // room for the blocks, the allocations that did not fit and a chunk of headroom; nothing if empty
+  size_t size = _top + _pending ? roundChunk(_top + _pending) + ARENA_CHUNK : 0;
+  if (size > _maxSize) size = _maxSize;
+  _pending = 0;
+  if (size > _size || size + ARENA_CHUNK < _size || size == 0) {
+    uint8_t *mem = _mem;
+    if (resize(size)) moved |= _mem != mem && _blocks;
+    else if (size > _size) _limit = _size; // heap has no room, do not ask again until a block is freed
+  }
+  return moved;
+}
+
+bool SegmentArena::resize(size_t size) {
+  if (size == _size) return true;
+  if (size == 0) {
+    ::free(_mem);
+    _mem = nullptr;
+    _size = 0;
+    return true;
+  }
+  uint8_t *mem = (uint8_t*)::realloc(_mem, size); // keeps the blocks, handles are offsets
+  if (!mem) return false;
+  _mem  = mem;
+  _size = size;
+  return true;
+}
+
+size_t SegmentArena::getLargestFree() const {
+  size_t largest = _limit - _top, run = 0;
+  for (uint16_t off = 0; off < _top; ) {
+    const arena_block_t *b = (const arena_block_t*)(_mem + off);
+    uint16_t bytes = HEADER + b->len;
+    run = b->handle ? 0 : run + bytes;
+    if (run > largest) largest = run;
+    off += bytes;
+  }
+  if (run + _limit - _top > largest) largest = run + _limit - _top; // holes right below the top
+  return largest > HEADER ? largest - HEADER : 0;
+}
+
+uint8_t SegmentArena::getFragmentation() const {
+  size_t free = getFree();
+  if (free <= HEADER) return 0;
+  return 100 - getLargestFree() * 100 / (free - HEADER);
+}
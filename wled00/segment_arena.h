@@ -0,0 +1,73 @@
+#ifndef SegmentArena_h
+#define SegmentArena_h
+
+/*
+ * Memory arena for the runtime data of all segments (SEGENV.data) and their transition copies.
+ *
+ * Blocks are placed one after the other (bump allocation), each with a small header holding its size and
+ * handle. Freed blocks leave holes that are closed by compact(): live blocks slide down and the handle table
+ * is updated, so owners convert their pointers to handles before and back to pointers after compaction.
+ * Pointers therefore stay valid until the next compaction, which WS2812FX::service() does between frames.
+ *
+ * The arena is a single heap block that compact() resizes in ARENA_CHUNK steps: it grows by what allocations
+ * that did not fit asked for (up to the budget given to the constructor) and is released when no block is
+ * left, so memory is only taken from the heap while effects use it. Effect changes do not fragment the heap.
+ *
+ * Not thread safe, callers serialize access.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+class SegmentArena {
+  public:
+    static const unsigned HEADER = 4;   // block header (size and handle), blocks are 4 byte aligned
+    static const unsigned ARENA_CHUNK = 512; // resize granularity
+
+    SegmentArena(size_t maxSize, uint16_t *slots, unsigned numSlots);
+    ~SegmentArena();
+
+    uint8_t *alloc(size_t len);         // nullptr if no contiguous space is left (see fitsAfterCompaction())
+    void     free(uint8_t *p);
+    bool     owns(const uint8_t *p) const;
+    uint8_t  handle(const uint8_t *p) const; // 0 if p is not a block of this arena
+    uint8_t *ptr(uint8_t handle) const;      // nullptr for handle 0
+    bool     compact();                 // close holes and resize, returns true if blocks moved
+    inline void discardPending()        { _pending = 0; } // compaction was skipped, allocations will ask again
+
+    inline bool   needsCompaction() const { return _holes || _pending || _size > (_top ? roundChunk(_top) + 2*ARENA_CHUNK : 0); }
+    inline bool   fitsAfterCompaction(size_t len) const { return blockSize(len) <= getFree(); }
+    inline size_t getSize() const       { return _size; }       // bytes currently taken from the heap
+    inline size_t getMaxSize() const    { return _maxSize; }
+    inline size_t getUsed() const       { return _used; }       // data bytes of live blocks
+    inline size_t getPeak() const       { return _peak; }       // high-water mark of getUsed()
+    inline size_t getFree() const       { return _limit - _top + _holes; } // within the budget
+    inline size_t getHoles() const      { return _holes; }      // bytes of freed blocks below the top
+    inline unsigned getBlocks() const   { return _blocks; }
+    inline uint32_t getCompactions() const { return _compactions; }
+    inline uint32_t getFailures() const { return _failures; }   // allocations that did not fit even after compaction
+    size_t   getLargestFree() const;
+    uint8_t  getFragmentation() const;  // free space not usable by the largest possible block in %
+
+  private:
+    uint8_t  *_mem;
+    uint16_t *_slots;     // block offset by handle (handle 0 is invalid, unused slots are 0xFFFF)
+    uint16_t  _size;
+    uint16_t  _maxSize;
+    uint16_t  _limit;     // _maxSize, or the size the heap could not provide until the next free()
+    uint16_t  _pending;   // bytes of allocations that did not fit since the last compaction
+    uint8_t   _numSlots;
+    uint8_t   _blocks;    // live blocks
+    uint16_t  _top;       // end of the last block
+    uint16_t  _holes;
+    uint16_t  _used;
+    uint16_t  _peak;
+    uint32_t  _compactions;
+    uint32_t  _failures;
+
+    static inline size_t blockSize(size_t len)  { return HEADER + ((len + 3) & ~3U); }
+    static inline size_t roundChunk(size_t len) { return (len + ARENA_CHUNK - 1) / ARENA_CHUNK * ARENA_CHUNK; }
+    bool resize(size_t size);
+};
+
+#endif
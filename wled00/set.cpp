@@ -94,6 +94,15 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     strip.setTargetFps(request->arg(F("FR")).toInt());
     useGlobalLedBuffer = request->hasArg(F("LD"));
 
+    // E1.31 network bus output
+    t = request->arg(F("OU")).toInt();
+    if (t > 0 && t <= 63999) e131OutUniverse = t;
+    t = request->arg(F("OP")).toInt();
+    if (t >= 0 && t <= 200) e131OutPriority = t;
+    t = request->arg(F("OS")).toInt();
+    if (t >= 0 && t <= 63999) e131OutSyncUniverse = t;
+    if (request->hasArg(F("OC"))) setE131OutCID(request->arg(F("OC")).c_str());
+
     bool busesChanged = false;
     for (uint8_t s = 0; s < WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES; s++) {
       char lp[4] = "L0"; lp[2] = 48+s; lp[3] = 0; //ascii 0-9 //strip data pin
@@ -150,11 +159,14 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
         freqHz = 0;
       }
       channelSwap = Bus::hasWhite(type) ? request->arg(wo).toInt() : 0;
+      // per bus current limit is only set in cfg.json ("maxpwr" of the bus), keep the existing one
+      Bus *bus = busses.getBus(s);
+      uint16_t maxPwr = bus ? bus->getMaxCurrent() : 0;
       type |= request->hasArg(rf) << 7; // off refresh override
       // actual finalization is done in WLED::loop() (removing old busses and adding new)
       // this may happen even before this loop is finished so we do "doInitBusses" after the loop
       if (busConfigs[s] != nullptr) delete busConfigs[s];
-      busConfigs[s] = new BusConfig(type, pins, start, length, colorOrder | (channelSwap<<4), request->hasArg(cv), skip, awmode, freqHz, useGlobalLedBuffer);
+      busConfigs[s] = new BusConfig(type, pins, start, length, colorOrder | (channelSwap<<4), request->hasArg(cv), skip, awmode, freqHz, useGlobalLedBuffer, maxPwr);
       busesChanged = true;
     }
     //doInitBusses = busesChanged; // we will do that below to ensure all input data is processed
@@ -294,6 +306,8 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     if (t > 0) udpPort = t;
     t = request->arg(F("U2")).toInt();
     if (t > 0) udpPort2 = t;
+    t = request->arg(F("UB")).toInt();
+    if (t >= 0 && t <= 65000) udpRxBudgetUs = t;
 
     syncGroups = request->arg(F("GS")).toInt();
     receiveGroups = request->arg(F("GR")).toInt();
@@ -322,11 +336,14 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     receiveDirect = request->hasArg(F("RD"));
     useMainSegmentOnly = request->hasArg(F("MO"));
     e131SkipOutOfSequence = request->hasArg(F("ES"));
+    e131FrameSync = request->hasArg(F("FS"));
     e131Multicast = request->hasArg(F("EM"));
     t = request->arg(F("EP")).toInt();
     if (t > 0) e131Port = t;
     t = request->arg(F("EU")).toInt();
     if (t >= 0  && t <= 63999) e131Universe = t;
+    t = request->arg(F("FT")).toInt();
+    if (t >= 5  && t <= 65000) e131FrameTimeout = t;
     t = request->arg(F("DA")).toInt();
     if (t >= 0  && t <= 510) DMXAddress = t;
     t = request->arg(F("XX")).toInt();
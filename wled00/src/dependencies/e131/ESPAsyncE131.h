@@ -26,7 +26,7 @@
 #ifndef ESPASYNCE131_H_
 #define ESPASYNCE131_H_
 
-#ifdef ESP32
+#if defined(ESP32) || defined(WLED_NATIVE)
 #include <WiFi.h>
 #include <AsyncUDP.h>
 #elif defined (ESP8266)
@@ -59,6 +59,7 @@ typedef struct ip_addr ip4_addr_t;
 #define ARTNET_OPCODE_OPDMX 0x5000
 #define ARTNET_OPCODE_OPPOLL 0x2000
 #define ARTNET_OPCODE_OPPOLLREPLY 0x2100
+#define ARTNET_OPCODE_OPSYNC 0x5200
 
 #define P_E131   0
 #define P_ARTNET 1
@@ -89,6 +90,15 @@ typedef struct ip_addr ip4_addr_t;
 #define E131_DMP_COUNT 123
 #define E131_DMP_DATA 125
 
+// E1.31 vectors and synchronization packet (E1.31: 6.3)
+#define E131_VECTOR_ROOT_DATA     0x00000004
+#define E131_VECTOR_ROOT_EXTENDED 0x00000008
+#define E131_VECTOR_FRAME_DATA    0x00000002
+#define E131_VECTOR_FRAME_SYNC    0x00000001
+#define E131_SYNC_SEQ 44
+#define E131_SYNC_UNIVERSE 45
+#define E131_SYNC_PACKET_LEN 49
+
 // E1.31 Packet Structure
 typedef union {
     struct { //E1.31 packet
@@ -207,7 +217,9 @@ class ESPAsyncE131 {
     static const uint8_t ACN_ID[];
 	  static const uint8_t ART_ID[];
     static const uint32_t VECTOR_ROOT = 4;
+    static const uint32_t VECTOR_ROOT_EXTENDED = 8;
     static const uint32_t VECTOR_FRAME = 2;
+    static const uint32_t VECTOR_FRAME_SYNC = 1;
     static const uint8_t VECTOR_DMP = 2;
 
     AsyncUDP        udp;        // AsyncUDP
@@ -158,6 +158,7 @@ void realtimeLock(uint32_t timeoutMs, byte md)
       start = mainseg.start;
       stop  = mainseg.stop;
       mainseg.freeze = true;
+      mainseg.fill(BLACK); // clear segment's pixel buffer as well
     } else {
       start = 0;
       stop  = strip.getLengthTotal();
@@ -212,26 +213,22 @@ void sendTPM2Ack() {
 }
 
 
-void handleNotifications()
-{
-  IPAddress localIP;
+#define UDP_RX_NONE  0 // no packet pending
+#define UDP_RX_DONE  1 // packet applied
+#define UDP_RX_DROP  2 // packet read but not applied (disabled, filtered, invalid, own broadcast)
+#define UDP_RX_SHOW  3 // realtime pixels written, show once all pending packets are read
+#define UDP_RX_FRAME 4 // realtime frame complete (TPM2.NET), show before the next frame overwrites it
 
-  //send second notification if enabled
-  if(udpConnected && (notificationCount < udpNumRetries) && ((millis()-notificationSentTime) > 250)){
-    notify(notificationSentCallMode,true);
-  }
+static udp_rx_stats_t udpRxStats = {0};
 
-  if (e131NewData && millis() - strip.getLastShow() > 15)
-  {
-    e131NewData = false;
-    strip.show();
-  }
-
-  //unlock strip when realtime UDP times out
-  if (realtimeMode && millis() > realtimeTimeout) exitRealtime();
+const udp_rx_stats_t& getUDPReceiveStats() {
+  return udpRxStats;
+}
 
-  //receive UDP notifications
-  if (!udpConnected) return;
+// reads and handles one pending packet of notifierUdp, notifier2Udp or rgbUdp
+static byte handleUDPPacket()
+{
+  IPAddress localIP;
 
   bool isSupp = false;
   size_t packetSize = notifierUdp.parsePacket();
@@ -244,32 +241,27 @@ void handleNotifications()
   if (!packetSize && udpRgbConnected) {
     packetSize = rgbUdp.parsePacket();
     if (packetSize) {
-      if (!receiveDirect) return;
-      if (packetSize > UDP_IN_MAXSIZE || packetSize < 3) return;
+      if (!receiveDirect) return UDP_RX_DROP;
+      if (packetSize > UDP_IN_MAXSIZE || packetSize < 3) return UDP_RX_DROP;
       realtimeIP = rgbUdp.remoteIP();
       DEBUG_PRINTLN(rgbUdp.remoteIP());
       uint8_t lbuf[packetSize];
       rgbUdp.read(lbuf, packetSize);
       realtimeLock(realtimeTimeoutMs, REALTIME_MODE_HYPERION);
-      if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
-      uint16_t id = 0;
+      if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return UDP_RX_DROP;
       uint16_t totalLen = strip.getLengthTotal();
-      for (size_t i = 0; i < packetSize -2; i += 3)
-      {
-        setRealtimePixel(id, lbuf[i], lbuf[i+1], lbuf[i+2], 0);
-        id++; if (id >= totalLen) break;
-      }
-      if (!(realtimeMode && useMainSegmentOnly)) strip.show();
-      return;
+      realtimeWrite(0, lbuf, min(packetSize / 3, (size_t)totalLen), 3);
+      return (realtimeMode && useMainSegmentOnly) ? UDP_RX_DONE : UDP_RX_SHOW; // effects keep showing the strip with the main segment only
     }
   }
 
-  if (!(receiveNotifications || receiveDirect)) return;
+  if (!(receiveNotifications || receiveDirect)) return packetSize ? UDP_RX_DROP : UDP_RX_NONE;
 
   localIP = Network.localIP();
   //notifier and UDP realtime
-  if (!packetSize || packetSize > UDP_IN_MAXSIZE) return;
-  if (!isSupp && notifierUdp.remoteIP() == localIP) return; //don't process broadcasts we send ourselves
+  if (!packetSize) return UDP_RX_NONE;
+  if (packetSize > UDP_IN_MAXSIZE) return UDP_RX_DROP;
+  if (!isSupp && notifierUdp.remoteIP() == localIP) return UDP_RX_DROP; //don't process broadcasts we send ourselves
 
   uint8_t udpIn[packetSize +1];
   uint16_t len;
@@ -278,7 +270,7 @@ void handleNotifications()
 
   // WLED nodes info notifications
   if (isSupp && udpIn[0] == 255 && udpIn[1] == 1 && len >= 40) {
-    if (!nodeListEnabled || notifier2Udp.remoteIP() == localIP) return;
+    if (!nodeListEnabled || notifier2Udp.remoteIP() == localIP) return UDP_RX_DROP;
 
     uint8_t unit = udpIn[39];
     NodesMap::iterator it = Nodes.find(unit);
@@ -304,15 +296,15 @@ void handleNotifications()
           build |= udpIn[40+i]<<(8*i);
       it->second.build = build;
     }
-    return;
+    return UDP_RX_DONE;
   }
 
   //wled notifier, ignore if realtime packets active
   if (udpIn[0] == 0 && !realtimeMode && receiveNotifications)
   {
     //ignore notification if received within a second after sending a notification ourselves
-    if (millis() - notificationSentTime < 1000) return;
-    if (udpIn[1] > 199) return; //do not receive custom versions
+    if (millis() - notificationSentTime < 1000) return UDP_RX_DROP;
+    if (udpIn[1] > 199) return UDP_RX_DROP; //do not receive custom versions
 
     //compatibilityVersionByte:
     byte version = udpIn[11];
@@ -320,8 +312,8 @@ void handleNotifications()
     // if we are not part of any sync group ignore message
     if (version < 9 || version > 199) {
       // legacy senders are treated as if sending in sync group 1 only
-      if (!(receiveGroups & 0x01)) return;
-    } else if (!(receiveGroups & udpIn[36])) return;
+      if (!(receiveGroups & 0x01)) return UDP_RX_DROP;
+    } else if (!(receiveGroups & udpIn[36])) return UDP_RX_DROP;
 
     bool someSel = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects);
 
@@ -466,10 +458,10 @@ void handleNotifications()
 
     if (receiveNotificationBrightness || !someSel) bri = udpIn[2];
     stateUpdated(CALL_MODE_NOTIFICATION);
-    return;
+    return UDP_RX_DONE;
   }
 
-  if (!receiveDirect) return;
+  if (!receiveDirect) return UDP_RX_DROP;
 
   //TPM2.NET
   if (udpIn[0] == 0x9c)
@@ -478,13 +470,13 @@ void handleNotifications()
     //if the number of LEDs in your installation doesn't allow that, please include padding bytes at the end of the last packet
     byte tpmType = udpIn[1];
     if (tpmType == 0xaa) { //TPM2.NET polling, expect answer
-      sendTPM2Ack(); return;
+      sendTPM2Ack(); return UDP_RX_DONE;
     }
-    if (tpmType != 0xda) return; //return if notTPM2.NET data
+    if (tpmType != 0xda) return UDP_RX_DROP; //return if notTPM2.NET data
 
     realtimeIP = (isSupp) ? notifier2Udp.remoteIP() : notifierUdp.remoteIP();
     realtimeLock(realtimeTimeoutMs, REALTIME_MODE_TPM2NET);
-    if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
+    if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return UDP_RX_DROP;
 
     tpmPacketCount++; //increment the packet count
     if (tpmPacketCount == 1) tpmPayloadFrameSize = (udpIn[2] << 8) + udpIn[3]; //save frame size for the whole payload if this is the first packet
@@ -493,21 +485,13 @@ void handleNotifications()
 
     uint16_t id = (tpmPayloadFrameSize/3)*(packetNum-1); //start LED
     uint16_t totalLen = strip.getLengthTotal();
-    for (size_t i = 6; i < tpmPayloadFrameSize + 4U; i += 3)
-    {
-      if (id < totalLen)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-        id++;
-      }
-      else break;
-    }
+    if (id < totalLen) realtimeWrite(id, udpIn + 6, min((uint16_t)(tpmPayloadFrameSize/3), (uint16_t)(totalLen - id)), 3);
     if (tpmPacketCount == numPackets) //reset packet count and show if all packets were received
     {
       tpmPacketCount = 0;
-      strip.show();
+      return UDP_RX_FRAME;
     }
-    return;
+    return UDP_RX_DONE;
   }
 
   //UDP realtime: 1 warls 2 drgb 3 drgbw
@@ -515,16 +499,16 @@ void handleNotifications()
   {
     realtimeIP = (isSupp) ? notifier2Udp.remoteIP() : notifierUdp.remoteIP();
     DEBUG_PRINTLN(realtimeIP);
-    if (packetSize < 2) return;
+    if (packetSize < 2) return UDP_RX_DROP;
 
     if (udpIn[1] == 0)
     {
       realtimeTimeout = 0;
-      return;
+      return UDP_RX_DONE;
     } else {
       realtimeLock(udpIn[1]*1000 +1, REALTIME_MODE_UDP);
     }
-    if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
+    if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return UDP_RX_DROP;
 
     uint16_t totalLen = strip.getLengthTotal();
     if ((udpIn[0] == 1) && (packetSize > 5)) //warls - avoiding infinite "for" loop (unsigned underflow)    
@@ -535,43 +519,20 @@ void handleNotifications()
       }
     } else if (udpIn[0] == 2) //drgb
     {
-      uint16_t id = 0;
-      for (size_t i = 2; i < packetSize -2; i += 3)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-
-        id++; if (id >= totalLen) break;
-      }
-    } else if ((udpIn[0] == 3) && (packetSize > 5)) //drgbw - avoiding infinite "for" loop (unsigned underflow)
+      realtimeWrite(0, udpIn + 2, min((packetSize - 2) / 3, (size_t)totalLen), 3);
+    } else if ((udpIn[0] == 3) && (packetSize > 5)) //drgbw
     {
-      uint16_t id = 0;
-      for (size_t i = 2; i < packetSize -3; i += 4)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], udpIn[i+3]);
-
-        id++; if (id >= totalLen) break;
-      }
-    } else if (udpIn[0] == 4) //dnrgb
+      realtimeWrite(0, udpIn + 2, min((packetSize - 2) / 4, (size_t)totalLen), 4);
+    } else if ((udpIn[0] == 4) && (packetSize > 4)) //dnrgb
     {
       uint16_t id = ((udpIn[3] << 0) & 0xFF) + ((udpIn[2] << 8) & 0xFF00);
-      for (size_t i = 4; i < packetSize -2; i += 3)
-      {
-        if (id >= totalLen) break;
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-        id++;
-      }
-    } else if (udpIn[0] == 5) //dnrgbw
+      if (id < totalLen) realtimeWrite(id, udpIn + 4, min((packetSize - 4) / 3, (size_t)(totalLen - id)), 3);
+    } else if ((udpIn[0] == 5) && (packetSize > 4)) //dnrgbw
     {
       uint16_t id = ((udpIn[3] << 0) & 0xFF) + ((udpIn[2] << 8) & 0xFF00);
-      for (size_t i = 4; i < packetSize -2; i += 4)
-      {
-        if (id >= totalLen) break;
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], udpIn[i+3]);
-        id++;
-      }
+      if (id < totalLen) realtimeWrite(id, udpIn + 4, min((packetSize - 4) / 4, (size_t)(totalLen - id)), 4);
     }
-    strip.show();
-    return;
+    return UDP_RX_SHOW;
   }
 
   // API over UDP
@@ -589,6 +550,49 @@ void handleNotifications()
     }
     releaseJSONBufferLock();
   }
+  return UDP_RX_DONE;
+}
+
+void handleNotifications()
+{
+  //send second notification if enabled
+  if(udpConnected && (notificationCount < udpNumRetries) && ((millis()-notificationSentTime) > 250)){
+    notify(notificationSentCallMode,true);
+  }
+
+  handleE131Frame();
+  if (e131NewData && millis() - strip.getLastShow() > 15)
+  {
+    e131NewData = false;
+    strip.show();
+  }
+
+  //unlock strip when realtime UDP times out
+  if (realtimeMode && millis() > realtimeTimeout) exitRealtime();
+
+  //receive UDP notifications
+  if (!udpConnected) return;
+
+  // drain all sockets instead of one packet per loop, so multi packet frames do not queue up behind effect rendering
+  // but stop after udpRxBudgetUs (at least one packet is read) or at a complete frame, the rest is read in the next loop
+  const unsigned long start = micros();
+  uint16_t depth = 0;
+  bool show = false;
+  byte rx;
+  while ((rx = handleUDPPacket()) != UDP_RX_NONE) {
+    depth++;
+    if (rx == UDP_RX_DROP) udpRxStats.dropped++;
+    if (rx >= UDP_RX_SHOW) {
+      if (show) udpRxStats.coalesced++; // previous realtime data is shown together with this packet
+      show = true;
+    }
+    if (rx == UDP_RX_FRAME) break;
+    if (micros() - start >= udpRxBudgetUs) { udpRxStats.budgetHits++; break; }
+  }
+  udpRxStats.packets += depth;
+  udpRxStats.depth = depth;
+  if (depth > udpRxStats.maxDepth) udpRxStats.maxDepth = depth;
+  if (show) strip.show();
 }
 
 
@@ -611,6 +615,38 @@ void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
   }
 }
 
+#define REALTIME_CHUNK 64 // pixels converted per strip.setPixels() call
+
+// writes count pixels of channelsPerPixel (3: RGB, 4: RGBW) bytes starting at LED start, like setRealtimePixel() for each
+// but clipped once, with the gamma table chosen once and unmapped runs copied to the frame buffer or buses in one piece
+void realtimeWrite(uint16_t start, const uint8_t* data, uint16_t count, uint8_t channelsPerPixel)
+{
+  int pix = (int)start + arlsOffset;
+  int end = pix + count;
+  int len = strip.getLengthTotal();
+  Segment *seg = useMainSegmentOnly ? &strip.getMainSegment() : nullptr;
+  if (seg && seg->length() < len) len = seg->length();
+  if (pix < 0) { data -= pix * channelsPerPixel; pix = 0; }
+  if (end > len) end = len;
+  const uint8_t *gamma = (!arlsDisableGammaCorrection && gammaCorrectCol) ? NeoGammaWLEDMethod::rawGammaTable() : nullptr;
+  const bool hasW = channelsPerPixel > 3;
+
+  uint32_t cols[REALTIME_CHUNK];
+  while (pix < end) {
+    const uint16_t n = end - pix > REALTIME_CHUNK ? REALTIME_CHUNK : end - pix;
+    if (gamma) {
+      for (uint16_t i = 0; i < n; i++, data += channelsPerPixel)
+        cols[i] = RGBW32(gamma[data[0]], gamma[data[1]], gamma[data[2]], hasW ? gamma[data[3]] : 0);
+    } else {
+      for (uint16_t i = 0; i < n; i++, data += channelsPerPixel)
+        cols[i] = RGBW32(data[0], data[1], data[2], hasW ? data[3] : 0);
+    }
+    if (seg) for (uint16_t i = 0; i < n; i++) seg->setPixelColor(pix + i, cols[i]); // segment mapping (mirror, grouping, ...)
+    else     strip.setPixels(pix, cols, n);
+    pix += n;
+  }
+}
+
 /*********************************************************************************************\
    Refresh aging for remote units, drop if too old...
 \*********************************************************************************************/
@@ -690,7 +726,7 @@ void sendSysInfoUDP()
 
 
 /*********************************************************************************************\
- * Art-Net, DDP, E131 output - work in progress
+ * Art-Net, DDP, E131 output
 \*********************************************************************************************/
 
 #define DDP_HEADER_LEN 10
@@ -711,6 +747,83 @@ void sendSysInfoUDP()
 // 1440 channels per packet
 #define DDP_CHANNELS_PER_PACKET 1440 // 480 leds
 
+static       size_t sequenceNumber = 0; // this needs to be shared across all outputs
+static const size_t ART_NET_HEADER_SIZE = 12;
+static const byte   ART_NET_HEADER[] PROGMEM = {0x41,0x72,0x74,0x2d,0x4e,0x65,0x74,0x00,0x00,0x50,0x00,0x0e};
+#define ART_NET_DATA 18 // header + sequence, physical, universe and length
+
+// E1.31 (sACN) output, ANSI E1.31-2016 (packet layout in ESPAsyncE131.h)
+static byte e131OutSequence = 0;
+static byte e131OutSyncSequence = 0;
+
+// all network busses send through the same socket, BusNetwork::show() is not reentrant
+static WiFiUDP netOutUdp;
+
+static inline void put16(byte *p, uint16_t v) { p[0] = v >> 8; p[1] = v; }
+static inline void put32(byte *p, uint32_t v) { put16(p, v >> 16); put16(p+2, v); }
+static inline void putLength(byte *p, size_t len) { put16(p, 0x7000 | len); } // flags & length of an E1.31 PDU
+
+// root layer shared by data and sync packets
+static void e131PrepareRoot(byte *p, uint32_t vector) {
+  memset(p, 0, E131_FRAME_FLENGTH);
+  put16(p, 0x0010);                                   // preamble size
+  memcpy_P(p + E131_ROOT_ID, PSTR("ASC-E1.17"), 9);   // ACN packet identifier, zero padded
+  put32(p + E131_ROOT_VECTOR, vector);
+  memcpy(p + E131_ROOT_CID, e131OutCID, 16);
+  bool configured = false;
+  for (size_t i = 0; i < 16; i++) configured |= e131OutCID[i];
+  if (configured) return;
+  // no CID configured: fixed prefix and the MAC address, unique and stable per device
+  static const byte prefix[10] PROGMEM = {0x57,0x4c,0x45,0x44,0x2d,0x73,0x41,0x43,0x4e,0x00}; // "WLED-sACN"
+  memcpy_P(p + E131_ROOT_CID, prefix, sizeof(prefix));
+  const char *mac = escapedMac.c_str();  // 12 hex digits
+  for (size_t i = 0; i < 12 && isxdigit(mac[i]); i++) {
+    byte v = isdigit(mac[i]) ? mac[i] - '0' : tolower(mac[i]) - 'a' + 10;
+    p[E131_ROOT_CID + 10 + i/2] |= (i & 1) ? v : v << 4;
+  }
+}
+
+// E1.31 output CID from 32 hex digits (dashes and other separators are ignored, none: derived from the MAC address)
+void setE131OutCID(const char *hex) {
+  memset(e131OutCID, 0, sizeof(e131OutCID));
+  for (size_t n = 0; *hex && n < 32; hex++) {
+    if (!isxdigit(*hex)) continue;
+    byte v = isdigit(*hex) ? *hex - '0' : tolower(*hex) - 'a' + 10;
+    e131OutCID[n/2] |= (n & 1) ? v : v << 4;
+    n++;
+  }
+}
+
+// configured E1.31 output CID as 32 hex digits (empty if derived from the MAC address), hex needs 33 bytes
+void getE131OutCID(char *hex) {
+  bool configured = false;
+  for (size_t i = 0; i < 16; i++) configured |= e131OutCID[i];
+  hex[0] = '\0';
+  if (configured) for (size_t i = 0; i < 16; i++) sprintf(hex + 2*i, "%02x", e131OutCID[i]);
+}
+
+// copy channel data into the packet, brightness applied
+static void netFillChannels(byte *dst, const byte *src, size_t count, uint8_t bri) {
+  if (bri == 255) { memcpy(dst, src, count); return; }
+  for (size_t i = 0; i < count; i++) dst[i] = scale8(src[i], bri);
+}
+
+static bool netSendPacket(IPAddress client, uint16_t port, const byte *packet, size_t len, NetSendStats *stats) {
+  bool ok = netOutUdp.beginPacket(client, port) && netOutUdp.write(packet, len) == len && netOutUdp.endPacket();
+  if (stats) stats->sent(len, ok);
+  if (!ok) DEBUG_PRINTLN(F("Network bus: sending UDP packet failed"));
+  return ok;
+}
+
+// size of the packet buffer realtimeBroadcast() needs for a protocol type
+size_t realtimePacketSize(uint8_t type) {
+  switch (type) {
+    case 1:  return E131_DMP_DATA + 1 + 512;              // E1.31: start code + 512 channels
+    case 2:  return ART_NET_DATA + 512;
+    default: return DDP_HEADER_LEN + DDP_CHANNELS_PER_PACKET;
+  }
+}
+
 //
 // Send real time UDP updates to the specified client
 //
@@ -719,36 +832,33 @@ void sendSysInfoUDP()
 // length - the number of pixels
 // buffer - a buffer of at least length*4 bytes long
 // isRGBW - true if the buffer contains 4 components per pixel
+// packet - buffer of realtimePacketSize(type) bytes the packets are built in, owned by the caller (bus)
+// stats  - send statistics to update (optional)
+//
+// Headers are written once per frame, for every packet only the fields that change and the channel data
+// (in one pass) are filled in, then the packet goes to the UDP stack with a single write.
 
-static       size_t sequenceNumber = 0; // this needs to be shared across all outputs
-static const size_t ART_NET_HEADER_SIZE = 12;
-static const byte   ART_NET_HEADER[] PROGMEM = {0x41,0x72,0x74,0x2d,0x4e,0x65,0x74,0x00,0x00,0x50,0x00,0x0e};
-
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri, bool isRGBW)  {
-  if (!(apActive || interfacesInited) || !client[0] || !length) return 1;  // network not initialised or dummy/unset IP address  031522 ajn added check for ap
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri, bool isRGBW, uint8_t *packet, NetSendStats *stats)  {
+  if (!(apActive || interfacesInited) || !client[0] || !length || !packet) return 1;  // network not initialised or dummy/unset IP address  031522 ajn added check for ap
 
-  WiFiUDP ddpUdp;
+  const size_t channelCount = length * (isRGBW?4:3); // 1 channel for every R,G,B,(W?) value
+  byte *p = packet;
 
   switch (type) {
     case 0: // DDP
     {
       // calculate the number of UDP packets we need to send
-      size_t channelCount = length * (isRGBW? 4:3); // 1 channel for every R,G,B value
-      size_t packetCount = ((channelCount-1) / DDP_CHANNELS_PER_PACKET) +1;
+      const size_t packetCount = ((channelCount-1) / DDP_CHANNELS_PER_PACKET) +1;
 
       // there are 3 channels per RGB pixel
       uint32_t channel = 0; // TODO: allow specifying the start channel
-      // the current position in the buffer
-      size_t bufferOffset = 0;
+
+      /*2*/p[2] = isRGBW ?  DDP_TYPE_RGBW32 : DDP_TYPE_RGB24;
+      /*3*/p[3] = DDP_ID_DISPLAY;
 
       for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
         if (sequenceNumber > 15) sequenceNumber = 0;
 
-        if (!ddpUdp.beginPacket(client, DDP_DEFAULT_PORT)) {  // port defined in ESPAsyncE131.h
-          DEBUG_PRINTLN(F("WiFiUDP.beginPacket returned an error"));
-          return 1; // problem
-        }
-
         // the amount of data is AFTER the header in the current packet
         size_t packetSize = DDP_CHANNELS_PER_PACKET;
 
@@ -762,33 +872,13 @@ uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8
           }
         }
 
-        // write the header
-        /*0*/ddpUdp.write(flags);
-        /*1*/ddpUdp.write(sequenceNumber++ & 0x0F); // sequence may be unnecessary unless we are sending twice (as requested in Sync settings)
-        /*2*/ddpUdp.write(isRGBW ?  DDP_TYPE_RGBW32 : DDP_TYPE_RGB24);
-        /*3*/ddpUdp.write(DDP_ID_DISPLAY);
-        // data offset in bytes, 32-bit number, MSB first
-        /*4*/ddpUdp.write(0xFF & (channel >> 24));
-        /*5*/ddpUdp.write(0xFF & (channel >> 16));
-        /*6*/ddpUdp.write(0xFF & (channel >>  8));
-        /*7*/ddpUdp.write(0xFF & (channel      ));
-        // data length in bytes, 16-bit number, MSB first
-        /*8*/ddpUdp.write(0xFF & (packetSize >> 8));
-        /*9*/ddpUdp.write(0xFF & (packetSize     ));
-
-        // write the colors, the write write(const uint8_t *buffer, size_t size)
-        // function is just a loop internally too
-        for (size_t i = 0; i < packetSize; i += (isRGBW?4:3)) {
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
-          if (isRGBW) ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // W
-        }
+        /*0*/p[0] = flags;
+        /*1*/p[1] = sequenceNumber++ & 0x0F; // sequence may be unnecessary unless we are sending twice (as requested in Sync settings)
+        /*4*/put32(p + 4, channel);          // data offset in bytes, MSB first
+        /*8*/put16(p + 8, packetSize);       // data length in bytes, MSB first
+        netFillChannels(p + DDP_HEADER_LEN, buffer + channel, packetSize, bri);
 
-        if (!ddpUdp.endPacket()) {
-          DEBUG_PRINTLN(F("WiFiUDP.endPacket returned an error"));
-          return 1; // problem
-        }
+        if (!netSendPacket(client, DDP_DEFAULT_PORT, p, DDP_HEADER_LEN + packetSize, stats)) return 1; // problem
 
         channel += packetSize;
       }
@@ -796,29 +886,72 @@ uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8
 
     case 1: //E1.31
     {
+      const size_t E131_CHANNELS_PER_PACKET = isRGBW?512:510; // whole pixels only, 170 RGB or 128 RGBW LEDs per universe
+      const size_t packetCount = ((channelCount-1)/E131_CHANNELS_PER_PACKET)+1;
+      size_t bufferOffset = 0;
+
+      // headers are the same for every universe except for lengths and universe number
+      e131PrepareRoot(p, E131_VECTOR_ROOT_DATA);
+      put32(p + E131_FRAME_VECTOR, E131_VECTOR_FRAME_DATA);
+      memset(p + E131_FRAME_SOURCE, 0, 64);
+      strlcpy((char*)p + E131_FRAME_SOURCE, serverDescription, 64);
+      p[E131_FRAME_PRIORITY] = e131OutPriority;
+      put16(p + E131_FRAME_RESERVED, e131OutSyncUniverse);  // synchronization address, receivers wait for the sync packet if set
+      p[E131_FRAME_SEQ] = e131OutSequence++;                // once per frame, every universe sees consecutive numbers
+      p[E131_FRAME_OPT] = 0;
+      p[E131_DMP_VECTOR] = 0x02;                            // set property
+      p[E131_DMP_TYPE] = 0xA1;                              // address & data type
+      put16(p + E131_DMP_ADDR_FIRST, 0);
+      put16(p + E131_DMP_ADDR_INC, 1);
+      p[E131_DMP_DATA] = 0;                                 // DMX start code
+
+      for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
+        size_t packetSize = channelCount - bufferOffset;
+        if (packetSize > E131_CHANNELS_PER_PACKET) packetSize = E131_CHANNELS_PER_PACKET;
+        const size_t packetLen = E131_DMP_DATA + 1 + packetSize;
+
+        putLength(p + E131_ROOT_FLENGTH,  packetLen - E131_ROOT_FLENGTH);
+        putLength(p + E131_FRAME_FLENGTH, packetLen - E131_FRAME_FLENGTH);
+        put16(p + E131_FRAME_UNIVERSE, e131OutUniverse + currentPacket);
+        putLength(p + E131_DMP_FLENGTH,   packetLen - E131_DMP_FLENGTH);
+        put16(p + E131_DMP_COUNT, packetSize + 1);          // including the start code
+        netFillChannels(p + E131_DMP_DATA + 1, buffer + bufferOffset, packetSize, bri);
+        bufferOffset += packetSize;
+
+        if (!netSendPacket(client, E131_DEFAULT_PORT, p, packetLen, stats)) return 1; // problem
+      }
+
+      if (e131OutSyncUniverse) {
+        // all universes of the frame are out, tell the receiver to show them
+        byte sync[E131_SYNC_PACKET_LEN];
+        e131PrepareRoot(sync, E131_VECTOR_ROOT_EXTENDED);
+        putLength(sync + E131_ROOT_FLENGTH,  E131_SYNC_PACKET_LEN - E131_ROOT_FLENGTH);
+        putLength(sync + E131_FRAME_FLENGTH, E131_SYNC_PACKET_LEN - E131_FRAME_FLENGTH);
+        put32(sync + E131_FRAME_VECTOR, E131_VECTOR_FRAME_SYNC);
+        sync[E131_SYNC_SEQ] = e131OutSyncSequence++;
+        put16(sync + E131_SYNC_UNIVERSE, e131OutSyncUniverse);
+        sync[47] = sync[48] = 0;                            // reserved
+        if (!netSendPacket(client, E131_DEFAULT_PORT, sync, E131_SYNC_PACKET_LEN, stats)) return 1;
+      }
     } break;
 
     case 2: //ArtNet
     {
       // calculate the number of UDP packets we need to send
-      const size_t channelCount = length * (isRGBW?4:3); // 1 channel for every R,G,B,(W?) value
       const size_t ARTNET_CHANNELS_PER_PACKET = isRGBW?512:510; // 512/4=128 RGBW LEDs, 510/3=170 RGB LEDs
       const size_t packetCount = ((channelCount-1)/ARTNET_CHANNELS_PER_PACKET)+1;
 
-      uint32_t channel = 0; 
       size_t bufferOffset = 0;
 
       sequenceNumber++;
+      if (sequenceNumber > 255) sequenceNumber = 0;
 
-      for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
-
-        if (sequenceNumber > 255) sequenceNumber = 0;
-
-        if (!ddpUdp.beginPacket(client, ARTNET_DEFAULT_PORT)) {
-          DEBUG_PRINTLN(F("Art-Net WiFiUDP.beginPacket returned an error"));
-          return 1; // borked
-        }
+      memcpy_P(p, ART_NET_HEADER, ART_NET_HEADER_SIZE); // This doesn't change. Hard coded ID, OpCode, and protocol version.
+      p[12] = sequenceNumber & 0xFF; // sequence number. 1..255
+      p[13] = 0x00; // physical - more an FYI, not really used for anything. 0..3
+      p[15] = 0x00; // Universe MSB, unused.
 
+      for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
         size_t packetSize = ARTNET_CHANNELS_PER_PACKET;
 
         if (currentPacket == (packetCount - 1U)) {
@@ -828,28 +961,12 @@ uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8
           }
         }
 
-        byte header_buffer[ART_NET_HEADER_SIZE];
-        memcpy_P(header_buffer, ART_NET_HEADER, ART_NET_HEADER_SIZE);
-        ddpUdp.write(header_buffer, ART_NET_HEADER_SIZE); // This doesn't change. Hard coded ID, OpCode, and protocol version.
-        ddpUdp.write(sequenceNumber & 0xFF); // sequence number. 1..255
-        ddpUdp.write(0x00); // physical - more an FYI, not really used for anything. 0..3
-        ddpUdp.write((currentPacket) & 0xFF); // Universe LSB. 1 full packet == 1 full universe, so just use current packet number.
-        ddpUdp.write(0x00); // Universe MSB, unused.
-        ddpUdp.write(0xFF & (packetSize >> 8)); // 16-bit length of channel data, MSB
-        ddpUdp.write(0xFF & (packetSize     )); // 16-bit length of channel data, LSB
-
-        for (size_t i = 0; i < packetSize; i += (isRGBW?4:3)) {
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
-          if (isRGBW) ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // W
-        }
+        p[14] = currentPacket & 0xFF; // Universe LSB. 1 full packet == 1 full universe, so just use current packet number.
+        put16(p + 16, packetSize);    // 16-bit length of channel data, MSB first
+        netFillChannels(p + ART_NET_DATA, buffer + bufferOffset, packetSize, bri);
+        bufferOffset += packetSize;
 
-        if (!ddpUdp.endPacket()) {
-          DEBUG_PRINTLN(F("Art-Net WiFiUDP.endPacket returned an error"));
-          return 1; // borked
-        }
-        channel += packetSize;
+        if (!netSendPacket(client, ARTNET_DEFAULT_PORT, p, ART_NET_DATA + packetSize, stats)) return 1; // borked
       }
     } break;
   }
@@ -421,21 +421,22 @@ typedef enum UM_SoundSimulations {
   UMS_14_3
 } um_soundSimulations_t;
 
+// every render task has its own simulated data, effects rendered in parallel must not overwrite each other's
 um_data_t* simulateSound(uint8_t simulationId)
 {
-  static uint8_t samplePeak;
-  static float   FFT_MajorPeak;
-  static uint8_t maxVol;
-  static uint8_t binNum;
+  static WLED_RENDER_TLS uint8_t samplePeak;
+  static WLED_RENDER_TLS float   FFT_MajorPeak;
+  static WLED_RENDER_TLS uint8_t maxVol;
+  static WLED_RENDER_TLS uint8_t binNum;
 
-  static float    volumeSmth;
-  static uint16_t volumeRaw;
-  static float    my_magnitude;
+  static WLED_RENDER_TLS float    volumeSmth;
+  static WLED_RENDER_TLS uint16_t volumeRaw;
+  static WLED_RENDER_TLS float    my_magnitude;
 
   //arrays
   uint8_t *fftResult;
 
-  static um_data_t* um_data = nullptr;
+  static WLED_RENDER_TLS um_data_t* um_data = nullptr;
 
   if (!um_data) {
     //claim storage for arrays
@@ -118,6 +118,7 @@ void WLED::loop()
       delay(1); //required to make sure ESP enters modem sleep (see #1184)
     #endif
   }
+  strip.handleOutput(); // frame waiting for the buses (i.e. turned off or realtime)
   #ifdef WLED_DEBUG
   stripMillis = millis() - stripMillis;
   avgStripMillis += stripMillis;
@@ -435,6 +436,7 @@ pinManager.allocateMultiplePins(pins, sizeof(pins)/sizeof(managed_pin_type), Pin
 #endif
 
   DEBUG_PRINTLN(F("Initializing strip"));
+  renderPool.begin();
   beginStrip();
   DEBUG_PRINT(F("heap ")); DEBUG_PRINTLN(ESP.getFreeHeap());
 
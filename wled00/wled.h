@@ -380,6 +380,7 @@ WLED_GLOBAL bool irApplyToAllSelected _INIT(true); //apply IR to all selected se
 WLED_GLOBAL uint16_t udpPort    _INIT(21324); // WLED notifier default port
 WLED_GLOBAL uint16_t udpPort2   _INIT(65506); // WLED notifier supplemental port
 WLED_GLOBAL uint16_t udpRgbPort _INIT(19446); // Hyperion port
+WLED_GLOBAL uint16_t udpRxBudgetUs _INIT(2000); // time per loop for reading pending UDP packets (0: one packet per loop)
 
 WLED_GLOBAL uint8_t syncGroups    _INIT(0x01);                    // sync groups this instance syncs (bit mapped)
 WLED_GLOBAL uint8_t receiveGroups _INIT(0x01);                    // sync receive groups this instance belongs to (bit mapped)
@@ -423,7 +424,13 @@ WLED_GLOBAL uint16_t DMXSegmentSpacing _INIT(0);                  // Number of v
 WLED_GLOBAL byte e131LastSequenceNumber[E131_MAX_UNIVERSE_COUNT]; // to detect packet loss
 WLED_GLOBAL bool e131Multicast _INIT(false);                      // multicast or unicast
 WLED_GLOBAL bool e131SkipOutOfSequence _INIT(false);              // freeze instead of flickering
+WLED_GLOBAL bool e131FrameSync _INIT(false);                      // buffer multi-universe frames and show them complete (or on sync packets)
+WLED_GLOBAL uint16_t e131FrameTimeout _INIT(50);                  // show an incomplete frame after this many ms
 WLED_GLOBAL uint16_t pollReplyCount _INIT(0);                     // count number of replies for ArtPoll node report
+WLED_GLOBAL uint16_t e131OutUniverse _INIT(1);                    // first universe sent by E1.31 network busses (510 channels per universe)
+WLED_GLOBAL byte e131OutPriority _INIT(100);                      // E1.31 output priority (0-200)
+WLED_GLOBAL uint16_t e131OutSyncUniverse _INIT(0);                // E1.31 synchronization universe, a sync packet follows each frame (0 = off)
+WLED_GLOBAL byte e131OutCID[16] _INIT_N(({0}));                   // E1.31 source CID (all 0: derived from the MAC address)
 
 // mqtt
 WLED_GLOBAL unsigned long lastMqttReconnectAttempt _INIT(0);  // used for other periodic tasks too
@@ -706,6 +713,7 @@ WLED_GLOBAL bool e131NewData _INIT(false);
 // led fx library object
 WLED_GLOBAL BusManager busses _INIT(BusManager());
 WLED_GLOBAL WS2812FX strip _INIT(WS2812FX());
+WLED_GLOBAL RenderPool renderPool; // runs effects of independent segments in parallel (see render_pool.h)
 WLED_GLOBAL BusConfig* busConfigs[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES] _INIT({nullptr}); //temporary, to remember values from network callback until after
 WLED_GLOBAL bool doInitBusses _INIT(false);
 WLED_GLOBAL int8_t loadLedmap _INIT(-1);
@@ -0,0 +1,1444 @@
+#ifdef WLED_NATIVE
+#include "wled.h"
+#include <chrono>
+#include <arpa/inet.h>
+
+/*
+ * Effect throughput benchmark of the native simulator (wled_native.cpp -b csv|json)
+ *
+ * Every registered effect is rendered for a fixed number of frames on 1D strips and 2D matrices of
+ * several sizes, plain and with grouping, mirroring or a running transition (fading in from Solid),
+ * on matrices also with the 1D to 2D expansions bar, arc and corner (ignored by 2D effects).
+ * The variant "mapping" combines grouping, spacing, offset, reverse and mirror (index table walk in
+ * Segment::composite()), "remap" additionally invalidates the index tables before every frame, so the
+ * difference between both is the cost of Segment::buildMapping().
+ * The clock is simulated: each frame advances millis() by one frame time and forces a redraw, so
+ * effects see the same timing as on a device while only the host time spent in strip.service()
+ * (effect, blending and output to the virtual bus) is measured.
+ *
+ * Reported per effect/layout/variant:
+ *  us_frame, us_max  average and worst time per frame in µs
+ *  data              largest effect data (SEGENV.allocateData()) seen during the run in bytes
+ *  allocs, bytes     heap churn: number of heap allocations and bytes allocated during the run
+ */
+
+/*
+ * Render pool check (wled_native.cpp -P)
+ *
+ * Every effect runs on 4 segments at once (side by side on a 1D strip, quadrants of a matrix) and is
+ * rendered twice from the same simulated point in time and random seed: serially and on the render pool.
+ * The parallel frames must be identical to the serial ones. random8()/random16() are seeded per segment
+ * (see FX.h), only effects using Arduino's random() (hardware RNG on the ESP32, one shared rand() state
+ * here) may differ, those are reported as "random" when they do. Effects timed by micros() (which is not
+ * simulated) do not even repeat serially, they are reported as "timing".
+ */
+
+typedef struct {
+  uint16_t width, height;
+} bench_layout_t;
+
+static const bench_layout_t benchLayouts[] = {{60,1}, {300,1}, {1500,1}, {16,16}, {32,32}, {64,64}};
+
+#define BENCH_PLAIN      0
+#define BENCH_GROUPING   1
+#define BENCH_MIRROR     2
+#define BENCH_TRANSITION 3
+#define BENCH_MAPPING    4 // grouping, spacing, offset, reverse and mirror at once
+#define BENCH_REMAP      5 // as BENCH_MAPPING, index tables rebuilt every frame
+#define BENCH_BAR        6 // 1D effects expanded on matrices (map1D2D), 2D layouts only
+#define BENCH_ARC        7
+#define BENCH_CORNER     8
+static const char *const benchVariants[] = {"plain", "grouping", "mirror", "transition", "mapping", "remap", "bar", "arc", "corner"};
+
+typedef struct {
+  float    usFrame;
+  uint32_t usMax;
+  uint16_t data;
+  uint32_t allocs;
+  uint64_t bytes;
+} bench_result_t;
+
+// replace all busses with a single virtual bus and set up a (single panel) matrix if height > 1
+static void benchSetLayout(const bench_layout_t &layout) {
+  busses.removeAll();
+  uint8_t pins[] = {0};
+  BusConfig bc = BusConfig(TYPE_VIRTUAL, pins, 0, layout.width * layout.height, COL_ORDER_RGB);
+  busses.add(bc);
+
+  #ifndef WLED_DISABLE_2D
+  strip.panel.clear();
+  strip.isMatrix = layout.height > 1;
+  if (strip.isMatrix) {
+    WS2812FX::Panel p;
+    p.width  = layout.width;
+    p.height = layout.height;
+    strip.panels = 1;
+    strip.panel.push_back(p);
+  }
+  #endif
+  strip.finalizeInit(); // also sets up the matrix
+  strip.resetSegments();
+}
+
+static void benchRun(uint8_t fx, uint8_t variant, uint16_t frames, bench_result_t &res) {
+  Segment &seg = strip.getSegment(0);
+  const bool mapping = variant == BENCH_MAPPING || variant == BENCH_REMAP;
+
+  // start from Solid so runtime data of the previous run is released
+  strip.setTransition(0);
+  if (mapping) seg.setUp(seg.start, seg.stop, 3, 1, (seg.stop - seg.start) / 3, seg.startY, seg.stopY);
+  else         seg.setUp(seg.start, seg.stop, variant == BENCH_GROUPING ? 2 : 1, 0, 0, seg.startY, seg.stopY);
+  seg.setMode(FX_MODE_STATIC);
+  nativeAdvanceClock(strip.getFrameTime());
+  strip.trigger();
+  strip.service();
+
+  if (variant == BENCH_TRANSITION) strip.setTransition(frames * strip.getFrameTime() + 1000); // lasts the whole run
+  NativeHeapStats heap = nativeHeapStats();
+  seg.setMode(fx, true);
+  seg.mirror   = (variant == BENCH_MIRROR) || mapping;
+  seg.mirror_y = (variant == BENCH_MIRROR || mapping) && strip.isMatrix;
+  seg.reverse  = mapping;
+  seg.map1D2D  = variant == BENCH_BAR ? M12_pBar : variant == BENCH_ARC ? M12_pArc : variant == BENCH_CORNER ? M12_pCorner : M12_Pixels;
+  seg.markForReset();
+
+  uint64_t total = 0;
+  res.usMax = 0;
+  res.data  = 0;
+  for (uint16_t f = 0; f < frames; f++) {
+    nativeAdvanceClock(strip.getFrameTime());
+    strip.trigger();
+    if (variant == BENCH_REMAP) Segment::invalidateMappings();
+    auto t0 = std::chrono::steady_clock::now();
+    strip.service();
+    uint32_t us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+    total += us;
+    if (us > res.usMax) res.usMax = us;
+    if (seg.dataSize() > res.data) res.data = seg.dataSize();
+  }
+  NativeHeapStats heapEnd = nativeHeapStats();
+  res.usFrame = frames ? (float)total / frames : 0;
+  res.allocs  = heapEnd.allocs - heap.allocs;
+  res.bytes   = heapEnd.allocated - heap.allocated;
+}
+
+#define CHECK_SEGMENTS 4
+#define CHECK_CLOCK    100000UL // simulated millis() every check run starts at
+#define CHECK_SEED     1337
+
+static const bench_layout_t checkLayouts[] = {{1200,1}, {32,32}};
+static const uint8_t        checkPalettes[CHECK_SEGMENTS] = {0, 2, 11, 35}; // no random palette (changes with time)
+
+// render frames of the effect on CHECK_SEGMENTS segments and collect the output of the virtual bus
+// returns true if the effect used Arduino's random()
+static bool checkRender(const bench_layout_t &layout, uint8_t fx, uint16_t frames, std::vector<uint32_t> &out) {
+  strip.resetSegments(); // releases runtime data of the previous run
+  for (uint8_t i = 0; i < CHECK_SEGMENTS; i++) {
+    if (layout.height > 1) {
+      uint16_t w = layout.width/2, h = layout.height/2;
+      strip.setSegment(i, (i%2)*w, (i%2+1)*w, 1, 0, 0, (i/2)*h, (i/2+1)*h);
+    } else {
+      uint16_t w = layout.width/CHECK_SEGMENTS;
+      strip.setSegment(i, i*w, (i+1)*w);
+    }
+    Segment &seg = strip.getSegment(i);
+    seg.speed     = 64 + 48*i;
+    seg.intensity = 224 - 48*i;
+    seg.setPalette(checkPalettes[i]);
+    seg.setMode(fx);
+  }
+  nativeSetClock(CHECK_CLOCK);
+  random16_set_seed(CHECK_SEED);
+
+  BusVirtual *bus = static_cast<BusVirtual*>(busses.getBus(0));
+  bool random = false;
+  out.clear();
+  for (uint16_t f = 0; f < frames; f++) {
+    srand(CHECK_SEED + f);
+    const int next = rand();
+    srand(CHECK_SEED + f);
+    nativeAdvanceClock(strip.getFrameTime());
+    strip.trigger();
+    strip.service();
+    random |= rand() != next;
+    out.insert(out.end(), bus->getFrame(), bus->getFrame() + bus->getLength());
+  }
+  return random;
+}
+
+// compare parallel rendering with serial rendering for all (fx < 0) or a single effect, returns number of mismatches
+int runRenderPoolCheck(FILE *out, uint16_t frames, int fx) {
+  std::vector<uint32_t> serial, parallel, again;
+  char name[33];
+  unsigned ok = 0, random = 0, timing = 0, failed = 0;
+  uint16_t transition = strip.getTransition();
+  uint8_t brightness = strip.getBrightness();
+  bool enabled = renderPool.isEnabled();
+  uint32_t budget = strip.getRenderBudget();
+
+  renderPool.setEnabled(true);
+  strip.setRenderBudget(RENDER_BUDGET_UNLIMITED); // serial and parallel runs must render the same segments
+  strip.setBrightness(255, true); // compare full output even if the light is off
+  fprintf(out, "render workers: %u\n", renderPool.getWorkers());
+  strip.setTransition(0);
+  for (const bench_layout_t &layout : checkLayouts) {
+    benchSetLayout(layout);
+    for (uint8_t id = 0; id < strip.getModeCount(); id++) {
+      if (fx >= 0 && id != fx) continue;
+      if (!strncmp_P("RSVD", strip.getModeData(id), 4)) continue; // reserved slot
+      renderPool.setEnabled(false);
+      bool usesRandom = checkRender(layout, id, frames, serial);
+      renderPool.setEnabled(true);
+      checkRender(layout, id, frames, parallel);
+
+      const char *result = "ok";
+      if (serial == parallel) { ok++; }
+      else {
+        renderPool.setEnabled(false);
+        checkRender(layout, id, frames, again);
+        renderPool.setEnabled(true);
+        if (serial != again)  { result = "timing"; timing++; }
+        else if (usesRandom)  { result = "random"; random++; }
+        else                  { result = "MISMATCH"; failed++; }
+      }
+      extractModeName(id, JSON_mode_names, name, sizeof(name)-1);
+      fprintf(out, "%s,%u,%u,%u,\"%s\",%s\n", layout.height > 1 ? "2D" : "1D", layout.width, layout.height, id, name, result);
+      fflush(out);
+    }
+  }
+  fprintf(out, "identical: %u, random: %u, timing: %u, mismatches: %u\n", ok, random, timing, failed);
+  renderPool.setEnabled(enabled);
+  strip.setRenderBudget(budget);
+  strip.setBrightness(brightness, true);
+  strip.setTransition(transition);
+  return failed;
+}
+
+// run the benchmark for all (fx < 0) or a single effect, write results to out as CSV or JSON
+void runEffectBenchmark(FILE *out, bool json, uint16_t frames, int fx) {
+  bool first = true;
+  char name[33];
+  uint16_t transition = strip.getTransition();
+
+  if (json) fputs("[\n", out);
+  else      fputs("layout,width,height,variant,id,name,frames,us_frame,us_max,data,allocs,bytes\n", out);
+
+  for (const bench_layout_t &layout : benchLayouts) {
+    benchSetLayout(layout);
+    const char *layoutName = layout.height > 1 ? "2D" : "1D";
+    for (uint8_t variant = 0; variant < sizeof(benchVariants)/sizeof(benchVariants[0]); variant++) {
+      for (uint8_t id = 0; id < strip.getModeCount(); id++) {
+        if (fx >= 0 && id != fx) continue;
+        if (!strncmp_P("RSVD", strip.getModeData(id), 4)) continue; // reserved slot
+        if (variant >= BENCH_BAR && layout.height == 1) continue;
+        bench_result_t res;
+        benchRun(id, variant, frames, res);
+        extractModeName(id, JSON_mode_names, name, sizeof(name)-1);
+        if (json) {
+          fprintf(out, "%s{\"layout\":\"%s\",\"w\":%u,\"h\":%u,\"variant\":\"%s\",\"id\":%u,\"name\":\"%s\",\"frames\":%u,"
+                       "\"us_frame\":%.1f,\"us_max\":%u,\"data\":%u,\"allocs\":%u,\"bytes\":%llu}",
+                  first ? "" : ",\n", layoutName, layout.width, layout.height, benchVariants[variant], id, name, frames,
+                  res.usFrame, res.usMax, res.data, res.allocs, (unsigned long long)res.bytes);
+        } else {
+          fprintf(out, "%s,%u,%u,%s,%u,\"%s\",%u,%.1f,%u,%u,%u,%llu\n",
+                  layoutName, layout.width, layout.height, benchVariants[variant], id, name, frames,
+                  res.usFrame, res.usMax, res.data, res.allocs, (unsigned long long)res.bytes);
+        }
+        first = false;
+        fflush(out);
+      }
+    }
+  }
+  if (json) fputs("\n]\n", out);
+  strip.setTransition(transition);
+}
+/*
+ * Segment service benchmark (wled_native.cpp -S <segments>)
+ *
+ * Measures the per frame overhead of WS2812FX::service() with many small segments: scheduling, transitions,
+ * pixel buffer and mapping checks, compositing and output. Segments are SERVICE_SEG_LEN LEDs long and run
+ * Solid ("static") or a mix of cheap effects ("effects"). Best average of SERVICE_RUNS runs in µs per frame.
+ * Rendering is serial, the render pool would only add thread scheduling noise here.
+ */
+#define SERVICE_SEG_LEN 16
+#define SERVICE_RUNS    10
+
+static const uint8_t serviceEffects[] = {FX_MODE_STATIC, FX_MODE_BLINK, FX_MODE_BREATH, FX_MODE_COLOR_WIPE, FX_MODE_RAINBOW, FX_MODE_RAINBOW_CYCLE};
+
+void runServiceBenchmark(FILE *out, uint8_t segments, uint16_t frames) {
+  if (segments > strip.getMaxSegments()) segments = strip.getMaxSegments();
+  if (segments == 0) segments = 1;
+  uint16_t transition = strip.getTransition();
+  bool enabled = renderPool.isEnabled();
+  renderPool.setEnabled(false);
+  strip.setTransition(0);
+  benchSetLayout({uint16_t(segments * SERVICE_SEG_LEN), 1});
+  for (uint8_t i = 0; i < segments; i++) strip.setSegment(i, i*SERVICE_SEG_LEN, (i+1)*SERVICE_SEG_LEN);
+  fprintf(out, "segments: %u (%u bytes each), frames: %u\nscenario,us_frame,us_max\n", segments, (unsigned)sizeof(Segment), frames);
+  for (int scenario = 0; scenario < 2; scenario++) {
+    for (uint8_t i = 0; i < segments; i++) {
+      Segment &seg = strip.getSegment(i);
+      seg.setMode(scenario ? serviceEffects[i % (sizeof(serviceEffects)/sizeof(serviceEffects[0]))] : FX_MODE_STATIC);
+      seg.markForReset();
+    }
+    float best = 0;
+    uint32_t usMax = 0;
+    for (unsigned r = 0; r < SERVICE_RUNS; r++) {
+      uint64_t total = 0;
+      for (uint16_t f = 0; f < frames; f++) {
+        nativeAdvanceClock(strip.getFrameTime());
+        strip.trigger();
+        auto t0 = std::chrono::steady_clock::now();
+        strip.service();
+        uint32_t us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+        total += us;
+        if (us > usMax) usMax = us;
+      }
+      float avg = frames ? (float)total / frames : 0;
+      if (r == 0 || avg < best) best = avg;
+    }
+    fprintf(out, "%s,%.2f,%u\n", scenario ? "effects" : "static", best, usMax);
+    fflush(out);
+  }
+  renderPool.setEnabled(enabled);
+  strip.setTransition(transition);
+}
+
+/*
+ * Color kernel check & benchmark (wled_native.cpp -K)
+ *
+ * The SWAR/bulk color functions (colors.cpp) are compared with the original per channel implementations
+ * below: all fade/blend amounts on random colors, all channel combinations for the saturating add and
+ * the bulk buffer variants against a per pixel loop. Afterwards both are timed on a buffer of KERNEL_LEN pixels.
+ */
+#define KERNEL_LEN    4096
+#define KERNEL_COLORS 2048
+
+static uint32_t refFade(uint32_t c, uint8_t amount, bool video) {
+  if (video) return RGBW32(scale8_video(R(c), amount), scale8_video(G(c), amount), scale8_video(B(c), amount), scale8_video(W(c), amount));
+  return RGBW32(scale8(R(c), amount), scale8(G(c), amount), scale8(B(c), amount), scale8(W(c), amount));
+}
+
+static uint32_t refBlend(uint32_t c1, uint32_t c2, uint16_t blend, bool b16) {
+  if (blend == 0) return c1;
+  uint32_t blendmax = b16 ? 0xFFFF : 0xFF;
+  if (blend == blendmax) return c2;
+  uint8_t shift = b16 ? 16 : 8;
+  return RGBW32(((R(c2) * blend) + (R(c1) * (blendmax - blend))) >> shift, ((G(c2) * blend) + (G(c1) * (blendmax - blend))) >> shift,
+                ((B(c2) * blend) + (B(c1) * (blendmax - blend))) >> shift, ((W(c2) * blend) + (W(c1) * (blendmax - blend))) >> shift);
+}
+
+static uint32_t refAdd(uint32_t c1, uint32_t c2, bool fast) {
+  if (fast) return RGBW32(qadd8(R(c1), R(c2)), qadd8(G(c1), G(c2)), qadd8(B(c1), B(c2)), qadd8(W(c1), W(c2)));
+  uint32_t r = R(c1) + R(c2), g = G(c1) + G(c2), b = B(c1) + B(c2), w = W(c1) + W(c2);
+  uint32_t max = std::max(std::max(r, g), std::max(b, w));
+  if (max < 256) return RGBW32(r, g, b, w);
+  return RGBW32(r * 255 / max, g * 255 / max, b * 255 / max, w * 255 / max);
+}
+
+static void refBlur(uint32_t *buf, size_t len, uint8_t amount) {
+  uint8_t keep = 255 - amount, seep = amount >> 1;
+  uint32_t carryover = BLACK;
+  for (size_t i = 0; i < len; i++) {
+    uint32_t cur = buf[i];
+    uint32_t part = refFade(cur, seep, false);
+    cur = refAdd(refFade(cur, keep, false), carryover, true);
+    if (i > 0) buf[i-1] = refAdd(buf[i-1], part, true);
+    buf[i] = cur;
+    carryover = part;
+  }
+}
+
+static uint32_t kernelRandom() {
+  uint32_t c = esp_random();
+  switch (c & 3) { // plenty of black and saturated channels
+    case 0: return c & 0x00FF00FF;
+    case 1: return c | 0xFF0000FF;
+    default: return c;
+  }
+}
+
+static void kernelCheck(FILE *out, const char *name, unsigned tests, unsigned errors) {
+  fprintf(out, "%-22s %10u tests  %s\n", name, tests, errors ? "MISMATCH" : "ok");
+}
+
+// time a kernel on buf (refreshed from src before every run), returns ns per pixel
+template<typename F> static float kernelTime(uint32_t *buf, const uint32_t *src, F f) {
+  const unsigned runs = 200;
+  uint64_t ns = 0;
+  for (unsigned r = 0; r < runs; r++) {
+    memcpy(buf, src, KERNEL_LEN * sizeof(uint32_t));
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+  }
+  return float(ns) / (runs * KERNEL_LEN);
+}
+
+// returns number of failed checks
+int runColorKernelCheck(FILE *out) {
+  static uint32_t colors[KERNEL_COLORS], buf[KERNEL_LEN], ref[KERNEL_LEN], src[KERNEL_LEN], src2[KERNEL_LEN];
+  unsigned failed = 0, tests, errors;
+
+  randomSeed(42);
+  for (uint32_t &c : colors) c = kernelRandom();
+  for (size_t i = 0; i < KERNEL_LEN; i++) { src[i] = kernelRandom(); src2[i] = kernelRandom(); }
+
+  for (int video = 0; video < 2; video++) {
+    tests = errors = 0;
+    for (unsigned a = 0; a < 256; a++) for (uint32_t c : colors) { tests++; errors += color_fade(c, a, video) != refFade(c, a, video); }
+    failed += errors != 0;
+    kernelCheck(out, video ? "color_fade(video)" : "color_fade", tests, errors);
+  }
+  for (int b16 = 0; b16 < 2; b16++) {
+    tests = errors = 0;
+    for (unsigned a = 0; a < 256; a++) {
+      uint16_t blend = b16 ? (a == 255 ? 0xFFFF : (a << 8) | (esp_random() & 0xFF)) : a;
+      for (unsigned i = 0; i+1 < KERNEL_COLORS; i++) { tests++; errors += color_blend(colors[i], colors[i+1], blend, b16) != refBlend(colors[i], colors[i+1], blend, b16); }
+    }
+    failed += errors != 0;
+    kernelCheck(out, b16 ? "color_blend(16 bit)" : "color_blend", tests, errors);
+  }
+  for (int fast = 0; fast < 2; fast++) {
+    tests = errors = 0;
+    for (unsigned a = 0; a < 256; a++) for (unsigned b = 0; b < 256; b++) { // every channel pair in every lane
+      uint32_t c1 = a * 0x01010101u, c2 = b * 0x01010101u;
+      uint32_t c3 = (a << 24) | (b << 8), c4 = (b << 24) | (a << 16) | a;
+      tests += 2;
+      errors += (color_add(c1, c2, fast) != refAdd(c1, c2, fast)) + (color_add(c3, c4, fast) != refAdd(c3, c4, fast));
+    }
+    for (unsigned i = 0; i+1 < KERNEL_COLORS; i++) { tests++; errors += color_add(colors[i], colors[i+1], fast) != refAdd(colors[i], colors[i+1], fast); }
+    failed += errors != 0;
+    kernelCheck(out, fast ? "color_add(fast)" : "color_add", tests, errors);
+  }
+
+  // bulk variants against a per pixel loop of the reference functions
+  tests = errors = 0;
+  for (unsigned a = 0; a < 256; a += 3) for (int video = 0; video < 2; video++) {
+    memcpy(buf, src, sizeof(buf)); color_fade_buf(buf, KERNEL_LEN, a, video);
+    for (size_t i = 0; i < KERNEL_LEN; i++) { tests++; errors += buf[i] != refFade(src[i], a, video); }
+  }
+  failed += errors != 0;
+  kernelCheck(out, "color_fade_buf", tests, errors);
+  tests = errors = 0;
+  for (unsigned a = 0; a < 256; a += 3) for (int b16 = 0; b16 < 2; b16++) {
+    uint16_t blend = b16 ? a * 257 : a;
+    memcpy(buf, src, sizeof(buf)); color_blend_buf(buf, src2, KERNEL_LEN, blend, b16);
+    for (size_t i = 0; i < KERNEL_LEN; i++) { tests++; errors += buf[i] != refBlend(src[i], src2[i], blend, b16); }
+  }
+  failed += errors != 0;
+  kernelCheck(out, "color_blend_buf", tests, errors);
+  tests = errors = 0;
+  for (int fast = 0; fast < 2; fast++) {
+    memcpy(buf, src, sizeof(buf)); color_add_buf(buf, src2, KERNEL_LEN, fast);
+    for (size_t i = 0; i < KERNEL_LEN; i++) { tests++; errors += buf[i] != refAdd(src[i], src2[i], fast); }
+  }
+  failed += errors != 0;
+  kernelCheck(out, "color_add_buf", tests, errors);
+  tests = errors = 0;
+  for (unsigned a = 0; a < 256; a += 5) {
+    memcpy(buf, src, sizeof(buf)); color_blur_buf(buf, KERNEL_LEN, a);
+    memcpy(ref, src, sizeof(ref)); refBlur(ref, KERNEL_LEN, a);
+    for (size_t i = 0; i < KERNEL_LEN; i++) { tests++; errors += buf[i] != ref[i]; }
+  }
+  failed += errors != 0;
+  kernelCheck(out, "color_blur_buf", tests, errors);
+
+  // timing: original per pixel implementation vs. bulk kernel, ns per pixel
+  fprintf(out, "\n%-22s %10s %10s\n", "kernel (ns/pixel)", "per pixel", "bulk");
+  volatile uint8_t amount = 200; // keep the compiler from specialising on constants
+  float t1, t2;
+  t1 = kernelTime(buf, src, [&]{ for (size_t i = 0; i < KERNEL_LEN; i++) buf[i] = refFade(buf[i], amount, false); });
+  t2 = kernelTime(buf, src, [&]{ color_fade_buf(buf, KERNEL_LEN, amount); });
+  fprintf(out, "%-22s %10.2f %10.2f\n", "fade", t1, t2);
+  t1 = kernelTime(buf, src, [&]{ for (size_t i = 0; i < KERNEL_LEN; i++) buf[i] = refFade(buf[i], amount, true); });
+  t2 = kernelTime(buf, src, [&]{ color_fade_buf(buf, KERNEL_LEN, amount, true); });
+  fprintf(out, "%-22s %10.2f %10.2f\n", "fade(video)", t1, t2);
+  t1 = kernelTime(buf, src, [&]{ for (size_t i = 0; i < KERNEL_LEN; i++) buf[i] = refBlend(buf[i], src2[i], amount, false); });
+  t2 = kernelTime(buf, src, [&]{ color_blend_buf(buf, src2, KERNEL_LEN, amount); });
+  fprintf(out, "%-22s %10.2f %10.2f\n", "blend", t1, t2);
+  t1 = kernelTime(buf, src, [&]{ for (size_t i = 0; i < KERNEL_LEN; i++) buf[i] = refAdd(buf[i], src2[i], true); });
+  t2 = kernelTime(buf, src, [&]{ color_add_buf(buf, src2, KERNEL_LEN, true); });
+  fprintf(out, "%-22s %10.2f %10.2f\n", "add(fast)", t1, t2);
+  t1 = kernelTime(buf, src, [&]{ for (size_t i = 0; i < KERNEL_LEN; i++) buf[i] = refAdd(buf[i], src2[i], false); });
+  t2 = kernelTime(buf, src, [&]{ color_add_buf(buf, src2, KERNEL_LEN); });
+  fprintf(out, "%-22s %10.2f %10.2f\n", "add", t1, t2);
+  t1 = kernelTime(buf, src, [&]{ refBlur(buf, KERNEL_LEN, amount); });
+  t2 = kernelTime(buf, src, [&]{ color_blur_buf(buf, KERNEL_LEN, amount); });
+  fprintf(out, "%-22s %10.2f %10.2f\n", "blur", t1, t2);
+
+  fprintf(out, "\nfailed checks: %u\n", failed);
+  return failed;
+}
+
+/*
+ * Fixed point math check & benchmark (wled_native.cpp -M)
+ *
+ * The fixed point functions of wled_math.cpp are compared with libm (double) over their whole input range
+ * (sin/cos: every angle, sqrt: every 24 bit value plus random 32 bit ones, atan2: a grid plus random
+ * vectors, exp: the unsaturated range) and must stay within the error bounds documented there.
+ * Afterwards fixed point, the float _t variants and libm are timed on MATH_LEN random arguments.
+ */
+#define MATH_LEN 4096
+
+static void mathCheck(FILE *out, const char *name, unsigned tests, double maxErr, double bound, const char *unit) {
+  fprintf(out, "%-14s %10u tests  max error %9.3g %-4s (bound %g)  %s\n", name, tests, maxErr, unit, bound, maxErr > bound ? "EXCEEDED" : "ok");
+}
+
+// returns ns per call of f(i) for i in 0..MATH_LEN-1
+template<typename F> static float mathTime(F f) {
+  const unsigned runs = 100;
+  volatile float sink = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (unsigned r = 0; r < runs; r++) {
+    float sum = 0;
+    for (size_t i = 0; i < MATH_LEN; i++) sum += f(i);
+    sink = sink + sum;
+  }
+  uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+  return float(ns) / (runs * MATH_LEN);
+}
+
+// returns number of failed checks
+int runMathCheck(FILE *out) {
+  static uint16_t angles[MATH_LEN];
+  static int32_t  ys[MATH_LEN], xs[MATH_LEN], qs[MATH_LEN];
+  static uint32_t us[MATH_LEN];
+  static float    fangles[MATH_LEN], fys[MATH_LEN], fxs[MATH_LEN], fqs[MATH_LEN], fus[MATH_LEN];
+  const double toRad = M_PI / 32768.0;
+  unsigned failed = 0, tests;
+  double err;
+
+  for (int cosine = 0; cosine < 2; cosine++) {
+    tests = 0; err = 0;
+    for (uint32_t t = 0; t < 65536; t++, tests++) {
+      double ref = 32767.0 * (cosine ? cos(t * toRad) : sin(t * toRad));
+      err = std::max(err, fabs((cosine ? cos16_t(t) : sin16_t(t)) - ref));
+    }
+    failed += err > 1.5;
+    mathCheck(out, cosine ? "cos16_t" : "sin16_t", tests, err, 1.5, "LSB");
+  }
+
+  randomSeed(42);
+  tests = 0; err = 0;
+  for (int y = -512; y <= 512; y++) for (int x = -512; x <= 512; x++) {
+    int32_t ry = y, rx = x;
+    if (tests & 1) { ry = (int32_t)esp_random() >> (esp_random() & 31); rx = (int32_t)esp_random() >> (esp_random() & 31); }
+    if (!ry && !rx) continue;
+    tests++;
+    double d = atan2_16_t(ry, rx) - atan2((double)ry, (double)rx) / toRad;
+    if (d > 32768) d -= 65536; else if (d < -32768) d += 65536; // -PI and PI are the same angle
+    err = std::max(err, fabs(d));
+  }
+  failed += err > 2;
+  mathCheck(out, "atan2_16_t", tests, err, 2, "unit");
+
+  tests = 0; err = 0;
+  for (uint32_t v = 0; v < (1UL << 24); v++, tests++) err = std::max(err, fabs(sqrt32_t(v) - floor(sqrt((double)v))));
+  for (unsigned n = 0; n < (1UL << 20); n++, tests++) {
+    uint32_t v = n < 65536 ? n * n - (n & 1) : esp_random(); // squares and their neighbours, 0xFFFFFFFF
+    err = std::max(err, fabs(sqrt32_t(v) - floor(sqrt((double)v))));
+  }
+  failed += err > 0;
+  mathCheck(out, "sqrt32_t", tests, err, 0, "LSB");
+
+  tests = 0; err = 0;
+  for (int32_t x = -0xBC893; x < 0xB1721; x += 3, tests++) {
+    double ref = exp(x / 65536.0) * 65536.0;
+    err = std::max(err, fabs(exp16_t(x) - ref) / std::max(ref, 1.0 / 4e-5)); // relative, 1 LSB absolute for small results
+  }
+  failed += err > 4e-5;
+  mathCheck(out, "exp16_t", tests, err, 4e-5, "rel");
+
+  // timing with the same arguments for all variants, ns per call
+  for (size_t i = 0; i < MATH_LEN; i++) {
+    angles[i]  = esp_random();
+    fangles[i] = angles[i] * toRad;
+    ys[i]      = (int)random(-1024, 1025); fys[i] = ys[i];
+    xs[i]      = (int)random(1, 1025);     fxs[i] = xs[i]; // atan_t() has no quadrants, compare on the right half
+    us[i]      = esp_random();             fus[i] = us[i];
+    qs[i]      = (int)random(-0xA0000, 0xA0000); fqs[i] = qs[i] / 65536.0f;
+  }
+  fprintf(out, "\n%-14s %10s %10s %10s\n", "ns/call", "fixed", "float _t", "libm");
+  fprintf(out, "%-14s %10.2f %10.2f %10.2f\n", "sin",
+          mathTime([&](size_t i){ return float(sin16_t(angles[i])); }),
+          mathTime([&](size_t i){ return sin_t(fangles[i]); }),
+          mathTime([&](size_t i){ return sinf(fangles[i]); }));
+  fprintf(out, "%-14s %10.2f %10.2f %10.2f\n", "cos",
+          mathTime([&](size_t i){ return float(cos16_t(angles[i])); }),
+          mathTime([&](size_t i){ return cos_t(fangles[i]); }),
+          mathTime([&](size_t i){ return cosf(fangles[i]); }));
+  fprintf(out, "%-14s %10.2f %10.2f %10.2f\n", "atan2",
+          mathTime([&](size_t i){ return float(atan2_16_t(ys[i], xs[i])); }),
+          mathTime([&](size_t i){ return atan_t(fys[i] / fxs[i]); }),
+          mathTime([&](size_t i){ return atan2f(fys[i], fxs[i]); }));
+  fprintf(out, "%-14s %10.2f %10s %10.2f\n", "sqrt",
+          mathTime([&](size_t i){ return float(sqrt32_t(us[i])); }), "-",
+          mathTime([&](size_t i){ return sqrtf(fus[i]); }));
+  fprintf(out, "%-14s %10.2f %10s %10.2f\n", "exp",
+          mathTime([&](size_t i){ return float(exp16_t(qs[i])); }), "-",
+          mathTime([&](size_t i){ return expf(fqs[i]); }));
+  return failed;
+}
+
+/*
+ * Effect data arena check (wled_native.cpp -A)
+ *
+ * Simulates a playlist cycling through random effects on CHECK_SEGMENTS segments with transitions (old effects
+ * keep running on a copy of their data) and checks after every frame that all segment data lives in the arena.
+ * After each cycle all segments return to Solid: the arena must be empty and released again and the heap back at
+ * its size at the start, i.e. effect changes do not leak or fragment memory no matter how long the playlist runs.
+ * Finally checks that a copy of a segment with effect data keeps the arena from being compacted.
+ */
+#define ARENA_CHANGES 20  // effect changes per cycle
+#define ARENA_FRAMES  12  // frames between effect changes
+
+static bool arenaSegmentsOk() {
+  const SegmentArena &arena = Segment::getDataArena();
+  size_t used = 0;
+  for (size_t i = 0; i < strip.getSegmentsNum(); i++) {
+    Segment &seg = strip.getSegment(i);
+    if (!seg.data) continue;
+    if (!arena.owns(seg.data)) return false;
+    used += seg.dataSize();
+  }
+  return used <= arena.getUsed();
+}
+
+static void arenaFrames(unsigned frames) {
+  for (unsigned f = 0; f < frames; f++) {
+    nativeAdvanceClock(strip.getFrameTime());
+    strip.trigger();
+    strip.service();
+  }
+}
+
+// a copy of a segment (like the ones made by the web task) holds an arena block compactData() cannot rebase:
+// the arena must not be compacted while it exists, and the copy's data must stay intact
+static bool arenaCopyOk() {
+  const SegmentArena &arena = Segment::getDataArena();
+  strip.setTransition(0);
+  strip.getSegment(0).setMode(FX_MODE_FIRE_2012);
+  strip.getSegment(1).setMode(FX_MODE_FIRE_2012);
+  arenaFrames(2);
+  Segment &seg = strip.getSegment(1);
+  if (!strip.getSegment(0).data || !seg.data) return false;
+  bool ok = true;
+  uint32_t compactions = arena.getCompactions();
+  {
+    Segment copy(seg);
+    uint8_t *data = seg.data;
+    strip.getSegment(0).setMode(FX_MODE_STATIC); // leaves a hole below the other blocks
+    seg.freeze = true;                           // keep the data of segment 1 comparable to the copy
+    arenaFrames(2);
+    ok &= copy.data && arena.owns(copy.data) && arena.getHoles() > 0 && arena.getCompactions() == compactions;
+    ok &= seg.data == data && copy.dataSize() == seg.dataSize() && !memcmp(copy.data, seg.data, seg.dataSize());
+  }
+  arenaFrames(1); // copy is gone, the hole can be closed now
+  ok &= arena.getHoles() == 0 && arena.getCompactions() == compactions + 1 && arenaSegmentsOk();
+  seg.freeze = false;
+  seg.setMode(FX_MODE_STATIC);
+  arenaFrames(2);
+  return ok && arena.getUsed() == 0;
+}
+
+// returns number of failed cycles
+int runDataArenaCheck(FILE *out, unsigned cycles) {
+  const SegmentArena &arena = Segment::getDataArena();
+  uint16_t transition = strip.getTransition();
+  bool blending = modeBlending;
+  unsigned failed = 0;
+  size_t heap = 0;
+
+  benchSetLayout(checkLayouts[0]);
+  strip.resetSegments();
+  for (uint8_t i = 0; i < CHECK_SEGMENTS; i++) {
+    uint16_t w = checkLayouts[0].width/CHECK_SEGMENTS;
+    strip.setSegment(i, i*w, (i+1)*w);
+  }
+  strip.setTransition(ARENA_FRAMES * strip.getFrameTime() * 3 / 2); // transitions overlap the next effect change
+  modeBlending = true;
+  randomSeed(CHECK_SEED);
+  fprintf(out, "arena: up to %u bytes\n", (unsigned)arena.getMaxSize());
+  fputs("cycle,size,used,peak,blocks,frag,compactions,fails,heap\n", out);
+  for (unsigned c = 0; c <= cycles; c++) { // cycle 0 warms up (pixel buffers, mapping tables)
+    bool ok = true;
+    for (unsigned n = 0; n < ARENA_CHANGES; n++) {
+      Segment &seg = strip.getSegment(n % CHECK_SEGMENTS);
+      uint8_t fx;
+      do fx = random(1, strip.getModeCount()); while (!strncmp_P("RSVD", strip.getModeData(fx), 4));
+      seg.setMode(fx); // starts the transition
+      for (unsigned f = 0; f < ARENA_FRAMES; f++) {
+        nativeAdvanceClock(strip.getFrameTime());
+        strip.trigger();
+        strip.service();
+        ok &= arenaSegmentsOk();
+      }
+    }
+    uint8_t frag = arena.getFragmentation();
+    size_t  size = arena.getSize();
+    for (size_t i = 0; i < strip.getSegmentsNum(); i++) strip.getSegment(i).setMode(FX_MODE_STATIC);
+    for (unsigned f = 0; f < 2*ARENA_FRAMES; f++) { // let transitions finish
+      nativeAdvanceClock(strip.getTransition());
+      strip.trigger();
+      strip.service();
+    }
+    ok &= arena.getUsed() == 0 && arena.getBlocks() == 0 && arena.getSize() == 0;
+    if (c == 0) heap = nativeHeapStats().inUse;
+    ok &= nativeHeapStats().inUse == heap;
+    failed += !ok;
+    fprintf(out, "%u,%u,%u,%u,%u,%u,%u,%u,%lld%s\n", c, (unsigned)size, (unsigned)arena.getUsed(), (unsigned)arena.getPeak(), arena.getBlocks(), frag,
+            arena.getCompactions(), arena.getFailures(), (long long)nativeHeapStats().inUse - (long long)heap, ok ? "" : ",FAILED");
+    fflush(out);
+  }
+  fprintf(out, "failed cycles: %u\n", failed);
+  bool copyOk = arenaCopyOk();
+  fprintf(out, "no compaction while a segment copy exists: %s\n", copyOk ? "ok" : "FAILED");
+  failed += !copyOk;
+  modeBlending = blending;
+  strip.setTransition(transition);
+  return failed;
+}
+/*
+ * Network bus output check (wled_native.cpp -N)
+ *
+ * Network busses of every protocol send known frames to 127.0.0.1, local UDP listeners receive the packets and
+ * check the protocol fields, the split into packets/universes, the (brightness scaled) channel data and the send
+ * statistics of the bus. Also reports the time BusNetwork::show() takes per frame.
+ * Runs before setup(), so the receivers of the firmware do not occupy the ports.
+ */
+typedef struct {
+  const char *name;
+  uint8_t  type;
+  uint16_t leds;
+  uint8_t  bri;
+  uint16_t syncUniverse; // E1.31 only, also sets universe, priority and CID
+} netcheck_t;
+
+static const netcheck_t netChecks[] = {
+  {"ddp",                   TYPE_NET_DDP_RGB,    4096, 255, 0}, // 9 packets, 768 channels in the last one
+  {"ddp rgbw (bri)",        TYPE_NET_DDP_RGBW,    600, 100, 0},
+  {"artnet",                TYPE_NET_ARTNET_RGB,  400, 255, 0}, // 170 + 170 + 60 LEDs
+  {"e131",                  TYPE_NET_E131_RGB,    400, 255, 0},
+  {"e131 (sync, cid, bri)", TYPE_NET_E131_RGB,    400, 128, 99},
+};
+
+// receive one datagram, returns its length or 0 after a timeout
+static size_t netReceive(int fd, uint8_t *buf, size_t size) {
+  ssize_t n = recv(fd, buf, size, 0);
+  return n > 0 ? n : 0;
+}
+
+static int netListen(uint16_t port) {
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  sockaddr_in a{};
+  a.sin_family = AF_INET;
+  a.sin_port = htons(port);
+  a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  timeval tv = {0, 200000};
+  int size = 1 << 20; // a whole frame is queued before it is read
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+  if (fd >= 0 && bind(fd, (sockaddr*)&a, sizeof(a)) < 0) { close(fd); fd = -1; }
+  return fd;
+}
+
+static uint16_t get16(const uint8_t *p) { return (p[0] << 8) | p[1]; }
+static uint32_t get32(const uint8_t *p) { return (get16(p) << 16) | get16(p+2); }
+
+// compare count channels of a packet with the bus data starting at channel
+static unsigned netCheckChannels(BusNetwork &bus, const uint8_t *data, size_t count, size_t channel, uint8_t channels, uint8_t bri) {
+  unsigned errors = 0;
+  for (size_t i = 0; i < count; i++, channel++) {
+    uint32_t c = bus.getPixelColor(channel / channels);
+    const uint8_t v[4] = {R(c), G(c), B(c), W(c)};
+    errors += data[i] != scale8(v[channel % channels], bri);
+  }
+  return errors;
+}
+
+// checks the data packets of one frame, returns the number of wrong fields/channels
+static unsigned netCheckFrame(const netcheck_t &nc, BusNetwork &bus, int fd, unsigned &packets, size_t &bytes) {
+  static const uint8_t cid[16] = {0x10,0x32,0x54,0x76,0x98,0xba,0xdc,0xfe,0x01,0x23,0x45,0x67,0x89,0xab,0xcd,0xef};
+  const uint8_t channels = nc.type == TYPE_NET_DDP_RGBW ? 4 : 3;
+  const size_t  channelCount = nc.leds * channels;
+  const size_t  perPacket = nc.type == TYPE_NET_DDP_RGB || nc.type == TYPE_NET_DDP_RGBW ? 1440 : 510;
+  uint8_t pkt[1500];
+  unsigned errors = 0;
+  size_t channel = 0, len = 0;
+  int seq = -1;
+
+  packets = bytes = 0;
+  while (channel < channelCount && (len = netReceive(fd, pkt, sizeof(pkt))) > 0) {
+    size_t count = 0;
+    packets++;
+    bytes += len;
+    switch (nc.type) {
+      case TYPE_NET_DDP_RGB:
+      case TYPE_NET_DDP_RGBW:
+        count = get16(pkt + 8);
+        errors += len != 10 + count || get32(pkt + 4) != channel;
+        errors += pkt[0] != (channel + count == channelCount ? 0x41 : 0x40); // version 1, push with the last packet
+        errors += pkt[2] != (channels == 4 ? DDP_TYPE_RGBW32 : DDP_TYPE_RGB24) || pkt[3] != 1;
+        errors += netCheckChannels(bus, pkt + 10, count, channel, channels, nc.bri);
+        break;
+      case TYPE_NET_ARTNET_RGB:
+        count = get16(pkt + 16);
+        errors += len != 18 + count || memcmp(pkt, "Art-Net\0\0\x50\0\x0e", 12);
+        if (seq < 0) seq = pkt[12];
+        errors += pkt[12] != seq || pkt[13] != 0 || pkt[14] != packets - 1 || pkt[15] != 0;
+        errors += netCheckChannels(bus, pkt + 18, count, channel, channels, nc.bri);
+        break;
+      case TYPE_NET_E131_RGB:
+        count = get16(pkt + E131_DMP_COUNT) - 1;
+        errors += len != E131_DMP_DATA + 1 + count || get32(pkt + E131_ROOT_VECTOR) != 0x00000004;
+        errors += get16(pkt) != 0x0010 || get16(pkt + 2) != 0 || memcmp(pkt + E131_ROOT_ID, "ASC-E1.17\0\0\0", 12);
+        errors += get16(pkt + E131_ROOT_FLENGTH) != (0x7000 | (len - E131_ROOT_FLENGTH));
+        errors += nc.syncUniverse ? memcmp(pkt + E131_ROOT_CID, cid, 16) != 0 : memcmp(pkt + E131_ROOT_CID, "WLED-sACN", 10) != 0;
+        errors += get16(pkt + E131_FRAME_FLENGTH) != (0x7000 | (len - E131_FRAME_FLENGTH)) || get32(pkt + E131_FRAME_VECTOR) != 0x00000002;
+        errors += strcmp((const char*)pkt + E131_FRAME_SOURCE, serverDescription) != 0;
+        errors += pkt[E131_FRAME_PRIORITY] != e131OutPriority || get16(pkt + E131_FRAME_RESERVED) != e131OutSyncUniverse || pkt[E131_FRAME_OPT];
+        if (seq < 0) seq = pkt[E131_FRAME_SEQ];
+        errors += pkt[E131_FRAME_SEQ] != seq; // same for all universes of a frame
+        errors += get16(pkt + E131_FRAME_UNIVERSE) != e131OutUniverse + packets - 1;
+        errors += get16(pkt + E131_DMP_FLENGTH) != (0x7000 | (len - E131_DMP_FLENGTH)) || pkt[E131_DMP_VECTOR] != 0x02 || pkt[E131_DMP_TYPE] != 0xA1;
+        errors += get16(pkt + E131_DMP_ADDR_FIRST) != 0 || get16(pkt + E131_DMP_ADDR_INC) != 1 || pkt[E131_DMP_DATA] != 0;
+        errors += netCheckChannels(bus, pkt + E131_DMP_DATA + 1, count, channel, channels, nc.bri);
+        break;
+    }
+    errors += count != std::min(perPacket, channelCount - channel);
+    channel += count;
+  }
+  errors += channel != channelCount;
+
+  len = netReceive(fd, pkt, sizeof(pkt)); // E1.31 sync packet or nothing
+  if (len) { packets++; bytes += len; }
+  if (nc.syncUniverse) {
+    errors += len != 49 || get32(pkt + E131_ROOT_VECTOR) != 0x00000008 || memcmp(pkt + E131_ROOT_CID, cid, 16);
+    errors += get16(pkt + E131_ROOT_FLENGTH) != (0x7000 | 33) || get16(pkt + E131_FRAME_FLENGTH) != (0x7000 | 11);
+    errors += get32(pkt + E131_FRAME_VECTOR) != 0x00000001 || get16(pkt + 45) != e131OutSyncUniverse;
+  } else
+    errors += len != 0;
+  return errors;
+}
+
+// returns number of failed checks
+int runNetworkOutputCheck(FILE *out) {
+  static const uint8_t cid[16] = {0x10,0x32,0x54,0x76,0x98,0xba,0xdc,0xfe,0x01,0x23,0x45,0x67,0x89,0xab,0xcd,0xef};
+  unsigned failed = 0;
+
+  interfacesInited = true;
+  strlcpy(serverDescription, "netcheck", sizeof(serverDescription));
+
+  fprintf(out, "%-22s %7s %9s %6s %s\n", "protocol", "packets", "bytes", "us", "");
+  for (const netcheck_t &nc : netChecks) {
+    const uint16_t port = nc.type == TYPE_NET_ARTNET_RGB ? ARTNET_DEFAULT_PORT : nc.type == TYPE_NET_E131_RGB ? E131_DEFAULT_PORT : DDP_DEFAULT_PORT;
+    int fd = netListen(port);
+    if (fd < 0) { fprintf(out, "cannot listen on port %u\n", port); return 1; }
+    e131OutUniverse     = nc.syncUniverse ? 7 : 1;
+    e131OutPriority     = nc.syncUniverse ? 150 : 100;
+    e131OutSyncUniverse = nc.syncUniverse;
+    if (nc.syncUniverse) memcpy(e131OutCID, cid, sizeof(cid));
+    else                 memset(e131OutCID, 0, sizeof(e131OutCID));
+
+    uint8_t pins[4] = {127, 0, 0, 1};
+    BusConfig bc(nc.type, pins, 0, nc.leds, COL_ORDER_RGB);
+    BusNetwork bus(bc);
+    unsigned errors = 0, packets = 0;
+    size_t bytes = 0;
+    uint32_t us = 0;
+    for (int frame = 0; frame < 2; frame++) {
+      for (uint16_t i = 0; i < nc.leds; i++) bus.setPixelColor(i, RGBW32(i + frame, i >> 8, i * 7, 255 - i));
+      bus.setBrightness(nc.bri);
+      auto t0 = std::chrono::steady_clock::now();
+      bus.show();
+      us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+      errors += netCheckFrame(nc, bus, fd, packets, bytes);
+    }
+    const NetSendStats &stats = bus.getSendStats();
+    errors += stats.packets != 2*packets || stats.bytes != 2*bytes || stats.errors != 0; // both frames are the same size
+    failed += errors != 0;
+    fprintf(out, "%-22s %7u %9u %6u %s\n", nc.name, packets, (unsigned)bytes, us, errors ? "MISMATCH" : "ok");
+    close(fd);
+  }
+  return failed;
+}
+
+/*
+ * E1.31/Art-Net frame assembly check (wled_native.cpp -R)
+ *
+ * Feeds DMX_MODE_MULTIPLE_RGB universes of numbered frames to handleE131Packet() and checks from the strip
+ * pixels which frame each universe shows: a frame must appear as a whole when it is complete, on its sync
+ * packet or after the timeout, never universe by universe. Also checks the frame and universe statistics.
+ * Needs at least two universes worth of LEDs (more than 170).
+ */
+#define DMX_RGB_LEDS 170 // per universe in DMX_MODE_MULTIPLE_RGB with DMX address 1
+
+static uint8_t dmxValue(uint8_t frame, uint8_t u, uint16_t channel) { return frame * 37 + u * 11 + channel; }
+
+static void dmxSend(uint8_t frame, uint8_t u, uint8_t seq, byte protocol, uint16_t syncUniverse = 0) {
+  static e131_packet_t p;
+  memset(&p, 0, sizeof(p));
+  uint8_t *data;
+  if (protocol == P_ARTNET) {
+    memcpy(p.art_id, "Art-Net", 8);
+    p.art_opcode = ARTNET_OPCODE_OPDMX;
+    p.art_sequence_number = seq;
+    p.art_universe = e131Universe + u;
+    p.art_length = htons(510);
+    data = p.art_data;
+  } else {
+    p.root_vector = htonl(E131_VECTOR_ROOT_DATA);
+    p.frame_vector = htonl(E131_VECTOR_FRAME_DATA);
+    p.dmp_vector = 2;
+    p.priority = 100;
+    p.reserved = htons(syncUniverse);
+    p.sequence_number = seq;
+    p.universe = htons(e131Universe + u);
+    p.property_value_count = htons(511);
+    data = p.property_values + 1; // after the start code
+  }
+  for (uint16_t c = 0; c < 510; c++) data[c] = dmxValue(frame, u, c);
+  handleE131Packet(&p, IPAddress(127,0,0,1), protocol);
+}
+
+static void dmxSync(byte protocol, uint16_t syncUniverse) {
+  static e131_packet_t p;
+  memset(&p, 0, sizeof(p));
+  if (protocol == P_ARTNET) {
+    memcpy(p.art_id, "Art-Net", 8);
+    p.art_opcode = ARTNET_OPCODE_OPSYNC;
+  } else {
+    p.root_vector = htonl(E131_VECTOR_ROOT_EXTENDED);
+    p.frame_vector = htonl(E131_VECTOR_FRAME_SYNC);
+    p.raw[E131_SYNC_UNIVERSE] = syncUniverse >> 8;
+    p.raw[E131_SYNC_UNIVERSE+1] = syncUniverse & 0xFF;
+  }
+  handleE131Packet(&p, IPAddress(127,0,0,1), protocol);
+}
+
+// frame shown by the first and last LED of universe u, -1 if they differ or match no frame
+static int dmxShownFrame(uint8_t u, uint8_t universes) {
+  const uint16_t len = strip.getLengthTotal();
+  const uint16_t first = u * DMX_RGB_LEDS;
+  const uint16_t last = u == universes-1 ? len - 1 : first + DMX_RGB_LEDS - 1;
+  for (int f = 0; f < 256; f++) {
+    const uint32_t a = RGBW32(dmxValue(f, u, 0), dmxValue(f, u, 1), dmxValue(f, u, 2), 0);
+    const uint16_t c = (last - first) * 3;
+    const uint32_t b = RGBW32(dmxValue(f, u, c), dmxValue(f, u, c+1), dmxValue(f, u, c+2), 0);
+    if ((strip.getPixelColor(first) & 0xFFFFFF) == a && (strip.getPixelColor(last) & 0xFFFFFF) == b) return f;
+  }
+  return -1;
+}
+
+// checks that universes [from, to) show frame and all others show other
+static bool dmxShows(uint8_t universes, int frame, uint8_t from = 0, uint8_t to = 255, int other = -2) {
+  bool ok = true;
+  for (uint8_t u = 0; u < universes; u++) {
+    const bool inside = u >= from && u < to;
+    if (inside || other != -2) ok &= dmxShownFrame(u, universes) == (inside ? frame : other);
+  }
+  return ok;
+}
+
+// returns number of failed checks
+int runFrameSyncCheck(FILE *out) {
+  const uint8_t  universes = 1 + (strip.getLengthTotal() - 1) / DMX_RGB_LEDS;
+  if (universes < 2 || universes > E131_MAX_UNIVERSE_COUNT) { fprintf(out, "needs 171 to %d LEDs\n", E131_MAX_UNIVERSE_COUNT * DMX_RGB_LEDS); return 1; }
+  const uint8_t  last = universes - 1;
+  const e131_frame_stats_t &fs = getE131FrameStats();
+  uint8_t  count;
+  const e131_universe_stats_t *us = getE131UniverseStats(count);
+  unsigned failed = 0;
+  uint8_t  seq = 1;
+  auto check = [&](const char *name, bool ok) { fprintf(out, "%-40s %s\n", name, ok ? "ok" : "MISMATCH"); failed += !ok; };
+
+  DMXMode = DMX_MODE_MULTIPLE_RGB;
+  DMXAddress = 1;
+  e131Universe = 1;
+  e131SkipOutOfSequence = false;
+  arlsOffset = 0;
+  arlsDisableGammaCorrection = true;
+  useMainSegmentOnly = false;
+  strip.setBrightness(255, true);
+
+  e131FrameSync = false; // universes are written as they arrive
+  for (uint8_t u = 0; u < universes; u++) dmxSend(1, u, seq, P_E131);
+  seq++;
+  dmxSend(2, 0, seq, P_E131);
+  check("unbuffered: written on arrival", dmxShows(universes, 2, 0, 1, 1));
+  for (uint8_t u = 1; u < universes; u++) dmxSend(2, u, seq, P_E131);
+  seq++;
+
+  e131FrameSync = true;
+  e131FrameTimeout = 50;
+  for (uint8_t u = 0; u < last; u++) dmxSend(3, u, seq, P_E131);
+  bool held = dmxShows(universes, 2);
+  dmxSend(3, last, seq, P_E131);
+  seq++;
+  check("complete frame shown at once", held && dmxShows(universes, 3) && fs.complete == 1 && e131NewData);
+
+  for (uint8_t u = 0; u < 2; u++) dmxSend(4, u, seq, P_E131);
+  seq++;
+  dmxSend(5, 0, seq, P_E131); // next frame starts, 4 is shown without the missing universes
+  check("repeated universe shows incomplete frame", dmxShows(universes, 4, 0, 2, 3) && fs.incomplete == 1);
+  for (uint8_t u = 1; u < universes; u++) dmxSend(5, u, seq, P_E131);
+  seq++;
+  check("next frame complete", dmxShows(universes, 5) && fs.complete == 2);
+
+  for (uint8_t u = 0; u < last; u++) dmxSend(6, u, seq, P_E131);
+  handleE131Frame();
+  held = dmxShows(universes, 5);
+  delay(e131FrameTimeout + 10);
+  handleE131Frame();
+  check("timeout shows incomplete frame", held && dmxShows(universes, 6, 0, last, 5) && fs.timeouts == 1);
+  const uint32_t late = us[last].late;
+  dmxSend(6, last, seq, P_E131); // after its frame was shown
+  seq++;
+  check("late universe written directly", dmxShows(universes, 6) && us[last].late == late + 1);
+
+  for (uint8_t u = 0; u < universes; u++) dmxSend(7, u, seq, P_E131, 100); // sender announces sync universe 100
+  seq++;
+  held = dmxShows(universes, 7); // complete, no sync packet seen yet
+  dmxSync(P_E131, 100);
+  for (uint8_t u = 0; u < universes; u++) dmxSend(8, u, seq, P_E131, 100);
+  seq++;
+  held &= dmxShows(universes, 7);
+  dmxSync(P_E131, 99);
+  held &= dmxShows(universes, 7);
+  dmxSync(P_E131, 100);
+  check("E1.31 sync shows frame", held && dmxShows(universes, 8) && fs.synced == 1);
+
+  dmxSync(P_ARTNET, 0);
+  for (uint8_t u = 0; u < universes; u++) dmxSend(9, u, seq, P_ARTNET);
+  seq++;
+  held = dmxShows(universes, 8);
+  dmxSync(P_ARTNET, 0);
+  check("ArtSync shows frame", held && dmxShows(universes, 9) && fs.synced == 2);
+
+  e131_universe_stats_t before = us[0];
+  e131FrameSync = false;
+  dmxSend(10, 0, seq, P_E131);
+  dmxSend(10, 0, seq + 2, P_E131); // seq + 1 missing
+  dmxSend(10, 0, seq + 1, P_E131); // arrives out of order
+  dmxSend(10, 0, seq + 4, P_E131); // seq + 3 lost
+  check("sequence statistics", us[0].packets == before.packets + 4 && us[0].lost == before.lost + 1 && us[0].ooo == before.ooo + 1);
+  handleE131Frame(); // frees the buffer
+
+  fprintf(out, "%u universes: complete %u, synced %u, incomplete %u, timeouts %u\n", count, fs.complete, fs.synced, fs.incomplete, fs.timeouts);
+  return failed;
+}
+
+/*
+ * Realtime ingest benchmark (wled_native.cpp -I)
+ *
+ * Writes whole frames in the pixel runs of each realtime protocol, once through setRealtimePixel() per pixel
+ * (as the decoders used to) and once through realtimeWrite(), checks that both leave the same pixels with
+ * gamma correction, positive and negative LED offsets and main segment only output, and reports pixels/s.
+ * DDP and E1.31 are also timed end to end through handleE131Packet().
+ */
+typedef struct {
+  const char *name;
+  uint8_t     channels;
+  uint16_t    run;      // pixels per packet
+} ingest_protocol_t;
+
+static const ingest_protocol_t ingestProtocols[] = {
+  {"ddp",       3, 480}, // 1440 channels per packet
+  {"ddp rgbw",  4, 360},
+  {"e131",      3, 170}, // one universe
+  {"e131 rgbw", 4, 128},
+  {"drgb",      3, 490}, // UDP_IN_MAXSIZE
+  {"drgbw",     4, 367},
+  {"dnrgb",     3, 489},
+  {"tpm2.net",  3, 340},
+  {"hyperion",  3, 490},
+};
+
+static void ingestFrame(const ingest_protocol_t &p, const uint8_t *data, bool bulk) {
+  const uint16_t len = strip.getLengthTotal();
+  for (uint16_t start = 0; start < len; start += p.run) {
+    const uint16_t n = len - start < p.run ? len - start : p.run;
+    const uint8_t *d = data + start * p.channels;
+    if (bulk) realtimeWrite(start, d, n, p.channels);
+    else for (uint16_t i = 0; i < n; i++, d += p.channels) setRealtimePixel(start + i, d[0], d[1], d[2], p.channels > 3 ? d[3] : 0);
+  }
+}
+
+static void ingestRead(uint32_t *out) {
+  const uint16_t len = strip.getLengthTotal();
+  Segment &seg = strip.getMainSegment();
+  for (uint16_t i = 0; i < len; i++) out[i] = useMainSegmentOnly ? (i < seg.length() ? seg.getPixelColor(i) : 0) : strip.getPixelColor(i);
+}
+
+static void ingestClear() {
+  strip.fill(BLACK);
+  strip.getMainSegment().fill(BLACK);
+}
+
+static double ingestRate(const ingest_protocol_t &p, const uint8_t *data, bool bulk, unsigned frames) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (unsigned f = 0; f < frames; f++) ingestFrame(p, data, bulk);
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  return (double)frames * strip.getLengthTotal() / s;
+}
+
+// returns number of protocols with differing pixels
+int runRealtimeIngestBenchmark(FILE *out, unsigned frames) {
+  typedef struct { bool gamma; int offset; bool mainOnly; } variant_t;
+  static const variant_t variants[] = {{false, 0, false}, {true, 0, false}, {false, 7, false}, {true, -5, false}, {true, 3, true}};
+  const uint16_t len = strip.getLengthTotal();
+  uint8_t  *data = (uint8_t*)malloc(len * 4);
+  uint32_t *ref  = (uint32_t*)malloc(len * sizeof(uint32_t));
+  uint32_t *res  = (uint32_t*)malloc(len * sizeof(uint32_t));
+  const bool gamma = gammaCorrectCol, noGamma = arlsDisableGammaCorrection, mainOnly = useMainSegmentOnly;
+  const int  offset = arlsOffset;
+  unsigned failed = 0;
+
+  for (size_t i = 0; i < len * 4U; i++) data[i] = i * 7 + (i >> 8);
+  strip.setBrightness(255, true);
+  Segment &main = strip.getMainSegment();
+  const uint16_t mainStop = main.stop;
+  main.stop = main.start + (main.stop - main.start) / 2; // main segment only output must clip at the segment
+
+  fprintf(out, "%-12s %8s %8s %6s %s\n", "protocol", "old Mpx/s", "new Mpx/s", "gain", "");
+  for (const ingest_protocol_t &p : ingestProtocols) {
+    bool same = true;
+    for (const variant_t &v : variants) {
+      gammaCorrectCol = v.gamma;
+      arlsDisableGammaCorrection = false;
+      arlsOffset = v.offset;
+      useMainSegmentOnly = v.mainOnly;
+      ingestClear(); ingestFrame(p, data, false); ingestRead(ref);
+      ingestClear(); ingestFrame(p, data, true);  ingestRead(res);
+      same &= !memcmp(ref, res, len * sizeof(uint32_t));
+    }
+    gammaCorrectCol = true;
+    arlsOffset = 0;
+    useMainSegmentOnly = false;
+    const double before = ingestRate(p, data, false, frames);
+    const double after  = ingestRate(p, data, true, frames);
+    failed += !same;
+    fprintf(out, "%-12s %8.1f %8.1f %5.1fx %s\n", p.name, before / 1e6, after / 1e6, after / before, same ? "ok" : "MISMATCH");
+  }
+  main.stop = mainStop;
+
+  // whole decoders
+  static e131_packet_t packet;
+  DMXMode = DMX_MODE_MULTIPLE_RGB;
+  DMXAddress = 1;
+  e131Universe = 1;
+  e131FrameSync = false;
+  for (uint8_t proto = 0; proto < 2; proto++) {
+    const uint16_t run = proto ? 170 : 480;
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned f = 0; f < frames; f++) {
+      for (uint16_t start = 0, u = 0; start < len && u < E131_MAX_UNIVERSE_COUNT; start += run, u++) {
+        const uint16_t n = len - start < run ? len - start : run;
+        memset(packet.raw, 0, 126);
+        if (proto) {
+          packet.root_vector = htonl(E131_VECTOR_ROOT_DATA);
+          packet.sequence_number = f;
+          packet.universe = htons(e131Universe + u);
+          packet.property_value_count = htons(1 + n * 3);
+          memcpy(packet.property_values + 1, data + start * 3, n * 3);
+        } else {
+          packet.flags = 0x40 | (start + n == len ? DDP_PUSH_FLAG : 0);
+          packet.channelOffset = htonl(start * 3);
+          packet.dataLen = htons(n * 3);
+          memcpy(packet.data, data + start * 3, n * 3);
+        }
+        handleE131Packet(&packet, IPAddress(127,0,0,1), proto ? P_E131 : P_DDP);
+      }
+    }
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    const unsigned pixels = proto ? min((unsigned)len, 170U * E131_MAX_UNIVERSE_COUNT) : len;
+    fprintf(out, "%-12s %8s %8.1f  (handleE131Packet)\n", proto ? "e131 packets" : "ddp packets", "", (double)frames * pixels / s / 1e6);
+  }
+
+  gammaCorrectCol = gamma;
+  arlsDisableGammaCorrection = noGamma;
+  arlsOffset = offset;
+  useMainSegmentOnly = mainOnly;
+  free(data);
+  free(ref);
+  free(res);
+  return failed;
+}
+
+/*
+ * UDP receive drain check (wled_native.cpp -U)
+ *
+ * Queues UDP realtime packets on the notifier port from 127.0.0.2 (127.0.0.1 is the simulated own address,
+ * whose packets are ignored) and checks how handleNotifications() drains them: all DRGB frames in one loop,
+ * shown once with the newest data, TPM2.NET up to the end of each frame, one packet per loop without a budget,
+ * and the drop counter for packets that are not applied.
+ */
+#define UDP_RX_MAXSIZE 1472 // UDP_IN_MAXSIZE in udp.cpp
+
+static int udpSender() {
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  sockaddr_in a{};
+  a.sin_family = AF_INET;
+  a.sin_addr.s_addr = inet_addr("127.0.0.2");
+  if (fd >= 0 && bind(fd, (sockaddr*)&a, sizeof(a)) < 0) { close(fd); fd = -1; }
+  return fd;
+}
+
+static void udpSend(int fd, const uint8_t *packet, size_t len) {
+  sockaddr_in a{};
+  a.sin_family = AF_INET;
+  a.sin_port = htons(udpPort);
+  a.sin_addr.s_addr = inet_addr("127.0.0.1");
+  sendto(fd, packet, len, 0, (sockaddr*)&a, sizeof(a));
+}
+
+// DRGB packet for LEDs 0..leds-1 with all LEDs set to the color (r, 0, 255-r)
+static size_t udpDRGB(uint8_t *packet, uint16_t leds, uint8_t r) {
+  packet[0] = 2;
+  packet[1] = 2; // realtime timeout in s
+  for (uint16_t i = 0; i < leds; i++) { packet[2+3*i] = r; packet[3+3*i] = 0; packet[4+3*i] = 255 - r; }
+  return 2 + 3 * leds;
+}
+
+// returns number of failed checks
+int runUDPReceiveCheck(FILE *out) {
+  for (unsigned long start = millis(); !udpConnected && millis() - start < 3000; ) WLED::instance().loop(); // interfaces come up in loop()
+  int fd = udpSender();
+  if (!udpConnected || fd < 0) { fprintf(out, "notifier socket not available\n"); return 1; }
+  const udp_rx_stats_t &rx = getUDPReceiveStats();
+  const perf_stat_t &shows = strip.getShowPerf();
+  const uint16_t budget = udpRxBudgetUs;
+  const uint16_t leds = strip.getLengthTotal() < 490 ? strip.getLengthTotal() : 490;
+  uint8_t  packet[UDP_RX_MAXSIZE + 16];
+  unsigned failed = 0;
+  uint32_t packets, coalesced, dropped, budgetHits, showCount;
+  auto mark = [&]() { packets = rx.packets; coalesced = rx.coalesced; dropped = rx.dropped; budgetHits = rx.budgetHits; showCount = shows.count; };
+  auto check = [&](const char *name, bool ok) { fprintf(out, "%-40s %s\n", name, ok ? "ok" : "MISMATCH"); failed += !ok; };
+
+  arlsDisableGammaCorrection = true;
+  arlsOffset = 0;
+  useMainSegmentOnly = false;
+  strip.setBrightness(255, true);
+  handleNotifications(); // drain anything left from booting
+  udpRxBudgetUs = 10000;
+
+  mark();
+  for (uint8_t f = 1; f <= 8; f++) udpSend(fd, packet, udpDRGB(packet, leds, f * 20));
+  delay(5);
+  handleNotifications();
+  check("DRGB: 8 frames drained in one loop", rx.packets == packets + 8 && rx.depth == 8 && rx.coalesced == coalesced + 7);
+  check("DRGB: shown once, newest frame", shows.count == showCount + 1 && strip.getPixelColor(leds - 1) == RGBW32(160, 0, 95, 0));
+
+  // two TPM2.NET frames of three packets each
+  mark();
+  const uint16_t perPacket = leds / 3;
+  for (uint8_t f = 0; f < 2; f++) for (uint8_t p = 1; p <= 3; p++) {
+    packet[0] = 0x9c;
+    packet[1] = 0xda;
+    packet[2] = (perPacket * 3) >> 8;
+    packet[3] = (perPacket * 3) & 0xFF;
+    packet[4] = p;
+    packet[5] = 3;
+    memset(packet + 6, f ? 200 : 100, perPacket * 3);
+    packet[6 + perPacket * 3] = 0x36;
+    udpSend(fd, packet, 7 + perPacket * 3);
+  }
+  delay(5);
+  handleNotifications();
+  bool first = rx.depth == 3 && shows.count == showCount + 1 && strip.getPixelColor(0) == RGBW32(100, 100, 100, 0) && strip.getPixelColor(3 * perPacket - 1) == RGBW32(100, 100, 100, 0);
+  handleNotifications();
+  bool second = rx.depth == 3 && shows.count == showCount + 2 && strip.getPixelColor(0) == RGBW32(200, 200, 200, 0);
+  check("TPM2.NET: one frame per loop, shown once", first && second && rx.packets == packets + 6);
+
+  udpRxBudgetUs = 0;
+  mark();
+  for (uint8_t f = 1; f <= 3; f++) udpSend(fd, packet, udpDRGB(packet, leds, f));
+  delay(5);
+  unsigned depths = 0;
+  for (int i = 0; i < 4; i++) { handleNotifications(); depths = depths * 10 + rx.depth; }
+  check("no budget: one packet per loop", depths == 1110 && rx.budgetHits == budgetHits + 3);
+  udpRxBudgetUs = budget;
+
+  mark();
+  memset(packet, 2, sizeof(packet));
+  udpSend(fd, packet, UDP_RX_MAXSIZE + 1);     // too large
+  packet[0] = 0x9c; packet[1] = 0x00;
+  udpSend(fd, packet, 10);                     // neither TPM2.NET data nor poll
+  delay(5);
+  handleNotifications();
+  check("invalid packets dropped", rx.packets == packets + 2 && rx.dropped == dropped + 2 && shows.count == showCount);
+
+  fprintf(out, "packets %u, dropped %u, coalesced %u, budget hits %u, max depth %u\n", rx.packets, rx.dropped, rx.coalesced, rx.budgetHits, rx.maxDepth);
+  close(fd);
+  return failed;
+}
+
+/*
+ * ABL estimate check (wled_native.cpp -L)
+ *
+ * The buses accumulate the ABL channel sums while a frame is pushed (BusDigital::setPixels()) instead of the pixels
+ * being read back afterwards. The estimate has to be identical to what reading the pixels back from the buses gives
+ * when the frame is pushed at full brightness. Random frames on digital buses of all channel layouts (RGB, RGBW,
+ * white-only x3, WWA, 16 bit, buffered and unbuffered, auto white, reversed) with random segment CCT, white balance
+ * correction, current limits and per-bus limits ("maxpwr"): the brightness of each bus and the estimated current
+ * are compared with the ones derived from the read-back walk.
+ */
+typedef struct {
+  uint8_t  type;
+  uint16_t len;
+  bool     buffered;
+  bool     reversed;
+  uint8_t  autoWhite;
+} abl_bus_t;
+
+static const abl_bus_t ablBuses[] = {
+  {TYPE_WS2812_RGB,    60, false, false, RGBW_MODE_MANUAL_ONLY},
+  {TYPE_WS2812_RGB,    33, true,  true,  RGBW_MODE_MANUAL_ONLY},
+  {TYPE_SK6812_RGBW,   48, false, true,  RGBW_MODE_AUTO_BRIGHTER},
+  {TYPE_SK6812_RGBW,   45, true,  false, RGBW_MODE_AUTO_ACCURATE},
+  {TYPE_WS2812_1CH_X3, 30, false, false, RGBW_MODE_DUAL},
+  {TYPE_WS2812_1CH_X3, 30, true,  false, RGBW_MODE_MANUAL_ONLY},
+  {TYPE_WS2812_WWA,    24, false, false, RGBW_MODE_AUTO_BRIGHTER},
+  {TYPE_UCS8904,       20, false, true,  RGBW_MODE_MAX},
+};
+#define ABL_BUSES (sizeof(ablBuses)/sizeof(ablBuses[0]))
+#define ABL_SEGMENTS 6
+
+// same as limitBriToBudget() in FX_fcn.cpp
+static uint8_t ablLimit(size_t milliamps, size_t budget, uint8_t bri) {
+  if (milliamps * bri / 255 <= budget) return bri;
+  float scale = (float)(budget * 255) / (float)(milliamps * bri);
+  uint16_t scaleI = scale * 255;
+  return scale8(bri, scaleI > 255 ? 255 : scaleI) + 1;
+}
+
+// returns number of frames that differ
+int runABLCheck(FILE *out, unsigned frames) {
+  const uint16_t maxPwr  = strip.ablMilliampsMax;
+  const uint8_t  mAPerLed = strip.milliampsPerLed;
+  const uint8_t  bri      = strip.getBrightness();
+  const bool     wb = correctWB, cctRgb = cctFromRgb;
+  uint16_t limits[ABL_BUSES];
+  unsigned failed = 0, limited = 0, busLimited = 0;
+  uint32_t frame[1024];
+
+  randomSeed(CHECK_SEED);
+  strip.setTransition(0);
+  cctFromRgb = false;
+  for (unsigned f = 0; f < frames; f++) {
+    if (f % 16 == 0) { // new set of buses with random limits
+      busses.removeAll();
+      uint16_t start = 0;
+      for (uint8_t b = 0; b < ABL_BUSES; b++) {
+        const abl_bus_t &ab = ablBuses[b];
+        uint8_t pins[] = {(uint8_t)(b < 4 ? 12 + b : 21 + b)}; // 12..15, 25..28
+        limits[b] = random(4) ? 0 : random(50, 1500);
+        BusConfig bc(ab.type, pins, start, ab.len, COL_ORDER_GRB, ab.reversed, 0, ab.autoWhite, 0, ab.buffered, limits[b]);
+        busses.add(bc);
+        start += ab.len;
+      }
+      #ifndef WLED_DISABLE_2D
+      strip.panel.clear();
+      strip.isMatrix = false;
+      #endif
+      strip.finalizeInit();
+      strip.resetSegments();
+      const uint16_t len = strip.getLengthTotal() / ABL_SEGMENTS;
+      for (uint8_t s = 0; s < ABL_SEGMENTS; s++) strip.setSegment(s, s*len, s == ABL_SEGMENTS-1 ? strip.getLengthTotal() : (s+1)*len);
+    }
+    const uint16_t length = strip.getLengthTotal();
+    if (busses.getNumBusses() != ABL_BUSES || length > sizeof(frame)/sizeof(frame[0])) { fprintf(out, "buses not available\n"); return 1; }
+
+    strip.ablMilliampsMax = random(4) ? random(150, 4000) : 0;
+    strip.milliampsPerLed = random(3) ? 55 : (random(2) ? 30 : 255);
+    correctWB = random(2);
+    strip.setBrightness(random(1, 256), true);
+    for (uint8_t s = 0; s < strip.getSegmentsNum(); s++) {
+      Segment &seg = strip.getSegment(s);
+      seg.setMode(FX_MODE_STATIC);
+      seg.setColor(0, RGBW32(random(256), random(256), random(256), random(3) ? random(256) : 0));
+      seg.setCCT(random(256));
+      seg.setOpacity(random(64, 256));
+    }
+    nativeAdvanceClock(strip.getFrameTime());
+    strip.trigger();
+    strip.service(); // composite and push with ABL
+    uint8_t  busBri[ABL_BUSES];
+    for (uint8_t b = 0; b < ABL_BUSES; b++) busBri[b] = busses.getBus(b)->getBrightness();
+    const size_t current = strip.currentMilliamps;
+
+    // reference: push the same frame at full brightness and read the pixels back from the buses
+    for (uint16_t i = 0; i < length; i++) frame[i] = strip.getPixelColor(i);
+    uint32_t walks[ABL_BUSES] = {0};
+    const bool abl = strip.ablMilliampsMax >= 150 && strip.milliampsPerLed > 0;
+    busses.setBrightness(255);
+    for (uint8_t s = 0; s < strip.getSegmentsNum(); s++) {
+      Segment &seg = strip.getSegment(s);
+      busses.setSegmentCCT(seg.currentBri(true), correctWB);
+      busses.setPixels(seg.start, frame + seg.start, seg.stop - seg.start);
+    }
+    busses.setSegmentCCT(-1);
+    const uint8_t pm = strip.milliampsPerLed == 255 ? POWER_MODEL_WS2815 : POWER_MODEL_CHANNELS;
+    for (uint8_t b = 0; b < ABL_BUSES; b++) {
+      Bus *bus = busses.getBus(b);
+      for (uint16_t i = 0; i < bus->getLength(); i++) {
+        uint32_t c = bus->getPixelColor(i);
+        walks[b] += Bus::pixelPower(pm, R(c), G(c), B(c), W(c));
+      }
+    }
+    busses.show();
+
+    // old estimate from the read-back sums
+    bool ok = true;
+    uint8_t expBri[ABL_BUSES];
+    size_t  expCurrent = 0;
+    if (abl) {
+      const size_t mAPerLedEff = strip.milliampsPerLed == 255 ? 12 : strip.milliampsPerLed;
+      size_t budget = strip.ablMilliampsMax - 100, pLen = 0, total = 0, busPower[ABL_BUSES];
+      bool busLimits = false;
+      for (uint8_t b = 0; b < ABL_BUSES; b++) {
+        Bus *bus = busses.getBus(b);
+        busPower[b] = bus->hasWhite() ? (walks[b] * 3) >> 2 : walks[b];
+        total += busPower[b];
+        pLen += bus->getLength();
+        busLimits |= limits[b] > 0;
+      }
+      budget = budget > pLen ? budget - pLen : 0;
+      total = total * mAPerLedEff / 765;
+      const uint8_t newBri = ablLimit(total, budget, strip.getBrightness());
+      expCurrent = total * newBri / 255;
+      if (busLimits) expCurrent = 0;
+      for (uint8_t b = 0; b < ABL_BUSES; b++) {
+        expBri[b] = newBri;
+        if (!busLimits) continue;
+        const size_t busMilliamps = busPower[b] * mAPerLedEff / 765;
+        const uint16_t len = ablBuses[b].len;
+        if (limits[b]) expBri[b] = ablLimit(busMilliamps, limits[b] > len ? limits[b] - len : 0, newBri);
+        expCurrent += busMilliamps * expBri[b] / 255;
+        busLimited += expBri[b] < newBri;
+      }
+      expCurrent += 100 + pLen;
+      limited += newBri < strip.getBrightness();
+    } else {
+      for (uint8_t b = 0; b < ABL_BUSES; b++) expBri[b] = strip.getBrightness();
+    }
+    for (uint8_t b = 0; b < ABL_BUSES; b++) ok &= busBri[b] == expBri[b];
+    ok &= current == expCurrent;
+    if (!ok) {
+      fprintf(out, "frame %u: current %u expected %u\n", f, (unsigned)current, (unsigned)expCurrent);
+      for (uint8_t b = 0; b < ABL_BUSES; b++)
+        fprintf(out, "  bus %u: walk %u, bri %u expected %u\n", b, walks[b], busBri[b], expBri[b]);
+    }
+    failed += !ok;
+  }
+  fprintf(out, "frames: %u, ABL limited: %u, bus limit applied: %u, mismatches: %u\n", frames, limited, busLimited, failed);
+
+  strip.ablMilliampsMax = maxPwr;
+  strip.milliampsPerLed = mAPerLed;
+  correctWB = wb;
+  cctFromRgb = cctRgb;
+  strip.setBrightness(bri, true);
+  return failed;
+}
+#endif
@@ -137,3 +137,110 @@ float fmod_t(float num, float denom) {
   #endif
   return res;
 }
+
+/*
+ * Fixed point variants for per pixel math of 2D effects, integer only (ESP8266 and ESP32-C3 have no FPU).
+ * Angles are 16 bit, 65536 units per full circle (as FastLED's sin16()), results are Q15 (32767 = 1.0) or Q16.
+ * sin/cos, atan2 and exp interpolate linearly in a table of 129 entries (258 bytes PROGMEM each).
+ * Error bounds, measured over the whole input range against libm (wled_native -M, see wled_bench.cpp):
+ *  sin16_t/cos16_t   |error| <= 1.5 LSB (4.6e-5)
+ *  atan2_16_t        |error| <= 2 units (1.9e-4 rad)
+ *  sqrt32_t          exact (floor)
+ *  exp16_t           relative error <= 4e-5 (1 LSB for results below 0.4)
+ */
+
+// sin() of the first quadrant, 32767*sin(i*PI/256)
+static const uint16_t sinTable[129] PROGMEM = {
+  0, 402, 804, 1206, 1608, 2009, 2410, 2811, 3212, 3612, 4011, 4410, 4808, 5205, 5602, 5998,
+  6393, 6786, 7179, 7571, 7962, 8351, 8739, 9126, 9512, 9896, 10278, 10659, 11039, 11417, 11793, 12167,
+  12539, 12910, 13279, 13645, 14010, 14372, 14732, 15090, 15446, 15800, 16151, 16499, 16846, 17189, 17530, 17869,
+  18204, 18537, 18868, 19195, 19519, 19841, 20159, 20475, 20787, 21096, 21403, 21705, 22005, 22301, 22594, 22884,
+  23170, 23452, 23731, 24007, 24279, 24547, 24811, 25072, 25329, 25582, 25832, 26077, 26319, 26556, 26790, 27019,
+  27245, 27466, 27683, 27896, 28105, 28310, 28510, 28706, 28898, 29085, 29268, 29447, 29621, 29791, 29956, 30117,
+  30273, 30424, 30571, 30714, 30852, 30985, 31113, 31237, 31356, 31470, 31580, 31685, 31785, 31880, 31971, 32057,
+  32137, 32213, 32285, 32351, 32412, 32469, 32521, 32567, 32609, 32646, 32678, 32705, 32728, 32745, 32757, 32765,
+  32767
+};
+
+// atan(i/128) in 16 bit angle units
+static const uint16_t atanTable[129] PROGMEM = {
+  0, 81, 163, 244, 326, 407, 489, 570, 651, 732, 813, 894, 975, 1056, 1136, 1217,
+  1297, 1377, 1457, 1537, 1617, 1696, 1775, 1854, 1933, 2012, 2090, 2168, 2246, 2324, 2401, 2478,
+  2555, 2632, 2708, 2784, 2860, 2935, 3010, 3085, 3159, 3233, 3307, 3380, 3453, 3526, 3599, 3670,
+  3742, 3813, 3884, 3955, 4025, 4095, 4164, 4233, 4302, 4370, 4438, 4505, 4572, 4639, 4705, 4771,
+  4836, 4901, 4966, 5030, 5094, 5157, 5220, 5282, 5344, 5406, 5467, 5528, 5589, 5649, 5708, 5768,
+  5826, 5885, 5943, 6000, 6058, 6114, 6171, 6227, 6282, 6337, 6392, 6446, 6500, 6554, 6607, 6660,
+  6712, 6764, 6815, 6867, 6917, 6968, 7018, 7068, 7117, 7166, 7214, 7262, 7310, 7358, 7405, 7451,
+  7498, 7544, 7589, 7635, 7679, 7724, 7768, 7812, 7856, 7899, 7942, 7984, 8026, 8068, 8110, 8151,
+  8192
+};
+
+// fractional part of 2^(i/128) in Q16 (the last entry, 65536, is implied)
+static const uint16_t exp2Table[128] PROGMEM = {
+  0, 356, 714, 1073, 1435, 1799, 2164, 2532, 2902, 3273, 3647, 4022, 4400, 4780, 5162, 5546,
+  5932, 6320, 6710, 7102, 7496, 7893, 8292, 8693, 9096, 9501, 9908, 10318, 10730, 11144, 11560, 11979,
+  12400, 12823, 13249, 13676, 14106, 14539, 14974, 15411, 15850, 16292, 16737, 17183, 17633, 18084, 18538, 18995,
+  19454, 19915, 20379, 20846, 21315, 21786, 22260, 22737, 23216, 23698, 24183, 24670, 25160, 25652, 26148, 26645,
+  27146, 27649, 28155, 28664, 29175, 29690, 30207, 30727, 31249, 31775, 32303, 32834, 33369, 33906, 34446, 34988,
+  35534, 36083, 36635, 37190, 37747, 38308, 38872, 39439, 40009, 40582, 41158, 41738, 42320, 42906, 43495, 44087,
+  44682, 45280, 45882, 46487, 47095, 47707, 48322, 48940, 49562, 50187, 50815, 51447, 52082, 52721, 53363, 54008,
+  54658, 55310, 55966, 56626, 57289, 57956, 58627, 59301, 59979, 60661, 61346, 62035, 62727, 63424, 64124, 64828
+};
+
+// theta: 65536 per full circle, returns -32767..32767
+int16_t sin16_t(uint16_t theta) {
+  unsigned a = theta & 0x3FFF;
+  if (theta & 0x4000) a = 0x4000 - a;  // 2nd and 4th quadrant are mirrored
+  unsigned i = a >> 7, f = a & 0x7F;
+  int v = pgm_read_word(&sinTable[i]);
+  if (f) v += ((int(pgm_read_word(&sinTable[i+1])) - v) * int(f) + 64) >> 7;
+  return (theta & 0x8000) ? -v : v;
+}
+
+int16_t cos16_t(uint16_t theta) {
+  return sin16_t(theta + 0x4000);
+}
+
+// returns the angle in 16 bit units, -32768..32767 (-PI..PI), cast to uint16_t for 0..2*PI
+int16_t atan2_16_t(int32_t y, int32_t x) {
+  uint32_t ax = x < 0 ? -(uint32_t)x : x;
+  uint32_t ay = y < 0 ? -(uint32_t)y : y;
+  if (ax == 0 && ay == 0) return 0;
+  uint32_t lo = ax < ay ? ax : ay, hi = ax < ay ? ay : ax;
+  while (hi > 0xFFFF) { hi >>= 1; lo >>= 1; }
+  uint32_t r = (lo << 15) / hi;         // tan() of the angle within the octant in Q15
+  unsigned i = r >> 8, f = r & 0xFF;
+  int a = pgm_read_word(&atanTable[i]);
+  if (f) a += ((int(pgm_read_word(&atanTable[i+1])) - a) * int(f) + 128) >> 8;
+  if (ay > ax) a = 0x4000 - a;
+  if (x < 0)   a = 0x8000 - a;
+  return y < 0 ? -a : a;
+}
+
+// floor(sqrt(x)), bit by bit
+uint16_t sqrt32_t(uint32_t x) {
+  if (x == 0) return 0;
+  uint32_t res = 0, bit = 1UL << ((31 - __builtin_clz(x)) & ~1); // highest power of 4 <= x
+  while (bit) {
+    uint32_t t = res + bit, take = -(uint32_t)(x >= t); // no branch, the outcome is unpredictable
+    x   -= t & take;
+    res  = (res >> 1) + (bit & take);
+    bit >>= 2;
+  }
+  return res;
+}
+
+// e^x for x in Q16, result in Q16, saturates at 0xFFFFFFFF (x >= 11.09)
+uint32_t exp16_t(int32_t x) {
+  if (x >= 0xB1721) return 0xFFFFFFFF;  // ln(2^16)
+  if (x < -0xBC893) return 0;           // ln(2^-17), < 0.5 LSB
+  int32_t t = ((int64_t)x * 1549082005) >> 30; // x*log2(e) in Q16, 2^t = e^x
+  int k = t >> 16;                      // integer part (floor)
+  unsigned f = t & 0xFFFF, i = f >> 9, frac = f & 0x1FF;
+  uint32_t lo = pgm_read_word(&exp2Table[i]);
+  uint32_t hi = i < 127 ? pgm_read_word(&exp2Table[i+1]) : 0x10000;
+  uint32_t m = 0x10000 + lo + (((hi - lo) * frac + 256) >> 9); // 2^f in Q16
+  if (k >= 0) return m << k;            // k <= 15 and m < 2^17 (range checked above)
+  if (k < -17) return 0;
+  return (m + (1UL << (-k - 1))) >> -k;
+}
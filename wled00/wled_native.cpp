@@ -0,0 +1,175 @@
+#ifdef WLED_NATIVE
+#include "wled.h"
+
+/*
+ * Entry point of the host (native) simulator build: pio run -e native && .pio/build/native/program
+ *
+ * Runs the regular setup()/loop() of the firmware. Configuration and presets live in the directory
+ * given by WLED_FS_ROOT (see lib/wled_native). Busses of type TYPE_VIRTUAL (2) keep their frames in memory.
+ *
+ * Options:
+ *  -j <json>   apply a JSON state (same as POST /json/state) after boot, may be repeated
+ *  -t <ms>     run for the given time and exit (default: run forever)
+ *  -o <file>   append every new frame of the virtual busses to a file (RGB, 3 bytes per LED)
+ *  -s          print the resulting JSON state and info on exit, followed by a line with perf (/json/perf, histograms of the main segment)
+ *  -w <us>     simulated transmission time per LED of virtual busses (WS281x: 30, default 0)
+ *  -b csv|json run the effect benchmark (see wled_bench.cpp) after boot, print results to stdout and exit
+ *  -f <frames> frames rendered per effect in the benchmark (default 100)
+ *  -e <id>     benchmark a single effect only
+ *  -P          check that rendering on the render pool gives the same frames as serial rendering (see wled_bench.cpp),
+ *              exits with 1 on mismatches; -f and -e apply as well (default 50 frames)
+ *  -K          check the color kernels (colors.cpp) against the per channel reference and time them, exits with 1 on mismatches
+ *  -M          check the fixed point math (wled_math.cpp) against libm and time it, exits with 1 if an error bound is exceeded
+ *  -N          check the packets of network busses (DDP, Art-Net, E1.31) with a local UDP listener (see wled_bench.cpp), exits with 1 on mismatches
+ *  -R          check that E1.31/Art-Net universes are shown as whole frames (see wled_bench.cpp), exits with 1 on mismatches
+ *  -I          time realtime pixel ingest per protocol, old vs. bulk path (see wled_bench.cpp), -f sets the frames (default 500), exits with 1 on mismatches
+ *  -U          check that queued UDP realtime packets are drained and shown once per frame (see wled_bench.cpp), exits with 1 on mismatches
+ *  -L          check the ABL estimate against reading the pixels back from the buses (see wled_bench.cpp), -f sets the frames (default 400),
+ *              exits with 1 on mismatches
+ *  -S <n>      time strip.service() with n small segments (see wled_bench.cpp), -f sets the frames (default 2000)
+ *  -A <cycles> cycle through random effects with transitions and check effect data arena and heap (see wled_bench.cpp),
+ *              exits with 1 if memory leaked or data was outside the arena
+ */
+
+static bool applyJsonState(const char *json) {
+  if (!requestJSONBufferLock(254)) return false;
+  DeserializationError error = deserializeJson(doc, json);
+  JsonObject root = doc.as<JsonObject>();
+  if (!error && !root.isNull()) deserializeState(root, CALL_MODE_DIRECT_CHANGE);
+  releaseJSONBufferLock();
+  return !error;
+}
+
+static void printJsonState() {
+  if (!requestJSONBufferLock(254)) return;
+  JsonObject state = doc.createNestedObject("state");
+  serializeState(state);
+  JsonObject info  = doc.createNestedObject("info");
+  serializeInfo(info);
+  serializeJson(doc, Serial);
+  Serial.println();
+  doc.clear();
+  JsonObject perf  = doc.createNestedObject("perf");
+  serializePerf(perf, strip.getMainSegmentId());
+  serializeJson(doc, Serial);
+  Serial.println();
+  releaseJSONBufferLock();
+}
+
+// dump frames of all virtual busses that were shown since the last call
+static void dumpFrames(FILE *out) {
+  static uint32_t lastFrame[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES] = {0};
+  for (uint8_t i = 0; i < busses.getNumBusses(); i++) {
+    Bus *bus = busses.getBus(i);
+    if (bus == nullptr || bus->getType() != TYPE_VIRTUAL || !bus->isOk()) continue;
+    BusVirtual *vbus = static_cast<BusVirtual*>(bus);
+    if (vbus->getFrameCount() == lastFrame[i]) continue;
+    lastFrame[i] = vbus->getFrameCount();
+    const uint32_t *frame = vbus->getFrame();
+    for (uint16_t p = 0; p < vbus->getLength(); p++) {
+      uint8_t rgb[3] = {R(frame[p]), G(frame[p]), B(frame[p])};
+      fwrite(rgb, 1, 3, out);
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  const char *states[8];
+  uint8_t     numStates = 0;
+  long        runTime = -1;
+  FILE       *frameFile = nullptr;
+  bool        printState = false;
+  const char *bench = nullptr;
+  uint16_t    benchFrames = 0;
+  int         benchEffect = -1;
+  bool        poolCheck = false;
+  bool        kernelCheck = false;
+  bool        mathCheck = false;
+  bool        netCheck = false;
+  bool        syncCheck = false;
+  bool        ingestBench = false;
+  bool        udpCheck = false;
+  bool        ablCheck = false;
+  unsigned    arenaCycles = 0;
+  int         serviceSegments = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-j") && i+1 < argc && numStates < 8) states[numStates++] = argv[++i];
+    else if (!strcmp(argv[i], "-t") && i+1 < argc) runTime = atol(argv[++i]);
+    else if (!strcmp(argv[i], "-o") && i+1 < argc) frameFile = fopen(argv[++i], "wb");
+    else if (!strcmp(argv[i], "-s")) printState = true;
+    else if (!strcmp(argv[i], "-w") && i+1 < argc) BusVirtual::setWireTime(atoi(argv[++i]));
+    else if (!strcmp(argv[i], "-b") && i+1 < argc) bench = argv[++i];
+    else if (!strcmp(argv[i], "-f") && i+1 < argc) benchFrames = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "-e") && i+1 < argc) benchEffect = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "-P")) poolCheck = true;
+    else if (!strcmp(argv[i], "-K")) kernelCheck = true;
+    else if (!strcmp(argv[i], "-M")) mathCheck = true;
+    else if (!strcmp(argv[i], "-N")) netCheck = true;
+    else if (!strcmp(argv[i], "-R")) syncCheck = true;
+    else if (!strcmp(argv[i], "-I")) ingestBench = true;
+    else if (!strcmp(argv[i], "-U")) udpCheck = true;
+    else if (!strcmp(argv[i], "-L")) ablCheck = true;
+    else if (!strcmp(argv[i], "-A") && i+1 < argc) arenaCycles = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "-S") && i+1 < argc) serviceSegments = atoi(argv[++i]);
+    else {
+      fprintf(stderr, "usage: %s [-j <json state>]... [-t <ms>] [-o <frame file>] [-s] [-w <us>] [-b csv|json|-P [-f <frames>] [-e <id>]] [-K] [-M] [-N] [-R] [-I] [-U] [-L] [-A <cycles>] [-S <segments>]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  if (kernelCheck) return runColorKernelCheck(stdout) ? 1 : 0; // no need to boot
+  if (mathCheck)   return runMathCheck(stdout) ? 1 : 0;
+  if (netCheck)    return runNetworkOutputCheck(stdout) ? 1 : 0;
+
+  WLED::instance().setup();
+  for (uint8_t i = 0; i < numStates; i++) {
+    if (!applyJsonState(states[i])) fprintf(stderr, "invalid JSON state: %s\n", states[i]);
+  }
+
+  if (bench) {
+    fflush(stdout); // boot messages go to Serial (stdout) too
+    runEffectBenchmark(stdout, !strcmp(bench, "json"), benchFrames ? benchFrames : 100, benchEffect);
+    return 0;
+  }
+  if (serviceSegments > 0) {
+    fflush(stdout);
+    runServiceBenchmark(stdout, serviceSegments, benchFrames ? benchFrames : 2000);
+    return 0;
+  }
+  if (arenaCycles) {
+    fflush(stdout);
+    return runDataArenaCheck(stdout, arenaCycles) ? 1 : 0;
+  }
+  if (ablCheck) {
+    fflush(stdout);
+    return runABLCheck(stdout, benchFrames ? benchFrames : 400) ? 1 : 0;
+  }
+  if (udpCheck) {
+    fflush(stdout);
+    return runUDPReceiveCheck(stdout) ? 1 : 0;
+  }
+  if (ingestBench) {
+    fflush(stdout);
+    return runRealtimeIngestBenchmark(stdout, benchFrames ? benchFrames : 500) ? 1 : 0;
+  }
+  if (syncCheck) {
+    fflush(stdout);
+    return runFrameSyncCheck(stdout) ? 1 : 0;
+  }
+  if (poolCheck) {
+    fflush(stdout);
+    return runRenderPoolCheck(stdout, benchFrames ? benchFrames : 50, benchEffect) ? 1 : 0;
+  }
+
+  unsigned long start = millis();
+  while (runTime < 0 || millis() - start < (unsigned long)runTime) {
+    WLED::instance().loop();
+    if (frameFile) dumpFrames(frameFile);
+  }
+
+  if (frameFile) fclose(frameFile);
+  if (printState) printJsonState();
+  return 0;
+}
+#endif
@@ -357,6 +357,12 @@ void getSettingsJS(byte subPage, char* dest)
     sappend('v',SET_F("FR"),strip.getTargetFps());
     sappend('v',SET_F("AW"),Bus::getGlobalAWMode());
     sappend('c',SET_F("LD"),useGlobalLedBuffer);
+    sappend('v',SET_F("OU"),e131OutUniverse);
+    sappend('v',SET_F("OP"),e131OutPriority);
+    sappend('v',SET_F("OS"),e131OutSyncUniverse);
+    char cid[33];
+    getE131OutCID(cid);
+    sappends('s',SET_F("OC"),cid);
 
     for (uint8_t s=0; s < busses.getNumBusses(); s++) {
       Bus* bus = busses.getBus(s);
@@ -483,6 +489,7 @@ void getSettingsJS(byte subPage, char* dest)
     [[maybe_unused]] char nS[32];
     sappend('v',SET_F("UP"),udpPort);
     sappend('v',SET_F("U2"),udpPort2);
+    sappend('v',SET_F("UB"),udpRxBudgetUs);
     sappend('v',SET_F("GS"),syncGroups);
     sappend('v',SET_F("GR"),receiveGroups);
 
@@ -504,6 +511,8 @@ void getSettingsJS(byte subPage, char* dest)
     sappend('c',SET_F("MO"),useMainSegmentOnly);
     sappend('v',SET_F("EP"),e131Port);
     sappend('c',SET_F("ES"),e131SkipOutOfSequence);
+    sappend('c',SET_F("FS"),e131FrameSync);
+    sappend('v',SET_F("FT"),e131FrameTimeout);
     sappend('c',SET_F("EM"),e131Multicast);
     sappend('v',SET_F("EU"),e131Universe);
     sappend('v',SET_F("DA"),DMXAddress);